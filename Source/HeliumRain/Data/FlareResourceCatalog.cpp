@@ -8,25 +8,55 @@
 
 UFlareResourceCatalog::UFlareResourceCatalog(const class FObjectInitializer& PCIP)
 	: Super(PCIP)
+	, Food(NULL)
+	, Fuel(NULL)
+	, Tools(NULL)
+	, Tech(NULL)
 {
 }
 
 
+void UFlareResourceCatalog::PostLoad()
+{
+	Super::PostLoad();
+
+	// Resource data is indexed by catalog position in the simulation
+	ResourcesByIdentifier.Empty();
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	{
+		Resources[ResourceIndex]->Data.Index = ResourceIndex;
+		ResourcesByIdentifier.Add(Resources[ResourceIndex]->Data.Identifier, Resources[ResourceIndex]);
+	}
+
+	CustomerResourceFlags.Init(false, Resources.Num());
+	for (int32 ResourceIndex = 0; ResourceIndex < ConsumerResources.Num(); ResourceIndex++)
+	{
+		CustomerResourceFlags[ConsumerResources[ResourceIndex]->Data.Index] = true;
+	}
+
+	MaintenanceResourceFlags.Init(false, Resources.Num());
+	for (int32 ResourceIndex = 0; ResourceIndex < MaintenanceResources.Num(); ResourceIndex++)
+	{
+		MaintenanceResourceFlags[MaintenanceResources[ResourceIndex]->Data.Index] = true;
+	}
+
+	Food = Get("food");
+	Fuel = Get("fuel");
+	Tools = Get("tools");
+	Tech = Get("tech");
+}
+
+
 /*----------------------------------------------------
 	Data getters
 ----------------------------------------------------*/
 
 FFlareResourceDescription* UFlareResourceCatalog::Get(FName Identifier) const
 {
-	auto FindByName = [=](const UFlareResourceCatalogEntry* Candidate)
+	UFlareResourceCatalogEntry* Entry = ResourcesByIdentifier.FindRef(Identifier);
+	if (Entry)
 	{
-		return Candidate->Data.Identifier == Identifier;
-	};
-
-	UFlareResourceCatalogEntry* const* Entry = Resources.FindByPredicate(FindByName);
-	if (Entry && *Entry)
-	{
-		return &((*Entry)->Data);
+		return &Entry->Data;
 	}
 
 	return NULL;
@@ -34,36 +64,19 @@ FFlareResourceDescription* UFlareResourceCatalog::Get(FName Identifier) const
 
 bool UFlareResourceCatalog::IsCustomerResource(FFlareResourceDescription* Resource) const
 {
-	for (int32 ResourceIndex = 0; ResourceIndex < ConsumerResources.Num(); ResourceIndex++)
-	{
-		if(Resource == &ConsumerResources[ResourceIndex]->Data)
-		{
-			return true;
-		}
-	}
-	return false;
+	return CustomerResourceFlags[Resource->Index];
 }
 
 bool UFlareResourceCatalog::IsMaintenanceResource(FFlareResourceDescription* Resource) const
 {
-	for (int32 ResourceIndex = 0; ResourceIndex < MaintenanceResources.Num(); ResourceIndex++)
-	{
-		if(Resource == &MaintenanceResources[ResourceIndex]->Data)
-		{
-			return true;
-		}
-	}
-	return false;
+	return MaintenanceResourceFlags[Resource->Index];
 }
 
 UFlareResourceCatalogEntry* UFlareResourceCatalog::GetEntry(FFlareResourceDescription* Resource) const
 {
-	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ResourceIndex++)
+	if (Resource && Resources.IsValidIndex(Resource->Index) && &Resources[Resource->Index]->Data == Resource)
 	{
-		if(Resource == &Resources[ResourceIndex]->Data)
-		{
-			return Resources[ResourceIndex];
-		}
+		return Resources[Resource->Index];
 	}
 	return NULL;
 }
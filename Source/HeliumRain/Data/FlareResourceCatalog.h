@@ -33,6 +33,9 @@ public:
 		Public methods
 	----------------------------------------------------*/
 
+	/** Give each resource its catalog index, and build the lookup tables */
+	virtual void PostLoad() override;
+
 	/** Get a resource from identifier */
 	FFlareResourceDescription* Get(FName Identifier) const;
 
@@ -49,6 +52,44 @@ public:
 
 	bool IsMaintenanceResource(FFlareResourceDescription* Resource) const;
 
+	inline FFlareResourceDescription* GetFood() const
+	{
+		return Food;
+	}
+
+	inline FFlareResourceDescription* GetFuel() const
+	{
+		return Fuel;
+	}
+
+	inline FFlareResourceDescription* GetTools() const
+	{
+		return Tools;
+	}
+
+	inline FFlareResourceDescription* GetTech() const
+	{
+		return Tech;
+	}
+
+protected:
+
+	/*----------------------------------------------------
+		Lookup tables
+	----------------------------------------------------*/
+
+	TMap<FName, UFlareResourceCatalogEntry*> ResourcesByIdentifier;
+
+	/** Resource roles, by resource index */
+	TArray<bool>                             CustomerResourceFlags;
+	TArray<bool>                             MaintenanceResourceFlags;
+
+	/** Resources used by the people and station maintenance */
+	FFlareResourceDescription*               Food;
+	FFlareResourceDescription*               Fuel;
+	FFlareResourceDescription*               Tools;
+	FFlareResourceDescription*               Tech;
+
 };
 
 
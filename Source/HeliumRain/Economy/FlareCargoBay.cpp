@@ -1,6 +1,7 @@
 
 #include "../Flare.h"
 #include "../Game/FlareGame.h"
+#include "FlareFactory.h"
 #include "FlareCargoBay.h"
 
 
@@ -10,6 +11,7 @@
 
 UFlareCargoBay::UFlareCargoBay(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, StockSector(NULL)
 {
 }
 
@@ -21,6 +23,13 @@ void UFlareCargoBay::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, TArray<FF
 	CargoBayBaseCapacity = Parent->GetDescription()->CargoBayCapacity;
 	// Initialize cargo bay
 	CargoBay.Empty();
+	ResourceQuantities.Empty();
+	ResourceQuantities.SetNumZeroed(Game->GetResourceCatalog()->Resources.Num());
+	ResourceCapacities.Empty();
+	ResourceCapacities.SetNumZeroed(Game->GetResourceCatalog()->Resources.Num());
+	FreeSlotCapacity = 0;
+	UsedCargoSpace = 0;
+
 	for (uint32 CargoIndex = 0; CargoIndex < CargoBayCount; CargoIndex++)
 	{
 		FFlareCargo Cargo;
@@ -51,6 +60,7 @@ void UFlareCargoBay::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, TArray<FF
 		}
 
 		CargoBay.Add(Cargo);
+		AddSlotAggregates(Cargo);
 	}
 }
 
@@ -93,26 +103,7 @@ TArray<FFlareCargoSave>* UFlareCargoBay::Save()
 
 bool UFlareCargoBay::HasResources(FFlareResourceDescription* Resource, uint32 Quantity)
 {
-	uint32 PresentQuantity = 0;
-
-	if (Quantity == 0)
-	{
-		return true;
-	}
-
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		FFlareCargo* Cargo = &CargoBay[CargoIndex];
-		if (Cargo->Resource == Resource)
-		{
-			PresentQuantity += Cargo->Quantity;
-			if (PresentQuantity >= Quantity)
-			{
-				return true;
-			}
-		}
-	}
-	return false;
+	return Quantity == 0 || GetResourceQuantity(Resource) >= Quantity;
 }
 
 uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32 Quantity)
@@ -147,6 +138,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 		uint32 TakenQuantity = FMath::Min(MinQuantityCargo->Quantity, QuantityToTake);
 		if (TakenQuantity > 0)
 		{
+			RemoveSlotAggregates(*MinQuantityCargo);
 			MinQuantityCargo->Quantity -= TakenQuantity;
 			QuantityToTake -= TakenQuantity;
 
@@ -154,6 +146,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 			{
 				MinQuantityCargo->Resource = NULL;
 			}
+			AddSlotAggregates(*MinQuantityCargo);
 
 			if (QuantityToTake == 0)
 			{
@@ -171,6 +164,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 			uint32 TakenQuantity = FMath::Min(Cargo.Quantity, QuantityToTake);
 			if (TakenQuantity > 0)
 			{
+				RemoveSlotAggregates(Cargo);
 				Cargo.Quantity -= TakenQuantity;
 				QuantityToTake -= TakenQuantity;
 
@@ -178,6 +172,7 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 				{
 					Cargo.Resource = NULL;
 				}
+				AddSlotAggregates(Cargo);
 
 				if (QuantityToTake == 0)
 				{
@@ -191,11 +186,13 @@ uint32 UFlareCargoBay::TakeResources(FFlareResourceDescription* Resource, uint32
 
 void UFlareCargoBay::DumpCargo(FFlareCargo* Cargo)
 {
+	RemoveSlotAggregates(*Cargo);
 	Cargo->Quantity = 0;
 	if (Cargo->Lock == EFlareResourceLock::NoLock)
 	{
 		Cargo->Resource = NULL;
 	}
+	AddSlotAggregates(*Cargo);
 }
 
 uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32 Quantity)
@@ -218,7 +215,9 @@ uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32
 			uint32 GivenQuantity = FMath::Min(AvailableCapacity, QuantityToGive);
 			if (GivenQuantity > 0)
 			{
+				RemoveSlotAggregates(Cargo);
 				Cargo.Quantity += GivenQuantity;
+				AddSlotAggregates(Cargo);
 				QuantityToGive -= GivenQuantity;
 
 				if (QuantityToGive == 0)
@@ -239,8 +238,10 @@ uint32 UFlareCargoBay::GiveResources(FFlareResourceDescription* Resource, uint32
 			uint32 GivenQuantity = FMath::Min(Cargo.Capacity, QuantityToGive);
 			if (GivenQuantity > 0)
 			{
+				RemoveSlotAggregates(Cargo);
 				Cargo.Quantity += GivenQuantity;
 				Cargo.Resource = Resource;
+				AddSlotAggregates(Cargo);
 
 				QuantityToGive -= GivenQuantity;
 
@@ -277,14 +278,7 @@ uint32 UFlareCargoBay::GetCapacity() const
 
 uint32 UFlareCargoBay::GetUsedCargoSpace() const
 {
-	uint32 Used = 0;
-
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num(); CargoIndex++)
-	{
-		Used += CargoBay[CargoIndex].Quantity;
-	}
-
-	return Used;
+	return UsedCargoSpace;
 }
 
 uint32 UFlareCargoBay::GetFreeCargoSpace() const
@@ -294,38 +288,14 @@ uint32 UFlareCargoBay::GetFreeCargoSpace() const
 
 uint32 UFlareCargoBay::GetResourceQuantity(FFlareResourceDescription* Resource) const
 {
-	uint32 Quantity = 0;
+	FLARE_COUNT_CALL(GetResourceQuantity);
 
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Cargo.Resource == Resource)
-		{
-			Quantity += Cargo.Quantity;
-		}
-	}
-
-	return Quantity;
+	return ResourceQuantities[Resource->Index];
 }
 
 uint32 UFlareCargoBay::GetFreeSpaceForResource(FFlareResourceDescription* Resource) const
 {
-	uint32 Quantity = 0;
-
-	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
-	{
-		const FFlareCargo& Cargo = CargoBay[CargoIndex];
-		if (Cargo.Resource == NULL)
-		{
-			Quantity += Cargo.Capacity;
-		}
-		else if (Cargo.Resource == Resource)
-		{
-			Quantity += Cargo.Capacity - Cargo.Quantity;
-		}
-	}
-
-	return Quantity;
+	return FreeSlotCapacity + ResourceCapacities[Resource->Index] - ResourceQuantities[Resource->Index];
 }
 
 uint32 UFlareCargoBay::GetSlotCount() const
@@ -355,9 +325,13 @@ bool UFlareCargoBay::LockSlot(FFlareResourceDescription* Resource, EFlareResourc
 
 			if (Cargo.Resource == NULL)
 			{
+				RemoveSlotAggregates(Cargo);
 				Cargo.Resource = Resource;
 				Cargo.Quantity = 0;
+				AddSlotAggregates(Cargo);
 			}
+
+			InvalidateTradeCandidates();
 			return true;
 		}
 	}
@@ -365,8 +339,28 @@ bool UFlareCargoBay::LockSlot(FFlareResourceDescription* Resource, EFlareResourc
 	return false;
 }
 
+void UFlareCargoBay::SetSlots(const TArray<FFlareCargo>& Slots)
+{
+	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	{
+		RemoveSlotAggregates(CargoBay[CargoIndex]);
+	}
+
+	CargoBay = Slots;
+
+	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	{
+		AddSlotAggregates(CargoBay[CargoIndex]);
+	}
+
+	// Locks may have changed
+	InvalidateTradeCandidates();
+}
+
 void UFlareCargoBay::UnlockAll(bool IgnoreManualLock)
 {
+	bool Unlocked = false;
+
 	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
 	{
 		FFlareCargo& Cargo = CargoBay[CargoIndex];
@@ -380,13 +374,21 @@ void UFlareCargoBay::UnlockAll(bool IgnoreManualLock)
 
 			Cargo.Lock = EFlareResourceLock::NoLock;
 			Cargo.ManualLock = false;
+			Unlocked = true;
 
 			if (Cargo.Quantity == 0)
 			{
+				RemoveSlotAggregates(Cargo);
 				Cargo.Resource = NULL;
+				AddSlotAggregates(Cargo);
 			}
 		}
 	}
+
+	if (Unlocked)
+	{
+		InvalidateTradeCandidates();
+	}
 }
 
 bool UFlareCargoBay::WantSell(FFlareResourceDescription* Resource) const
@@ -427,3 +429,110 @@ bool UFlareCargoBay::WantBuy(FFlareResourceDescription* Resource) const
 	}
 	return false;
 }
+
+
+/*----------------------------------------------------
+	Aggregates
+----------------------------------------------------*/
+
+void UFlareCargoBay::RemoveSlotAggregates(const FFlareCargo& Cargo)
+{
+	if (StockSector)
+	{
+		StockSector->UpdateCargoStock(Parent, Cargo, -1);
+	}
+
+	if (WaitingFactories.Num())
+	{
+		WakeWaitingFactories(Cargo.Resource);
+	}
+
+	UsedCargoSpace -= Cargo.Quantity;
+
+	if (Cargo.Resource == NULL)
+	{
+		FreeSlotCapacity -= Cargo.Capacity;
+	}
+	else
+	{
+		ResourceQuantities[Cargo.Resource->Index] -= Cargo.Quantity;
+		ResourceCapacities[Cargo.Resource->Index] -= Cargo.Capacity;
+	}
+}
+
+void UFlareCargoBay::AddSlotAggregates(const FFlareCargo& Cargo)
+{
+	if (StockSector)
+	{
+		StockSector->UpdateCargoStock(Parent, Cargo, 1);
+	}
+
+	if (WaitingFactories.Num())
+	{
+		WakeWaitingFactories(Cargo.Resource);
+	}
+
+	UsedCargoSpace += Cargo.Quantity;
+
+	if (Cargo.Resource == NULL)
+	{
+		FreeSlotCapacity += Cargo.Capacity;
+	}
+	else
+	{
+		ResourceQuantities[Cargo.Resource->Index] += Cargo.Quantity;
+		ResourceCapacities[Cargo.Resource->Index] += Cargo.Capacity;
+	}
+}
+
+void UFlareCargoBay::InvalidateTradeCandidates()
+{
+	// Locks decide what a station buys and sells
+	if (StockSector && Parent->IsStation())
+	{
+		StockSector->InvalidateStationTradeCandidates(Parent);
+	}
+}
+
+void UFlareCargoBay::WakeWaitingFactories(FFlareResourceDescription* Resource)
+{
+	// Woken factories remove themselves from the list
+	for (int FactoryIndex = WaitingFactories.Num() - 1; FactoryIndex >= 0; FactoryIndex--)
+	{
+		WaitingFactories[FactoryIndex]->WakeUp(Resource);
+	}
+}
+
+bool UFlareCargoBay::CheckAggregates() const
+{
+	TArray<uint32> Quantities;
+	TArray<uint32> Capacities;
+	Quantities.SetNumZeroed(ResourceQuantities.Num());
+	Capacities.SetNumZeroed(ResourceCapacities.Num());
+	uint32 FreeCapacity = 0;
+	uint32 Used = 0;
+
+	for (int CargoIndex = 0; CargoIndex < CargoBay.Num() ; CargoIndex++)
+	{
+		const FFlareCargo& Cargo = CargoBay[CargoIndex];
+		Used += Cargo.Quantity;
+
+		if (Cargo.Resource == NULL)
+		{
+			FreeCapacity += Cargo.Capacity;
+		}
+		else
+		{
+			Quantities[Cargo.Resource->Index] += Cargo.Quantity;
+			Capacities[Cargo.Resource->Index] += Cargo.Capacity;
+		}
+	}
+
+	if (Quantities != ResourceQuantities || Capacities != ResourceCapacities || FreeCapacity != FreeSlotCapacity || Used != UsedCargoSpace)
+	{
+		FLOGV("WARNING : cargo bay totals of %s don't match its slots", *Parent->GetImmatriculation().ToString());
+		return false;
+	}
+
+	return true;
+}
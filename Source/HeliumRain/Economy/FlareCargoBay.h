@@ -5,6 +5,8 @@
 
 struct FFlareCargo;
 struct FFlareResourceDescription;
+class UFlareSimulatedSector;
+class UFlareFactory;
 
 
 UCLASS()
@@ -39,10 +41,45 @@ public:
 
 	void UnlockAll(bool IgnoreManualLock = true);
 
+	/** Replace all slots by a copy of slots of this cargo bay, keeping the resource totals */
+	void SetSlots(const TArray<FFlareCargo>& Slots);
+
 	bool LockSlot(FFlareResourceDescription* Resource, EFlareResourceLock::Type LockType, bool ManualLock);
 
+	/** Check the resource totals against the slots */
+	bool CheckAggregates() const;
+
+	/** Set the sector counting this cargo in its company stocks */
+	void SetStockSector(UFlareSimulatedSector* Sector)
+	{
+		StockSector = Sector;
+	}
+
+	/** Wake up a sleeping factory on the next change of this cargo bay */
+	void AddWaitingFactory(UFlareFactory* Factory)
+	{
+		WaitingFactories.Add(Factory);
+	}
+
+	void RemoveWaitingFactory(UFlareFactory* Factory)
+	{
+		WaitingFactories.Remove(Factory);
+	}
+
 protected:
 
+	/** Scan the station again for the trade candidates of the stock sector after a lock change */
+	void InvalidateTradeCandidates();
+
+	/** Wake up the factories waiting for a change of this resource */
+	void WakeWaitingFactories(FFlareResourceDescription* Resource);
+
+	/** Remove a slot from the resource totals, before it is modified */
+	void RemoveSlotAggregates(const FFlareCargo& Cargo);
+
+	/** Add a slot to the resource totals, after it was modified */
+	void AddSlotAggregates(const FFlareCargo& Cargo);
+
 	/*----------------------------------------------------
 	   Protected data
 	----------------------------------------------------*/
@@ -58,6 +95,18 @@ protected:
 	uint32								       CargoBayBaseCapacity;
 	AFlareGame*                                Game;
 
+	// Slot totals, by resource index
+	TArray<uint32>                             ResourceQuantities;
+	TArray<uint32>                             ResourceCapacities;
+	uint32                                     FreeSlotCapacity;
+	uint32                                     UsedCargoSpace;
+
+	/** Sector counting this cargo in its company stocks */
+	UFlareSimulatedSector*                     StockSector;
+
+	/** Factories sleeping until this cargo bay changes */
+	TArray<UFlareFactory*>                     WaitingFactories;
+
 
 public:
 
@@ -91,6 +140,11 @@ public:
 		return Parent;
 	}
 
+	inline UFlareSimulatedSector* GetStockSector() const
+	{
+		return StockSector;
+	}
+
 	bool WantSell(FFlareResourceDescription* Resource) const;
 
 	bool WantBuy(FFlareResourceDescription* Resource) const;
@@ -29,6 +29,9 @@ void UFlareFactory::Load(UFlareSimulatedSpacecraft* ParentSpacecraft, const FFla
 	FactoryDescription = Description;
 	Parent = ParentSpacecraft;
 	CycleCostCacheLevel = -1;
+	Sleeping = false;
+	WaitCargoBay = NULL;
+	WaitResource = NULL;
 }
 
 
@@ -39,9 +42,17 @@ FFlareFactorySave* UFlareFactory::Save()
 
 void UFlareFactory::Simulate()
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlareFactory_Simulate);
+
+	if (Sleeping)
+	{
+		return;
+	}
 
 	if (!FactoryData.Active)
 	{
+		// Wait for a start order
+		Sleep(NULL, NULL);
 		goto post_prod;
 	}
 
@@ -50,6 +61,7 @@ void UFlareFactory::Simulate()
 	if (!IsNeedProduction())
 	{
 		// Don't produce if not needed
+		Sleep(NULL, NULL);
 		goto post_prod;
 	}
 
@@ -72,6 +84,7 @@ void UFlareFactory::Simulate()
 		{
 			// TODO display warning to user
 			// No free space wait.
+			Sleep(Parent->GetCargoBay(), NULL);
 			goto post_prod;
 		}
 
@@ -80,6 +93,20 @@ void UFlareFactory::Simulate()
 	}
 	TryBeginProduction();
 
+	// Wait for the first missing input, money is still checked every day
+	if (IsNeedProduction() && !HasCostReserved())
+	{
+		for (int32 ResourceIndex = 0 ; ResourceIndex < GetCycleData().InputResources.Num() ; ResourceIndex++)
+		{
+			const FFlareFactoryResource* Resource = &GetCycleData().InputResources[ResourceIndex];
+			if (!Parent->GetCargoBay()->HasResources(&Resource->Resource->Data, Resource->Quantity))
+			{
+				Sleep(Parent->GetCargoBay(), &Resource->Resource->Data);
+				break;
+			}
+		}
+	}
+
 post_prod:
 
 	if (FactoryDescription->VisibleStates)
@@ -88,6 +115,204 @@ post_prod:
 	}
 }
 
+void UFlareFactory::AdvanceDays(int64 Days)
+{
+	bool Skipped = false;
+
+	while (Days > 0)
+	{
+		// Nothing changes until woken up
+		if (Sleeping)
+		{
+			break;
+		}
+
+		// Whole cycles that no constraint can stop are applied at once
+		int64 MaxCycles = GetSteadyCycleLimit();
+		if (MaxCycles > 0)
+		{
+			int64 SpanDays = 0;
+			int64 Cycles = ComputeSteadyCycles(Days, GetCycleData().ProductionTime, FactoryData.ProductedDuration, MaxCycles, SpanDays);
+			if (Cycles > 0)
+			{
+				DoSteadyProduction(Cycles);
+				Days -= SpanDays;
+				Skipped = true;
+				continue;
+			}
+		}
+
+		// Days of a running cycle only count the production duration
+		if (FactoryData.Active && IsNeedProduction() && HasCostReserved())
+		{
+			int64 SteadyDays = FMath::Min(Days, GetCycleData().ProductionTime - FactoryData.ProductedDuration - 1);
+			if (SteadyDays > 0)
+			{
+				FactoryData.ProductedDuration += SteadyDays;
+				Days -= SteadyDays;
+				Skipped = true;
+				continue;
+			}
+		}
+
+		// Cycle ends where a constraint may bind check it day by day
+		Simulate();
+		Days--;
+		Skipped = false;
+	}
+
+	if (Skipped && FactoryDescription->VisibleStates)
+	{
+		UpdateDynamicState();
+	}
+}
+
+int64 UFlareFactory::ComputeSteadyCycles(int64 Days, int64 ProductionTime, int64 ProductedDuration, int64 MaxCycles, int64& SpanDays)
+{
+	// The first cycle ends when its duration is reached, the next ones every production time, at least one day apart
+	int64 FirstEndDay = FMath::Max(ProductionTime - ProductedDuration, (int64) 1);
+	int64 CycleDays = FMath::Max(ProductionTime, (int64) 1);
+
+	SpanDays = 0;
+	if (MaxCycles <= 0 || Days < FirstEndDay)
+	{
+		return 0;
+	}
+
+	int64 Cycles = FMath::Min(MaxCycles, 1 + (Days - FirstEndDay) / CycleDays);
+	SpanDays = FirstEndDay + (Cycles - 1) * CycleDays;
+	return Cycles;
+}
+
+int64 UFlareFactory::GetSteadyCycleLimit()
+{
+	// Only plain resource factories with a running cycle, without limits or actions
+	if (!FactoryData.Active || !IsNeedProduction() || IsShipyard() || FactoryDescription->OutputActions.Num() > 0
+		|| FactoryData.OutputCargoLimit.Num() > 0 || !HasCostReserved() || FactoryData.CostReserved != GetProductionCost())
+	{
+		return 0;
+	}
+
+	// Each cycle must restart, so the last planned cycle is left to the daily step
+	int64 MaxCycles = HasInfiniteCycle() ? MAX_int64 : (int64) FactoryData.CycleCount - 1;
+
+	// Wages are paid in one uint32 payment, without dept repayment rounding
+	UFlarePeople* People = Parent->GetCurrentSector()->GetPeople();
+	if (People->GetDept() > 0)
+	{
+		return 0;
+	}
+	if (GetProductionCost() > 0)
+	{
+		MaxCycles = FMath::Min(MaxCycles, (int64) (MAX_uint32 / GetProductionCost()));
+	}
+
+	const FFlareProductionData& CycleData = GetCycleData();
+	UFlareCargoBay* CargoBay = Parent->GetCargoBay();
+
+	// Reserved resources must be left as a restart leaves them
+	if (FactoryData.ResourceReserved.Num() != CycleData.InputResources.Num())
+	{
+		return 0;
+	}
+
+	for (int32 ResourceIndex = 0 ; ResourceIndex < CycleData.InputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &CycleData.InputResources[ResourceIndex];
+		const FFlareCargoSave& Reserved = FactoryData.ResourceReserved[ResourceIndex];
+		if (Resource->Quantity == 0 || Reserved.ResourceIdentifier != Resource->Resource->Data.Identifier || Reserved.Quantity != Resource->Quantity)
+		{
+			return 0;
+		}
+
+		// Inputs taken from a single slot give the same slot whatever the number of takes
+		FFlareCargo* InputSlot = NULL;
+		for (uint32 CargoIndex = 0 ; CargoIndex < CargoBay->GetSlotCount() ; CargoIndex++)
+		{
+			if (CargoBay->GetSlot(CargoIndex)->Resource == &Resource->Resource->Data)
+			{
+				if (InputSlot)
+				{
+					return 0;
+				}
+				InputSlot = CargoBay->GetSlot(CargoIndex);
+			}
+		}
+
+		if (!InputSlot)
+		{
+			return 0;
+		}
+		MaxCycles = FMath::Min(MaxCycles, (int64) (InputSlot->Quantity / Resource->Quantity));
+	}
+
+	for (int32 ResourceIndex = 0 ; ResourceIndex < CycleData.OutputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &CycleData.OutputResources[ResourceIndex];
+		if (Resource->Quantity == 0 || HasInputResource(&Resource->Resource->Data))
+		{
+			return 0;
+		}
+
+		// Outputs must fit in their own slots, a new slot could take a slot freed by an input
+		int64 FreeSpace = 0;
+		for (uint32 CargoIndex = 0 ; CargoIndex < CargoBay->GetSlotCount() ; CargoIndex++)
+		{
+			FFlareCargo* Cargo = CargoBay->GetSlot(CargoIndex);
+			if (Cargo->Resource == &Resource->Resource->Data)
+			{
+				FreeSpace += Cargo->Capacity - Cargo->Quantity;
+			}
+		}
+		MaxCycles = FMath::Min(MaxCycles, FreeSpace / Resource->Quantity);
+	}
+
+	return FMath::Max(MaxCycles, (int64) 0);
+}
+
+void UFlareFactory::DoSteadyProduction(int64 Cycles)
+{
+	const FFlareProductionData& CycleData = GetCycleData();
+	UFlareSimulatedSector* Sector = Parent->GetCurrentSector();
+	UFlareCargoBay* CargoBay = Parent->GetCargoBay();
+	uint32 Cost = (uint32) (GetProductionCost() * Cycles);
+
+	// Wages of every ended cycle
+	Sector->GetPeople()->Pay(Cost);
+	Sector->RecordMoneyTransfer(this, Sector->GetPeople(), Cost, EFlareMoneyReason::Wages);
+
+	// Outputs and inputs never share a slot, so their order doesn't matter
+	for (int32 ResourceIndex = 0 ; ResourceIndex < CycleData.OutputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &CycleData.OutputResources[ResourceIndex];
+		CargoBay->GiveResources(&Resource->Resource->Data, (uint32) (Resource->Quantity * Cycles));
+	}
+
+	for (int32 ResourceIndex = 0 ; ResourceIndex < CycleData.InputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &CycleData.InputResources[ResourceIndex];
+		CargoBay->TakeResources(&Resource->Resource->Data, (uint32) (Resource->Quantity * Cycles));
+	}
+
+	// Cost of every restarted cycle, the reservations are left as they were
+	FFlareSectorSimulationBuffer* SimulationBuffer = Sector->GetSimulationBuffer();
+	if (SimulationBuffer)
+	{
+		SimulationBuffer->TakeMoney(Parent->GetCompany(), Cost);
+	}
+	else
+	{
+		Parent->GetCompany()->TakeMoney(Cost, true);
+	}
+	Sector->RecordMoneyTransfer(Parent->GetCompany(), this, Cost, EFlareMoneyReason::Production);
+
+	FactoryData.ProductedDuration = 0;
+	if (!HasInfiniteCycle())
+	{
+		FactoryData.CycleCount -= Cycles;
+	}
+}
+
 void UFlareFactory::TryBeginProduction()
 {
 	if (GetMarginRatio() < 0.f)
@@ -116,6 +341,8 @@ void UFlareFactory::UpdateDynamicState()
 
 void UFlareFactory::Start()
 {
+	WakeUp();
+
 	FactoryData.Active = true;
 
 	// Stop other factories
@@ -143,6 +370,7 @@ void UFlareFactory::Start()
 		FactoryData.ProductedDuration = 0;
 
 		Parent->GetCompany()->GiveMoney(FactoryData.OrderShipAdvancePayment);
+		Parent->GetCurrentSector()->RecordMoneyTransfer(this, Parent->GetCompany(), FactoryData.OrderShipAdvancePayment, EFlareMoneyReason::ShipOrder);
 
 		FactoryData.OrderShipCompany = NAME_None;
 		FactoryData.OrderShipClass = NAME_None;
@@ -152,27 +380,33 @@ void UFlareFactory::Start()
 
 void UFlareFactory::Pause()
 {
+	WakeUp();
 	FactoryData.Active = false;
 }
 
 void UFlareFactory::Stop()
 {
+	WakeUp();
 	FactoryData.Active = false;
 	CancelProduction();
 }
 
 void UFlareFactory::SetInfiniteCycle(bool Mode)
 {
+	WakeUp();
 	FactoryData.InfiniteCycle = Mode;
 }
 
 void UFlareFactory::SetCycleCount(uint32 Count)
 {
+	WakeUp();
 	FactoryData.CycleCount = Count;
 }
 
 void UFlareFactory::SetOutputLimit(FFlareResourceDescription* Resource, uint32 MaxSlot)
 {
+	WakeUp();
+
 	bool ExistingResource = false;
 	for (int32 CargoLimitIndex = 0 ; CargoLimitIndex < FactoryData.OutputCargoLimit.Num() ; CargoLimitIndex++)
 	{
@@ -195,6 +429,8 @@ void UFlareFactory::SetOutputLimit(FFlareResourceDescription* Resource, uint32 M
 
 void UFlareFactory::ClearOutputLimit(FFlareResourceDescription* Resource)
 {
+	WakeUp();
+
 	for (int32 CargoLimitIndex = 0 ; CargoLimitIndex < FactoryData.OutputCargoLimit.Num() ; CargoLimitIndex++)
 	{
 		if (FactoryData.OutputCargoLimit[CargoLimitIndex].ResourceIdentifier == Resource->Identifier)
@@ -207,6 +443,8 @@ void UFlareFactory::ClearOutputLimit(FFlareResourceDescription* Resource)
 
 void UFlareFactory::OrderShip(UFlareCompany* OrderCompany, FName ShipIdentifier)
 {
+	WakeUp();
+
 	if (FactoryData.OrderShipCompany != NAME_None)
 	{
 		CancelOrder();
@@ -222,6 +460,7 @@ void UFlareFactory::OrderShip(UFlareCompany* OrderCompany, FName ShipIdentifier)
 			// Not enough money
 			return;
 		}
+		Parent->GetCurrentSector()->RecordMoneyTransfer(OrderCompany, this, ShipPrice, EFlareMoneyReason::ShipOrder);
 	}
 
 	FactoryData.OrderShipClass = ShipIdentifier;
@@ -231,10 +470,13 @@ void UFlareFactory::OrderShip(UFlareCompany* OrderCompany, FName ShipIdentifier)
 
 void UFlareFactory::CancelOrder()
 {
+	WakeUp();
+
 	if(FactoryData.OrderShipCompany != NAME_None)
 	{
 		UFlareCompany* Company = GetGame()->GetGameWorld()->FindCompany(FactoryData.OrderShipCompany);
 		Company->GiveMoney(FactoryData.OrderShipAdvancePayment);
+		Parent->GetCurrentSector()->RecordMoneyTransfer(this, Company, FactoryData.OrderShipAdvancePayment, EFlareMoneyReason::ShipOrder);
 	}
 
 	FactoryData.OrderShipClass = NAME_None;
@@ -358,10 +600,18 @@ bool UFlareFactory::HasOutputFreeSpace()
 
 void UFlareFactory::BeginProduction()
 {
-	if(!Parent->GetCompany()->TakeMoney(GetProductionCost(), !IsShipyard()))
+	FFlareSectorSimulationBuffer* SimulationBuffer = Parent->GetCurrentSector()->GetSimulationBuffer();
+
+	if (SimulationBuffer && !IsShipyard())
+	{
+		// Depts are allowed so this can't fail : defer it to the world commit step
+		SimulationBuffer->TakeMoney(Parent->GetCompany(), GetProductionCost());
+	}
+	else if(!Parent->GetCompany()->TakeMoney(GetProductionCost(), !IsShipyard()))
 	{
 		return;
 	}
+	Parent->GetCurrentSector()->RecordMoneyTransfer(Parent->GetCompany(), this, GetProductionCost(), EFlareMoneyReason::Production);
 
 
 	// Consume input resources
@@ -417,6 +667,7 @@ void UFlareFactory::BeginProduction()
 void UFlareFactory::CancelProduction()
 {
 	Parent->GetCompany()->GiveMoney(FactoryData.CostReserved);
+	Parent->GetCurrentSector()->RecordMoneyTransfer(this, Parent->GetCompany(), FactoryData.CostReserved, EFlareMoneyReason::Production);
 	FactoryData.CostReserved = 0;
 
 	// Restore reserved resources
@@ -447,6 +698,7 @@ void UFlareFactory::DoProduction()
 	uint32 PaidCost = FMath::Min(GetProductionCost(), FactoryData.CostReserved);
 	FactoryData.CostReserved -= PaidCost;
 	Parent->GetCurrentSector()->GetPeople()->Pay(PaidCost);
+	Parent->GetCurrentSector()->RecordMoneyTransfer(this, Parent->GetCurrentSector()->GetPeople(), PaidCost, EFlareMoneyReason::Wages);
 
 	for (int32 ResourceIndex = 0 ; ResourceIndex < GetCycleData().InputResources.Num() ; ResourceIndex++)
 	{
@@ -505,6 +757,43 @@ void UFlareFactory::DoProduction()
 	}
 }
 
+void UFlareFactory::WakeUp()
+{
+	if (!Sleeping)
+	{
+		return;
+	}
+
+	if (WaitCargoBay)
+	{
+		WaitCargoBay->RemoveWaitingFactory(this);
+	}
+
+	Sleeping = false;
+	WaitCargoBay = NULL;
+	WaitResource = NULL;
+}
+
+void UFlareFactory::WakeUp(FFlareResourceDescription* Resource)
+{
+	if (WaitResource == NULL || Resource == NULL || WaitResource == Resource)
+	{
+		WakeUp();
+	}
+}
+
+void UFlareFactory::Sleep(UFlareCargoBay* CargoBay, FFlareResourceDescription* Resource)
+{
+	Sleeping = true;
+	WaitCargoBay = CargoBay;
+	WaitResource = Resource;
+
+	if (WaitCargoBay)
+	{
+		WaitCargoBay->AddWaitingFactory(this);
+	}
+}
+
 FFlareWorldEvent *UFlareFactory::GenerateEvent()
 {
 	if (!FactoryData.Active || !IsNeedProduction())
@@ -646,7 +935,7 @@ uint32 UFlareFactory::GetProductionCost(const FFlareProductionData* Data)
 	const FFlareProductionData* CycleData = Data ? Data : &GetCycleData();
 	check(CycleData);
 
-	ScaledProductionCost = CycleData->ProductionCost;
+	uint32 ScaledProductionCost = CycleData->ProductionCost;
 
 	if (FactoryDescription->NeedSun)
 	{
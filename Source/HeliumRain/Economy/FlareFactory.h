@@ -6,6 +6,7 @@
 #include "FlareFactory.generated.h"
 
 class UFlareSimulatedSpacecraft;
+class UFlareCargoBay;
 
 
 
@@ -31,6 +32,12 @@ public:
 
 	void Simulate();
 
+	/** Same as Days calls to Simulate, with the days of a running cycle and the unconstrained cycles applied at once */
+	void AdvanceDays(int64 Days);
+
+	/** Number of cycles, at most MaxCycles, ending within Days for a running cycle, and the days they take */
+	static int64 ComputeSteadyCycles(int64 Days, int64 ProductionTime, int64 ProductedDuration, int64 MaxCycles, int64& SpanDays);
+
 	void TryBeginProduction();
 
 	void UpdateDynamicState();
@@ -73,9 +80,24 @@ public:
 
 	void PerformCreateShipAction(const FFlareFactoryAction* Action);
 
+	/** Simulate the factory again from the next day, after its station or its settings changed */
+	void WakeUp();
+
+	/** Wake up if waiting for this resource, or for any change if the resource is NULL */
+	void WakeUp(FFlareResourceDescription* Resource);
+
 
 protected:
 
+	/** Stop simulating until woken up, by a change of this resource in the cargo bay if set */
+	void Sleep(UFlareCargoBay* CargoBay, FFlareResourceDescription* Resource);
+
+	/** Number of cycles that can end and restart without hitting an input, storage, money or cycle count limit */
+	int64 GetSteadyCycleLimit();
+
+	/** Apply the money and resource effects of these ended and restarted cycles */
+	void DoSteadyProduction(int64 Cycles);
+
 	/*----------------------------------------------------
 	   Protected data
 	----------------------------------------------------*/
@@ -87,10 +109,14 @@ protected:
 	const FFlareFactoryDescription*          FactoryDescription;
 	UFlareSimulatedSpacecraft*				 Parent;
 	FFlareWorldEvent                         NextEvent;
-	uint32                                   ScaledProductionCost;
 	FFlareProductionData CycleCostCache;
 	int32 CycleCostCacheLevel;
 
+	// Wake-up queue
+	bool                                     Sleeping;
+	UFlareCargoBay*                          WaitCargoBay;
+	FFlareResourceDescription*               WaitResource;
+
 public:
 
 	/*----------------------------------------------------
@@ -171,6 +197,12 @@ public:
 		return FactoryData.Active;
 	}
 
+	/** Is the factory idle or blocked, waiting to be woken up */
+	inline bool IsSleeping() const
+	{
+		return Sleeping;
+	}
+
 	inline bool IsPaused()
 	{
 		return !FactoryData.Active && FactoryData.ProductedDuration > 0;
@@ -0,0 +1,186 @@
+
+#include "../Flare.h"
+
+#include "FlareMoneyLedger.h"
+#include "FlareFactory.h"
+#include "FlarePeople.h"
+#include "../Game/FlareCompany.h"
+#include "../Game/FlareWorld.h"
+#include "../Game/FlareSimulatedSector.h"
+#include "../Spacecrafts/FlareSimulatedSpacecraft.h"
+
+
+/*----------------------------------------------------
+	Accounts
+----------------------------------------------------*/
+
+FFlareMoneyAccountId FFlareMoneyAccountId::Get(UObject* Holder)
+{
+	FFlareMoneyAccountId Id;
+
+	if (Holder == NULL)
+	{
+		Id.Type = EFlareMoneyAccount::Outside;
+	}
+	else if (Holder->IsA(UFlareCompany::StaticClass()))
+	{
+		Id.Type = EFlareMoneyAccount::Company;
+		Id.Identifier = Cast<UFlareCompany>(Holder)->GetIdentifier();
+	}
+	else if (Holder->IsA(UFlareFactory::StaticClass()))
+	{
+		// Factory money is counted with its owner
+		Id.Type = EFlareMoneyAccount::Company;
+		Id.Identifier = Cast<UFlareFactory>(Holder)->GetParent()->GetCompany()->GetIdentifier();
+	}
+	else if (Holder->IsA(UFlarePeople::StaticClass()))
+	{
+		Id.Type = EFlareMoneyAccount::People;
+		Id.Identifier = Cast<UFlarePeople>(Holder)->GetParent()->GetIdentifier();
+	}
+	else
+	{
+		check(Holder->IsA(UFlareWorld::StaticClass()));
+		Id.Type = EFlareMoneyAccount::World;
+	}
+
+	return Id;
+}
+
+
+/*----------------------------------------------------
+	Ledger
+----------------------------------------------------*/
+
+FFlareMoneyLedger::FFlareMoneyLedger()
+	: WorldMoney(0)
+{
+	FMemory::Memzero(ReasonTotals, sizeof(ReasonTotals));
+	FMemory::Memzero(ReasonDayTotals, sizeof(ReasonDayTotals));
+}
+
+void FFlareMoneyLedger::InitWorldMoney(int64 Money)
+{
+	WorldMoney = Money;
+}
+
+/** Accounts that Transfer can move money from and to */
+static bool IsTransferHolder(UObject* Holder)
+{
+	return Holder == NULL || Holder->IsA(UFlareCompany::StaticClass()) || Holder->IsA(UFlarePeople::StaticClass());
+}
+
+bool FFlareMoneyLedger::Transfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason, bool AllowDepts)
+{
+	if (!IsTransferHolder(Source) || !IsTransferHolder(Destination))
+	{
+		FLOG("FFlareMoneyLedger::Transfer : only companies and people hold money, use RecordTransfer");
+		return false;
+	}
+
+	if (Amount < 0)
+	{
+		Swap(Source, Destination);
+		Amount = -Amount;
+	}
+
+	// Debit
+	UFlareCompany* SourceCompany = Cast<UFlareCompany>(Source);
+	UFlarePeople* SourcePeople = Cast<UFlarePeople>(Source);
+	if (SourceCompany)
+	{
+		if (!SourceCompany->TakeMoney(Amount, AllowDepts))
+		{
+			return false;
+		}
+	}
+	else if (SourcePeople)
+	{
+		SourcePeople->TakeMoney((uint32) Amount);
+	}
+
+	// Credit
+	UFlareCompany* DestinationCompany = Cast<UFlareCompany>(Destination);
+	UFlarePeople* DestinationPeople = Cast<UFlarePeople>(Destination);
+	if (DestinationCompany)
+	{
+		DestinationCompany->GiveMoney(Amount);
+	}
+	else if (DestinationPeople)
+	{
+		DestinationPeople->Pay((uint32) Amount);
+	}
+
+	RecordTransfer(Source, Destination, Amount, Reason);
+	return true;
+}
+
+void FFlareMoneyLedger::RecordTransfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason)
+{
+	if (Amount == 0 || Source == Destination)
+	{
+		return;
+	}
+
+	// Always record positive amounts
+	if (Amount < 0)
+	{
+		Swap(Source, Destination);
+		Amount = -Amount;
+	}
+
+	FFlareMoneyAccountId SourceId = FFlareMoneyAccountId::Get(Source);
+	FFlareMoneyAccountId DestinationId = FFlareMoneyAccountId::Get(Destination);
+
+	// Both sides of each transfer
+	if (SourceId.Type == EFlareMoneyAccount::Outside)
+	{
+		WorldMoney += Amount;
+	}
+	else
+	{
+		Accounts.FindOrAdd(SourceId).Expenses += Amount;
+	}
+
+	if (DestinationId.Type == EFlareMoneyAccount::Outside)
+	{
+		WorldMoney -= Amount;
+	}
+	else
+	{
+		Accounts.FindOrAdd(DestinationId).Income += Amount;
+	}
+
+	ReasonTotals[Reason] += Amount;
+	ReasonDayTotals[Reason] += Amount;
+
+	FFlareMoneyTransfer Transfer = { Source, Destination, Amount, Reason };
+	DayTransfers.Add(Transfer);
+}
+
+void FFlareMoneyLedger::BeginDay()
+{
+	FMemory::Memzero(ReasonDayTotals, sizeof(ReasonDayTotals));
+	DayTransfers.Empty();
+}
+
+const TCHAR* FFlareMoneyLedger::GetReasonName(EFlareMoneyReason::Type Reason)
+{
+	switch (Reason)
+	{
+		case EFlareMoneyReason::Trade:            return TEXT("Trade");
+		case EFlareMoneyReason::ShipOrder:        return TEXT("ShipOrder");
+		case EFlareMoneyReason::Production:       return TEXT("Production");
+		case EFlareMoneyReason::Wages:            return TEXT("Wages");
+		case EFlareMoneyReason::Consumption:      return TEXT("Consumption");
+		case EFlareMoneyReason::Construction:     return TEXT("Construction");
+		case EFlareMoneyReason::Upgrade:          return TEXT("Upgrade");
+		case EFlareMoneyReason::Scrap:            return TEXT("Scrap");
+		case EFlareMoneyReason::MutualAssistance: return TEXT("MutualAssistance");
+		case EFlareMoneyReason::Migration:        return TEXT("Migration");
+		case EFlareMoneyReason::Birth:            return TEXT("Birth");
+		case EFlareMoneyReason::Death:            return TEXT("Death");
+		case EFlareMoneyReason::Grant:            return TEXT("Grant");
+		default:                                  return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Object.h"
+#include "FlareMoneyLedger.generated.h"
+
+
+/** Money transfer reason */
+UENUM()
+namespace EFlareMoneyReason
+{
+	enum Type
+	{
+		Trade, /** Resource sold between companies */
+		ShipOrder, /** Ship ordered to a shipyard, or order refund */
+		Production, /** Production cost reserved by a factory, or reservation refund */
+		Wages, /** Production cost paid by a factory to the people */
+		Consumption, /** Resource sold to the people */
+		Construction, /** Station built or upgraded */
+		Upgrade, /** Spacecraft part bought or sold back */
+		Scrap, /** Ship scrapped in a station */
+		MutualAssistance, /** Money shared between the AI companies */
+		Migration, /** Money moving between sector people */
+		Birth, /** Money created with new people */
+		Death, /** Money destroyed with dead people */
+		Grant, /** Money given or taken by a scenario or a console command */
+		Count
+	};
+}
+
+/** Money account type */
+namespace EFlareMoneyAccount
+{
+	enum Type
+	{
+		Outside, /** Money created or destroyed */
+		World, /** Money pooled by the world during a day */
+		Company, /** A company with its factories */
+		People /** The people of a sector */
+	};
+}
+
+/** Ledger account of a money holder, by identifier so it never outlives or aliases a destroyed object */
+struct FFlareMoneyAccountId
+{
+	FFlareMoneyAccountId()
+		: Type(EFlareMoneyAccount::Outside)
+		, Identifier(NAME_None)
+	{}
+
+	/** Account of a company, a factory, sector people, the world, or NULL for the outside */
+	static FFlareMoneyAccountId Get(UObject* Holder);
+
+	bool operator==(const FFlareMoneyAccountId& Other) const
+	{
+		return Type == Other.Type && Identifier == Other.Identifier;
+	}
+
+	friend uint32 GetTypeHash(const FFlareMoneyAccountId& Id)
+	{
+		return HashCombine(GetTypeHash(Id.Identifier), (uint32) Id.Type);
+	}
+
+	EFlareMoneyAccount::Type Type;
+
+	FName Identifier;
+};
+
+/** Money transfer between two accounts. A NULL account is the outside of the economy */
+struct FFlareMoneyTransfer
+{
+	UObject* Source;
+
+	UObject* Destination;
+
+	int64 Amount;
+
+	EFlareMoneyReason::Type Reason;
+};
+
+/** Running totals of an account */
+struct FFlareMoneyAccount
+{
+	FFlareMoneyAccount()
+		: Income(0)
+		, Expenses(0)
+	{}
+
+	int64 Income;
+
+	int64 Expenses;
+};
+
+/** Double-entry record of the money transfers of the world. The ledger is session-only : it is not saved, and starts again from the scanned balances at each load */
+struct FFlareMoneyLedger
+{
+	FFlareMoneyLedger();
+
+	/** Start the world money total from a full count of the balances */
+	void InitWorldMoney(int64 Money);
+
+	/** Move money between two companies, sector people or the outside, and record it. Return false and move nothing if the source can't pay */
+	bool Transfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason, bool AllowDepts = false);
+
+	/** Record a transfer whose balances are updated by the caller : factories, the world pool, and the staged sector simulation */
+	void RecordTransfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason);
+
+	/** Forget the transfers of the previous day */
+	void BeginDay();
+
+	/** Money in the world, created or destroyed only by transfers from or to the outside */
+	inline int64 GetWorldMoney() const
+	{
+		return WorldMoney;
+	}
+
+	/** Money moved for a reason since the game was loaded */
+	inline int64 GetReasonTotal(EFlareMoneyReason::Type Reason) const
+	{
+		return ReasonTotals[Reason];
+	}
+
+	/** Money moved for a reason today */
+	inline int64 GetReasonDayTotal(EFlareMoneyReason::Type Reason) const
+	{
+		return ReasonDayTotals[Reason];
+	}
+
+	/** Totals of the account of a money holder, or NULL if nothing was transfered */
+	inline const FFlareMoneyAccount* GetAccount(UObject* Holder) const
+	{
+		return Accounts.Find(FFlareMoneyAccountId::Get(Holder));
+	}
+
+	/** Income minus expenses of the account of a money holder */
+	inline int64 GetAccountBalance(UObject* Holder) const
+	{
+		const FFlareMoneyAccount* Totals = GetAccount(Holder);
+		return Totals ? Totals->Income - Totals->Expenses : 0;
+	}
+
+	/** Transfers of the day, in order */
+	inline const TArray<FFlareMoneyTransfer>& GetDayTransfers() const
+	{
+		return DayTransfers;
+	}
+
+	static const TCHAR* GetReasonName(EFlareMoneyReason::Type Reason);
+
+protected:
+
+	int64                                        WorldMoney;
+
+	int64                                        ReasonTotals[EFlareMoneyReason::Count];
+
+	int64                                        ReasonDayTotals[EFlareMoneyReason::Count];
+
+	TMap<FFlareMoneyAccountId, FFlareMoneyAccount> Accounts;
+
+	TArray<FFlareMoneyTransfer>                  DayTransfers;
+
+};
@@ -70,19 +70,109 @@ static float TECH_SADNESS = 1;
 
 static int32 MIN_GENERAL_STOCK = 1000;
 
-void UFlarePeople::Simulate()
+/** Happiness of a population, between 0 and 2 */
+static inline float GetPopulationHappiness(uint32 HappinessPoint, uint32 Population)
 {
-	if(PeopleData.Population == 0)
+	if(Population == 0)
 	{
-		CheckPopulationDisparition();
-		return;
+		return 0;
 	}
+	return (float) HappinessPoint / (100 * (float) Population);
+}
 
+static inline float GetPopulationHappiness(const FFlarePeopleSave& Data)
+{
+	return GetPopulationHappiness(Data.HappinessPoint, Data.Population);
+}
 
-	SimulateResourcePurchase();
+static inline void IncreasePopulationHappiness(uint32& HappinessPoint, uint32 Population, uint32 HappinessPoints)
+{
+	// Max happiness is 2 so Happiness max is 200 x population
+	// Gain happiness is boost when sad and difficult when happy
+	//  - Normal gain for 1 as happiness
+	//  - 4 times gain for 0 as happiness
+	//  - No gain for 2 as happiness
+	// Formula: gain = (happiness - 2) ^ 2
+	float Happiness = GetPopulationHappiness(HappinessPoint, Population);
+	float Gain = FMath::Square(Happiness - 2);
+	HappinessPoint += HappinessPoints * Gain;
+	HappinessPoint = FMath::Min(HappinessPoint, Population * 200);
+}
+
+static inline void IncreasePopulationHappiness(FFlarePeopleSave& Data, uint32 HappinessPoints)
+{
+	IncreasePopulationHappiness(Data.HappinessPoint, Data.Population, HappinessPoints);
+}
+
+static inline void DecreasePopulationHappiness(uint32& HappinessPoint, uint32 Population, uint32 SadnessPoints)
+{
+	// Same as for increase but gain are inverted
+	float Happiness = GetPopulationHappiness(HappinessPoint, Population);
+	float Gain = FMath::Square(Happiness);
+	HappinessPoint -= SadnessPoints * Gain;
+	HappinessPoint = FMath::Max(HappinessPoint, (uint32) 0);
+}
+
+static inline void DecreasePopulationHappiness(FFlarePeopleSave& Data, uint32 SadnessPoints)
+{
+	DecreasePopulationHappiness(Data.HappinessPoint, Data.Population, SadnessPoints);
+}
+
+/** Add people and their money, return the birth count */
+static inline uint32 AddPopulation(uint32& Population, uint32& Money, uint32& HappinessPoint, uint32 BirthCount)
+{
+	if(BirthCount == 0)
+	{
+		return 0;
+	}
+
+	// Increase population
+	Population += BirthCount;
+
+	// Money creation
+	Money += BirthCount * MONETARY_CREATION;
+
+	IncreasePopulationHappiness(HappinessPoint, Population, BirthCount * 100 * 2);
+	HappinessPoint += BirthCount * 100 * 2; // Birth happiness bonus
+	return BirthCount;
+}
+
+static inline uint32 AddPopulation(FFlarePeopleSave& Data, uint32 BirthCount)
+{
+	return AddPopulation(Data.Population, Data.Money, Data.HappinessPoint, BirthCount);
+}
+
+/** Remove people and their money, return the kill count */
+static inline uint32 RemovePopulation(uint32& Population, uint32& Dept, uint32& HappinessPoint, uint32& HungerPoint, uint32 KillCount)
+{
+	uint32 PeopleToKill = FMath::Min(KillCount, Population);
+	if(PeopleToKill == 0)
+	{
+		return 0;
+	}
+
+	float KillRatio = (float) PeopleToKill / (float)Population;
+	// Decrease population
+	Population -= KillCount;
+
+	// Money destruction (delayed, really destroy on Pay)
+	Dept += KillCount * MONETARY_CREATION;
+
+	DecreasePopulationHappiness(HappinessPoint, Population, KillCount * 100 * 2); // Death happiness malus
 
-	float Happiness = GetHappiness();
+	//Cancel dead hunger
+	HungerPoint = (1 - KillRatio) * HungerPoint;
+	return KillCount;
+}
+
+static inline uint32 RemovePopulation(FFlarePeopleSave& Data, uint32 KillCount)
+{
+	return RemovePopulation(Data.Population, Data.Dept, Data.HappinessPoint, Data.HungerPoint, KillCount);
+}
 
+/** Deaths of a day, return the kill count */
+static inline uint32 SimulateDeaths(float Happiness, uint32& Population, uint32& DeathPoint, uint32& HungerPoint, uint32& HappinessPoint, uint32& Dept)
+{
 	// Death of old age : 1 death for 80 years per inhabitant = 1 death per 29200 inhabitant days
 	// Sickness increase with hunger and sadness
 	//	- 4 times normal sickness if happiness is 0
@@ -93,10 +183,15 @@ void UFlarePeople::Simulate()
 	//  Hunger is add to population death point
 	//
 	float Sickness = 0.5 + FMath::Square(Happiness - 2);
-	PeopleData.DeathPoint += (PeopleData.Population + PeopleData.HungerPoint * 2) * Sickness;
-	KillPeople(PeopleData.DeathPoint / DEATH_POINT_TRESHOLD);
-	PeopleData.DeathPoint = PeopleData.DeathPoint % DEATH_POINT_TRESHOLD;
+	DeathPoint += (Population + HungerPoint * 2) * Sickness;
+	uint32 KillCount = RemovePopulation(Population, Dept, HappinessPoint, HungerPoint, DeathPoint / DEATH_POINT_TRESHOLD);
+	DeathPoint = DeathPoint % DEATH_POINT_TRESHOLD;
+	return KillCount;
+}
 
+/** Births of a day, return the birth count */
+static inline uint32 SimulateBirths(float Happiness, uint32& Population, uint32& BirthPoint, uint32& Money, uint32& HappinessPoint)
+{
 	// Births : 1 birth for 20 years per inhabitant = 1 birth per 7120 inhabitant days (No more right)
 	// Fertility increase with happiness :
 	//	 - no fertility if hapinness is less of 50%
@@ -105,71 +200,107 @@ void UFlarePeople::Simulate()
 	//   Formula : fertility = 2 * happiness -1
 	float Fertility = FMath::Max(2 * Happiness -1, 0.0f);
 
-	PeopleData.BirthPoint += PeopleData.Population * Fertility;
-	GiveBirth(PeopleData.BirthPoint / BIRTH_POINT_TRESHOLD);
-	PeopleData.BirthPoint = PeopleData.BirthPoint % BIRTH_POINT_TRESHOLD;
-
+	BirthPoint += Population * Fertility;
+	uint32 BirthCount = AddPopulation(Population, Money, HappinessPoint, BirthPoint / BIRTH_POINT_TRESHOLD);
+	BirthPoint = BirthPoint % BIRTH_POINT_TRESHOLD;
+	return BirthCount;
+}
 
-	// Eat
+/** Food of a day */
+static inline void SimulateFood(uint32& FoodStock, uint32& HungerPoint, uint32& HappinessPoint, uint32 Population, float Consumption)
+{
 	// Each inhabitant eat 1 kg of food a day as vital food.
 	// If an inhabitant don't heat, happiness decrease heavily and  hunger is increase
 	// If some inhabitant heat, the hunger deaseapear and some happiness is gain
-	uint32 FoodConsumption = PeopleData.Population * PeopleData.FoodConsumption;
-	uint32 EatenFood = FMath::Min(FoodConsumption, PeopleData.FoodStock);
+	uint32 FoodConsumption = Population * Consumption;
+	uint32 EatenFood = FMath::Min(FoodConsumption, FoodStock);
 	// Reduce stock
-	PeopleData.FoodStock -= EatenFood;
-	IncreaseHappiness(EatenFood * FOOD_HAPPINESS);
+	FoodStock -= EatenFood;
+	IncreasePopulationHappiness(HappinessPoint, Population, EatenFood * FOOD_HAPPINESS);
 
 	// Reduce hunger (100% if everybody eat)
 	float FeedPeopleRatio = (float) EatenFood / (float) FoodConsumption;
 
-	PeopleData.HungerPoint *= 1 - FeedPeopleRatio;
+	HungerPoint *= 1 - FeedPeopleRatio;
 
 	// Add hunger (0 if everybody eat)
 	uint32 Hunger = FoodConsumption - EatenFood;
-	PeopleData.HungerPoint += Hunger + PeopleData.HungerPoint / 10;
-	DecreaseHappiness(Hunger * FOOD_SADNESS);
+	HungerPoint += Hunger + HungerPoint / 10;
+	DecreasePopulationHappiness(HappinessPoint, Population, Hunger * FOOD_SADNESS);
+}
 
-	// Fuel
-	int32 FuelConsumption = PeopleData.Population * PeopleData.FuelConsumption;
-	int32 EatenFuel = FMath::Min(FuelConsumption, PeopleData.FuelStock);
+/** Fuel, tool or tech of a day */
+static inline void SimulateConsumption(int32& Stock, uint32& HappinessPoint, uint32 Population, float Consumption, float Happiness, float Sadness)
+{
+	int32 ResourceConsumption = Population * Consumption;
+	int32 EatenResource = FMath::Min(ResourceConsumption, Stock);
 	// Reduce stock
-	PeopleData.FuelStock -= EatenFuel;
-	IncreaseHappiness(EatenFuel * FUEL_HAPPINESS);
+	Stock -= EatenResource;
+	IncreasePopulationHappiness(HappinessPoint, Population, EatenResource * Happiness);
 
 	// Add hunger (0 if everybody eat)
-	Hunger = FuelConsumption - EatenFuel;
-	DecreaseHappiness(Hunger * FUEL_SADNESS);
+	uint32 Hunger = ResourceConsumption - EatenResource;
+	DecreasePopulationHappiness(HappinessPoint, Population, Hunger * Sadness);
+}
 
-	// Tool
-	int32 ToolConsumption = PeopleData.Population * PeopleData.ToolConsumption;
-	int32 EatenTool = FMath::Min(ToolConsumption, PeopleData.ToolStock);
-	// Reduce stock
-	PeopleData.ToolStock -= EatenTool;
-	IncreaseHappiness(EatenTool * TOOL_HAPPINESS);
+void UFlarePeople::Simulate()
+{
+	if(PeopleData.Population == 0)
+	{
+		CheckPopulationDisparition();
+		return;
+	}
 
 
-	// Add hunger (0 if everybody eat)
-	Hunger = ToolConsumption - EatenTool;
-	DecreaseHappiness(Hunger * TOOL_SADNESS);
+	SimulateResourcePurchase();
 
-	// Tech
-	int32 TechConsumption = PeopleData.Population * PeopleData.TechConsumption;
-	int32 EatenTech = FMath::Min(TechConsumption, PeopleData.TechStock);
-	// Reduce stock
-	PeopleData.TechStock -= EatenTech;
-	IncreaseHappiness(EatenTech * TECH_HAPPINESS);
+	FFlarePopulationDay Day;
+	SimulatePopulation(PeopleData, Day);
+	RecordPopulationDay(Day);
+}
+
+void UFlarePeople::SimulatePopulations(const TArray<FFlarePeopleSave*>& Data, TArray<FFlarePopulationDay>& Days)
+{
+	FFlarePopulationBatch Batch;
+	Batch.Gather(Data);
+	Batch.Simulate();
+	Batch.Scatter(Data, Days);
+}
+
+void UFlarePeople::SimulatePopulation(FFlarePeopleSave& Data, FFlarePopulationDay& Day)
+{
+	float Happiness = GetPopulationHappiness(Data);
+
+	Day.KillCount = SimulateDeaths(Happiness, Data.Population, Data.DeathPoint, Data.HungerPoint, Data.HappinessPoint, Data.Dept);
+	Day.BirthCount = SimulateBirths(Happiness, Data.Population, Data.BirthPoint, Data.Money, Data.HappinessPoint);
+
+	SimulateFood(Data.FoodStock, Data.HungerPoint, Data.HappinessPoint, Data.Population, Data.FoodConsumption);
+	SimulateConsumption(Data.FuelStock, Data.HappinessPoint, Data.Population, Data.FuelConsumption, FUEL_HAPPINESS, FUEL_SADNESS);
+	SimulateConsumption(Data.ToolStock, Data.HappinessPoint, Data.Population, Data.ToolConsumption, TOOL_HAPPINESS, TOOL_SADNESS);
+	SimulateConsumption(Data.TechStock, Data.HappinessPoint, Data.Population, Data.TechConsumption, TECH_HAPPINESS, TECH_SADNESS);
+}
+
+void UFlarePeople::RecordPopulationDay(const FFlarePopulationDay& Day)
+{
+	if (Day.KillCount)
+	{
+		FLOGV("Kill %u people for sector %s", Day.KillCount, *Parent->GetSectorName().ToString());
+		Parent->RecordMoneyTransfer(this, NULL, Day.KillCount * MONETARY_CREATION, EFlareMoneyReason::Death);
+	}
 
-	Hunger = TechConsumption - EatenTech;
-	DecreaseHappiness(Hunger * TECH_SADNESS);
+	if (Day.BirthCount)
+	{
+		FLOGV("Give birth %u people for sector %s", Day.BirthCount, *Parent->GetSectorName().ToString());
+		Parent->RecordMoneyTransfer(NULL, this, Day.BirthCount * MONETARY_CREATION, EFlareMoneyReason::Birth);
+	}
 }
 
 void UFlarePeople::SimulateResourcePurchase()
 {
-	FFlareResourceDescription* Food = Game->GetResourceCatalog()->Get("food");
-	FFlareResourceDescription* Fuel = Game->GetResourceCatalog()->Get("fuel");
-	FFlareResourceDescription* Tool = Game->GetResourceCatalog()->Get("tools");
-	FFlareResourceDescription* Tech = Game->GetResourceCatalog()->Get("tech");
+	FFlareResourceDescription* Food = Game->GetResourceCatalog()->GetFood();
+	FFlareResourceDescription* Fuel = Game->GetResourceCatalog()->GetFuel();
+	FFlareResourceDescription* Tool = Game->GetResourceCatalog()->GetTools();
+	FFlareResourceDescription* Tech = Game->GetResourceCatalog()->GetTech();
 
 	uint32 FoodConsumption = GetRessourceConsumption(Food);
 	uint32 BoughtFood = BuyResourcesInSector(Food, FoodConsumption); // In Tons
@@ -271,56 +402,108 @@ void UFlarePeople::SimulateResourcePurchase()
 
 uint32 UFlarePeople::BuyResourcesInSector(FFlareResourceDescription* Resource, uint32 Quantity)
 {
-	// Find companies selling the ressource
-
+	// Find companies selling the ressource, with their stock in consumer stations
 	TArray<UFlareSimulatedSpacecraft*> SellingStations;
 	TArray<UFlareCompany*> SellingCompanies;
+	TArray<uint32> AvailableQuantities;
 
-	for (int32 SpacecraftIndex = 0; SpacecraftIndex < Parent->GetSectorStations().Num(); SpacecraftIndex++)
+	if (Game->GetResourceCatalog()->IsCustomerResource(Resource))
 	{
-		UFlareSimulatedSpacecraft* Station = Parent->GetSectorStations()[SpacecraftIndex];
+		const TArray<FFlareResourceUse>& Uses = Parent->GetResourceUses(Resource);
+		for (int32 UseIndex = 0; UseIndex < Uses.Num(); UseIndex++)
+		{
+			if (Uses[UseIndex].Role == EFlareResourcePriceContext::ConsumerConsumption)
+			{
+				SellingStations.Add(Uses[UseIndex].Station);
+			}
+		}
+	}
+	else
+	{
+		for (int32 SpacecraftIndex = 0; SpacecraftIndex < Parent->GetSectorStations().Num(); SpacecraftIndex++)
+		{
+			UFlareSimulatedSpacecraft* Station = Parent->GetSectorStations()[SpacecraftIndex];
+			if (Station->HasCapability(EFlareSpacecraftCapability::Consumer))
+			{
+				SellingStations.Add(Station);
+			}
+		}
+	}
 
-		if(!Station->HasCapability(EFlareSpacecraftCapability::Consumer))
+	for (int32 StationIndex = 0; StationIndex < SellingStations.Num(); StationIndex++)
+	{
+		UFlareSimulatedSpacecraft* Station = SellingStations[StationIndex];
+		int32 CompanyIndex = SellingCompanies.AddUnique(Station->GetCompany());
+		if (CompanyIndex == AvailableQuantities.Num())
 		{
-			continue;
+			AvailableQuantities.Add(0);
 		}
-		SellingStations.Add(Station);
-		SellingCompanies.AddUnique(Station->GetCompany());
+		AvailableQuantities[CompanyIndex] += Station->GetCargoBay()->GetResourceQuantity(Resource);
 	}
 
 	// Limit quantity to buy with money
 	uint32 BaseQuantity = FMath::Min(Quantity, PeopleData.Money / (uint32) (Parent->GetResourcePrice(Resource, EFlareResourcePriceContext::ConsumerConsumption)));
 	uint32 ResourceToBuy = BaseQuantity;
 
-	while(ResourceToBuy > 0 && SellingCompanies.Num() > 0)
+	if (ResourceToBuy == 0 || SellingCompanies.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Reputations don't change while buying
+	TArray<float> Reputations;
+	for (int32 CompanyIndex = 0; CompanyIndex < SellingCompanies.Num(); CompanyIndex++)
+	{
+		Reputations.Add(GetCompanyReputation(SellingCompanies[CompanyIndex])->Reputation);
+	}
+
+	// Share the market by reputation : a company without enough stock leaves the market
+	// and its missing part is shared again between the others on the next pass
+	TArray<uint32> BoughtQuantities;
+	BoughtQuantities.SetNumZeroed(SellingCompanies.Num());
+	TArray<int32> MarketCompanies;
+	for (int32 CompanyIndex = 0; CompanyIndex < SellingCompanies.Num(); CompanyIndex++)
+	{
+		MarketCompanies.Add(CompanyIndex);
+	}
+
+	while(ResourceToBuy > 0 && MarketCompanies.Num() > 0)
 	{
 		uint32 ReputationSum = 0;
 		uint32 InitialResourceToBuy = ResourceToBuy;
 
 		// Compute company reputation sum to share market part
-		for (int32 CompanyIndex = 0; CompanyIndex < SellingCompanies.Num(); CompanyIndex++)
+		for (int32 MarketIndex = 0; MarketIndex < MarketCompanies.Num(); MarketIndex++)
 		{
-			FFlareCompanyReputationSave* Reputation = GetCompanyReputation(SellingCompanies[CompanyIndex]);
-
-			ReputationSum += Reputation->Reputation;
+			ReputationSum += Reputations[MarketCompanies[MarketIndex]];
 		}
 
-		for (int32 CompanyIndex = SellingCompanies.Num()-1; CompanyIndex >= 0; CompanyIndex--)
+		for (int32 MarketIndex = MarketCompanies.Num()-1; MarketIndex >= 0; MarketIndex--)
 		{
-			FFlareCompanyReputationSave* Reputation = GetCompanyReputation(SellingCompanies[CompanyIndex]);
+			int32 CompanyIndex = MarketCompanies[MarketIndex];
 
-			uint32 PartToBuy = (InitialResourceToBuy * Reputation->Reputation) / ReputationSum;
+			uint32 PartToBuy = (InitialResourceToBuy * Reputations[CompanyIndex]) / ReputationSum;
 
-			uint32 BoughtQuantity = BuyInStationForCompany(Resource, PartToBuy, SellingCompanies[CompanyIndex], SellingStations);
+			uint32 BoughtQuantity = FMath::Min(PartToBuy, AvailableQuantities[CompanyIndex] - BoughtQuantities[CompanyIndex]);
+			BoughtQuantities[CompanyIndex] += BoughtQuantity;
 			ResourceToBuy -= BoughtQuantity;
 
 			if(PartToBuy == 0 || BoughtQuantity < PartToBuy)
 			{
-				SellingCompanies.RemoveAt(CompanyIndex);
+				MarketCompanies.RemoveAt(MarketIndex);
 			}
 		}
 	}
 
+	// Take the resources once per company
+	for (int32 CompanyIndex = SellingCompanies.Num()-1; CompanyIndex >= 0; CompanyIndex--)
+	{
+		if (BoughtQuantities[CompanyIndex] > 0)
+		{
+			BuyInStationForCompany(Resource, BoughtQuantities[CompanyIndex], SellingCompanies[CompanyIndex], SellingStations);
+		}
+	}
+
 	return BaseQuantity - ResourceToBuy;
 }
 
@@ -343,7 +526,16 @@ uint32 UFlarePeople::BuyInStationForCompany(FFlareResourceDescription* Resource,
 		RemainingQuantity -= TakenQuantity;
 		uint32 Price = (uint32) (Parent->GetResourcePrice(Resource, EFlareResourcePriceContext::ConsumerConsumption)) * TakenQuantity;
 		PeopleData.Money -= Price;
-		Company->GiveMoney(Price);
+
+		if (Parent->GetSimulationBuffer())
+		{
+			Parent->GetSimulationBuffer()->GiveMoney(Company, Price);
+		}
+		else
+		{
+			Company->GiveMoney(Price);
+		}
+		Parent->RecordMoneyTransfer(this, Company, Price, EFlareMoneyReason::Consumption);
 	}
 
 	return Quantity - RemainingQuantity;
@@ -351,10 +543,10 @@ uint32 UFlarePeople::BuyInStationForCompany(FFlareResourceDescription* Resource,
 
 uint32 UFlarePeople::GetRessourceConsumption(FFlareResourceDescription* Resource)
 {
-	FFlareResourceDescription* Food = Game->GetResourceCatalog()->Get("food");
-	FFlareResourceDescription* Fuel = Game->GetResourceCatalog()->Get("fuel");
-	FFlareResourceDescription* Tools = Game->GetResourceCatalog()->Get("tools");
-	FFlareResourceDescription* Tech = Game->GetResourceCatalog()->Get("tech");
+	FFlareResourceDescription* Food = Game->GetResourceCatalog()->GetFood();
+	FFlareResourceDescription* Fuel = Game->GetResourceCatalog()->GetFuel();
+	FFlareResourceDescription* Tools = Game->GetResourceCatalog()->GetTools();
+	FFlareResourceDescription* Tech = Game->GetResourceCatalog()->GetTech();
 
 	if (PeopleData.Population == 0)
 	{
@@ -423,78 +615,28 @@ uint32 UFlarePeople::GetRessourceConsumption(FFlareResourceDescription* Resource
 
 void UFlarePeople::GiveBirth(uint32 BirthCount)
 {
-	if(BirthCount == 0)
-	{
-		return;
-	}
-
-	FLOGV("Give birth %u people for sector %s", BirthCount, *Parent->GetSectorName().ToString());
-
-	// Increase population
-	PeopleData.Population += BirthCount;
-
-	// Money creation
-	uint32 NewMoney = BirthCount * MONETARY_CREATION;
-	PeopleData.Money += NewMoney;
-	Game->GetGameWorld()->WorldMoneyReference += NewMoney;
-
-	IncreaseHappiness(BirthCount * 100 * 2);
-	PeopleData.HappinessPoint += BirthCount * 100 * 2; // Birth happiness bonus
+	FFlarePopulationDay Day;
+	Day.KillCount = 0;
+	Day.BirthCount = AddPopulation(PeopleData, BirthCount);
+	RecordPopulationDay(Day);
 }
 
 void UFlarePeople::KillPeople(uint32 KillCount)
 {
-
-	uint32 PeopleToKill = FMath::Min(KillCount, PeopleData.Population);
-	if(PeopleToKill == 0)
-	{
-		return;
-	}
-
-	FLOGV("Kill %u people for sector %s", KillCount, *Parent->GetSectorName().ToString());
-
-
-	float KillRatio = (float) PeopleToKill / (float)PeopleData.Population;
-	// Decrease population
-	PeopleData.Population -= KillCount;
-
-	// Money destruction (delayed, really destroy on Pay)
-	uint32 DestroyedMoney = KillCount * MONETARY_CREATION;
-	PeopleData.Dept += DestroyedMoney;
-	Game->GetGameWorld()->WorldMoneyReference -= DestroyedMoney;
-
-	DecreaseHappiness(KillCount * 100 * 2); // Death happiness malus
-
-	//Cancel dead hunger
-	PeopleData.HungerPoint = (1 - KillRatio) * PeopleData.HungerPoint;
-
-	if(PeopleToKill == 0)
-	{
-		ResetPeople();
-	}
+	FFlarePopulationDay Day;
+	Day.KillCount = RemovePopulation(PeopleData, KillCount);
+	Day.BirthCount = 0;
+	RecordPopulationDay(Day);
 }
 
 void UFlarePeople::IncreaseHappiness(uint32 HappinessPoints)
 {
-	// Max happiness is 2 so Happiness max is 200 x population
-	// Gain happiness is boost when sad and difficult when happy
-	//  - Normal gain for 1 as happiness
-	//  - 4 times gain for 0 as happiness
-	//  - No gain for 2 as happiness
-	// Formula: gain = (happiness - 2) ^ 2
-	float Happiness = GetHappiness();
-	float Gain = FMath::Square(Happiness - 2);
-	PeopleData.HappinessPoint += HappinessPoints * Gain;
-	PeopleData.HappinessPoint = FMath::Min(PeopleData.HappinessPoint, PeopleData.Population * 200);
+	IncreasePopulationHappiness(PeopleData, HappinessPoints);
 }
 
 void UFlarePeople::DecreaseHappiness(uint32 SadnessPoints)
 {
-	// Same as for increase but gain are inverted
-	float Happiness = GetHappiness();
-	float Gain = FMath::Square(Happiness);
-	PeopleData.HappinessPoint -= SadnessPoints * Gain;
-	PeopleData.HappinessPoint = FMath::Max(PeopleData.HappinessPoint, (uint32) 0);
+	DecreasePopulationHappiness(PeopleData, SadnessPoints);
 }
 
 void UFlarePeople::SetHappiness(float Happiness)
@@ -594,11 +736,7 @@ void UFlarePeople::CheckPopulationDisparition()
 
 float UFlarePeople::GetHappiness()
 {
-	if(PeopleData.Population == 0)
-	{
-		return 0;
-	}
-	return (float) PeopleData.HappinessPoint / (100 * (float) PeopleData.Population);
+	return GetPopulationHappiness(PeopleData);
 }
 
 float UFlarePeople::GetWealth()
@@ -629,4 +767,118 @@ FFlareCompanyReputationSave* UFlarePeople::GetCompanyReputation(UFlareCompany* C
 	return GetCompanyReputation(Company);
 }
 
+/*----------------------------------------------------
+	Population batch
+----------------------------------------------------*/
+
+void FFlarePopulationBatch::Gather(const TArray<FFlarePeopleSave*>& Data)
+{
+	Count = Data.Num();
+
+	Population.SetNumUninitialized(Count);
+	Money.SetNumUninitialized(Count);
+	Dept.SetNumUninitialized(Count);
+	BirthPoint.SetNumUninitialized(Count);
+	DeathPoint.SetNumUninitialized(Count);
+	HungerPoint.SetNumUninitialized(Count);
+	HappinessPoint.SetNumUninitialized(Count);
+	FoodStock.SetNumUninitialized(Count);
+	FuelStock.SetNumUninitialized(Count);
+	ToolStock.SetNumUninitialized(Count);
+	TechStock.SetNumUninitialized(Count);
+	FoodConsumption.SetNumUninitialized(Count);
+	FuelConsumption.SetNumUninitialized(Count);
+	ToolConsumption.SetNumUninitialized(Count);
+	TechConsumption.SetNumUninitialized(Count);
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		const FFlarePeopleSave& People = *Data[Index];
+		Population[Index] = People.Population;
+		Money[Index] = People.Money;
+		Dept[Index] = People.Dept;
+		BirthPoint[Index] = People.BirthPoint;
+		DeathPoint[Index] = People.DeathPoint;
+		HungerPoint[Index] = People.HungerPoint;
+		HappinessPoint[Index] = People.HappinessPoint;
+		FoodStock[Index] = People.FoodStock;
+		FuelStock[Index] = People.FuelStock;
+		ToolStock[Index] = People.ToolStock;
+		TechStock[Index] = People.TechStock;
+		FoodConsumption[Index] = People.FoodConsumption;
+		FuelConsumption[Index] = People.FuelConsumption;
+		ToolConsumption[Index] = People.ToolConsumption;
+		TechConsumption[Index] = People.TechConsumption;
+	}
+}
+
+void FFlarePopulationBatch::Simulate()
+{
+	// Each step runs over all the sectors, in the order of UFlarePeople::SimulatePopulation
+	Happiness.SetNumUninitialized(Count);
+	BirthCount.SetNumUninitialized(Count);
+	KillCount.SetNumUninitialized(Count);
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		Happiness[Index] = GetPopulationHappiness(HappinessPoint[Index], Population[Index]);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		KillCount[Index] = SimulateDeaths(Happiness[Index], Population[Index], DeathPoint[Index], HungerPoint[Index], HappinessPoint[Index], Dept[Index]);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		BirthCount[Index] = SimulateBirths(Happiness[Index], Population[Index], BirthPoint[Index], Money[Index], HappinessPoint[Index]);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SimulateFood(FoodStock[Index], HungerPoint[Index], HappinessPoint[Index], Population[Index], FoodConsumption[Index]);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SimulateConsumption(FuelStock[Index], HappinessPoint[Index], Population[Index], FuelConsumption[Index], FUEL_HAPPINESS, FUEL_SADNESS);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SimulateConsumption(ToolStock[Index], HappinessPoint[Index], Population[Index], ToolConsumption[Index], TOOL_HAPPINESS, TOOL_SADNESS);
+	}
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SimulateConsumption(TechStock[Index], HappinessPoint[Index], Population[Index], TechConsumption[Index], TECH_HAPPINESS, TECH_SADNESS);
+	}
+}
+
+void FFlarePopulationBatch::Scatter(const TArray<FFlarePeopleSave*>& Data, TArray<FFlarePopulationDay>& Days) const
+{
+	check(Data.Num() == Count);
+	Days.SetNum(Count);
+
+	// Consumptions are read only
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		FFlarePeopleSave& People = *Data[Index];
+		People.Population = Population[Index];
+		People.Money = Money[Index];
+		People.Dept = Dept[Index];
+		People.BirthPoint = BirthPoint[Index];
+		People.DeathPoint = DeathPoint[Index];
+		People.HungerPoint = HungerPoint[Index];
+		People.HappinessPoint = HappinessPoint[Index];
+		People.FoodStock = FoodStock[Index];
+		People.FuelStock = FuelStock[Index];
+		People.ToolStock = ToolStock[Index];
+		People.TechStock = TechStock[Index];
+
+		Days[Index].BirthCount = BirthCount[Index];
+		Days[Index].KillCount = KillCount[Index];
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
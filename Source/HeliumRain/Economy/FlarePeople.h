@@ -80,6 +80,49 @@ struct FFlarePeopleSave
 };
 
 
+/** Births and deaths of a population day, recorded once the day is computed */
+struct FFlarePopulationDay
+{
+	uint32 BirthCount;
+
+	uint32 KillCount;
+};
+
+/** Population data of many sectors, one contiguous array per field, simulated step by step over all sectors */
+struct FFlarePopulationBatch
+{
+	/** Copy the people data into the arrays */
+	void Gather(const TArray<FFlarePeopleSave*>& Data);
+
+	/** Births, deaths, consumption and happiness of a day for all sectors */
+	void Simulate();
+
+	/** Copy the arrays back into the same people data, with the day of each sector */
+	void Scatter(const TArray<FFlarePeopleSave*>& Data, TArray<FFlarePopulationDay>& Days) const;
+
+	int32 Count;
+
+	TArray<uint32> Population;
+	TArray<uint32> Money;
+	TArray<uint32> Dept;
+	TArray<uint32> BirthPoint;
+	TArray<uint32> DeathPoint;
+	TArray<uint32> HungerPoint;
+	TArray<uint32> HappinessPoint;
+	TArray<uint32> FoodStock;
+	TArray<int32> FuelStock;
+	TArray<int32> ToolStock;
+	TArray<int32> TechStock;
+	TArray<float> FoodConsumption;
+	TArray<float> FuelConsumption;
+	TArray<float> ToolConsumption;
+	TArray<float> TechConsumption;
+
+	TArray<float> Happiness;
+	TArray<uint32> BirthCount;
+	TArray<uint32> KillCount;
+};
+
 
 UCLASS()
 class HELIUMRAIN_API UFlarePeople : public UObject
@@ -105,6 +148,15 @@ public:
 
 	void SimulateResourcePurchase();
 
+	/** Births, deaths, consumption and happiness of a day, from the people data only */
+	static void SimulatePopulation(FFlarePeopleSave& Data, FFlarePopulationDay& Day);
+
+	/** Simulate the population day of many sectors as one batch */
+	static void SimulatePopulations(const TArray<FFlarePeopleSave*>& Data, TArray<FFlarePopulationDay>& Days);
+
+	/** Record the money created by births and destroyed by deaths */
+	void RecordPopulationDay(const FFlarePopulationDay& Day);
+
 	uint32 BuyResourcesInSector(FFlareResourceDescription* Resource, uint32 Quantity);
 
 	uint32 BuyInStationForCompany(FFlareResourceDescription* Resource, uint32 Quantity, UFlareCompany* Company, TArray<UFlareSimulatedSpacecraft*>& Stations);
@@ -41,6 +41,9 @@ struct FFlareResourceDescription
 	/** Min resource price */
 	UPROPERTY(EditAnywhere, Category = Content)
 	int64 TransportFee;
+
+	/** Position in the resource catalog, set when the catalog is loaded */
+	int32 Index;
 };
 
 /** Spacecraft cargo data */
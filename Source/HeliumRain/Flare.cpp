@@ -7,6 +7,70 @@ IMPLEMENT_PRIMARY_GAME_MODULE(FFlareModule, HeliumRain, "HeliumRain");
 DEFINE_LOG_CATEGORY(LogFlare)
 
 
+/*----------------------------------------------------
+	Simulation stats
+----------------------------------------------------*/
+
+DEFINE_STAT(STAT_FlareWorld_Simulate);
+DEFINE_STAT(STAT_FlareWorld_Battles);
+DEFINE_STAT(STAT_FlareWorld_AI);
+DEFINE_STAT(STAT_FlareWorld_MutualAssistance);
+DEFINE_STAT(STAT_FlareWorld_Integrity);
+DEFINE_STAT(STAT_FlareWorld_Factories);
+DEFINE_STAT(STAT_FlareWorld_People);
+DEFINE_STAT(STAT_FlareWorld_TradeRoutes);
+DEFINE_STAT(STAT_FlareWorld_Travels);
+DEFINE_STAT(STAT_FlareWorld_Reputation);
+DEFINE_STAT(STAT_FlareWorld_PriceVariation);
+DEFINE_STAT(STAT_FlareWorld_MoneyMigration);
+
+DEFINE_STAT(STAT_FlareCompanyAI_Simulate);
+DEFINE_STAT(STAT_FlareCompanyAI_Plan);
+DEFINE_STAT(STAT_FlareFactory_Simulate);
+DEFINE_STAT(STAT_FlareSector_SimulatePriceVariation);
+DEFINE_STAT(STAT_FlareTravel_Simulate);
+
+DEFINE_STAT(STAT_FlareCalls_ComputeTravelDuration);
+DEFINE_STAT(STAT_FlareCalls_GetResourceQuantity);
+DEFINE_STAT(STAT_FlareCalls_FindTradeStation);
+
+static uint32 CallCounterTlsSlot = FPlatformTLS::AllocTlsSlot();
+static FCriticalSection CallCounterLock;
+static TArray<int32*> CallCounterBlocks;
+
+int32* FFlareSimulationCallCounters::GetThreadCounters()
+{
+	int32* Counters = (int32*) FPlatformTLS::GetTlsValue(CallCounterTlsSlot);
+
+	if (!Counters)
+	{
+		Counters = new int32[EFlareSimulationCall::Count];
+		FMemory::Memzero(Counters, EFlareSimulationCall::Count * sizeof(int32));
+		FPlatformTLS::SetTlsValue(CallCounterTlsSlot, Counters);
+
+		FScopeLock Lock(&CallCounterLock);
+		CallCounterBlocks.Add(Counters);
+	}
+
+	return Counters;
+}
+
+void FFlareSimulationCallCounters::Collect(int32* OutCounts)
+{
+	FMemory::Memzero(OutCounts, EFlareSimulationCall::Count * sizeof(int32));
+
+	FScopeLock Lock(&CallCounterLock);
+	for (int32 BlockIndex = 0; BlockIndex < CallCounterBlocks.Num(); BlockIndex++)
+	{
+		for (int32 CallIndex = 0; CallIndex < EFlareSimulationCall::Count; CallIndex++)
+		{
+			OutCounts[CallIndex] += CallCounterBlocks[BlockIndex][CallIndex];
+			CallCounterBlocks[BlockIndex][CallIndex] = 0;
+		}
+	}
+}
+
+
 /*----------------------------------------------------
 	Module loading / unloading code
 ----------------------------------------------------*/
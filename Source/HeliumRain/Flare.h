@@ -91,6 +91,82 @@ struct FFlareMenuParameterData
 DECLARE_LOG_CATEGORY_EXTERN(LogFlare, Log, All);
 
 
+/*----------------------------------------------------
+	Simulation stats
+----------------------------------------------------*/
+
+DECLARE_STATS_GROUP(TEXT("FlareSimulation"), STATGROUP_FlareSimulation, STATCAT_Advanced);
+
+// World day phases
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day"), STAT_FlareWorld_Simulate, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Battles"), STAT_FlareWorld_Battles, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - AI"), STAT_FlareWorld_AI, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Mutual assistance"), STAT_FlareWorld_MutualAssistance, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Integrity"), STAT_FlareWorld_Integrity, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Factories"), STAT_FlareWorld_Factories, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - People"), STAT_FlareWorld_People, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Trade routes"), STAT_FlareWorld_TradeRoutes, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Travels"), STAT_FlareWorld_Travels, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Reputation"), STAT_FlareWorld_Reputation, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Price variation"), STAT_FlareWorld_PriceVariation, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("World day - Money migration"), STAT_FlareWorld_MoneyMigration, STATGROUP_FlareSimulation, );
+
+// Simulated objects
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Company AI"), STAT_FlareCompanyAI_Simulate, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Company AI plan"), STAT_FlareCompanyAI_Plan, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Factory"), STAT_FlareFactory_Simulate, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sector price variation"), STAT_FlareSector_SimulatePriceVariation, STATGROUP_FlareSimulation, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Travel"), STAT_FlareTravel_Simulate, STATGROUP_FlareSimulation, );
+
+// Hot calls
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("ComputeTravelDuration calls"), STAT_FlareCalls_ComputeTravelDuration, STATGROUP_FlareSimulation, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("GetResourceQuantity calls"), STAT_FlareCalls_GetResourceQuantity, STATGROUP_FlareSimulation, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("FindTradeStation calls"), STAT_FlareCalls_FindTradeStation, STATGROUP_FlareSimulation, );
+
+/** Call counting is compiled with the stats, or forced by defining FLARE_CALL_COUNTERS to 1 */
+#ifndef FLARE_CALL_COUNTERS
+#define FLARE_CALL_COUNTERS STATS
+#endif
+
+/** Counted hot calls */
+namespace EFlareSimulationCall
+{
+	enum Type
+	{
+		ComputeTravelDuration,
+		GetResourceQuantity,
+		FindTradeStation,
+		Count
+	};
+}
+
+/** Call counts of the hot simulation functions. Each thread counts on its own block, the world merges them every day */
+struct FFlareSimulationCallCounters
+{
+	/** Count a call on the block of the current thread */
+	static inline void Increment(EFlareSimulationCall::Type Call)
+	{
+		GetThreadCounters()[Call]++;
+	}
+
+	/** Sum the blocks of all threads into OutCounts and reset them. Only call it while no simulation task runs */
+	static void Collect(int32* OutCounts);
+
+protected:
+
+	/** Block of the current thread, created at its first call */
+	static int32* GetThreadCounters();
+
+};
+
+#if FLARE_CALL_COUNTERS
+#define FLARE_COUNT_CALL(Name) \
+	FFlareSimulationCallCounters::Increment(EFlareSimulationCall::Name)
+#else
+#define FLARE_COUNT_CALL(Name)
+#endif
+
+
 /*----------------------------------------------------
 	Game module definition
 ----------------------------------------------------*/
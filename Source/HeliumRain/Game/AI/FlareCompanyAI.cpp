@@ -9,6 +9,12 @@
 
 #define STATION_CONSTRUCTION_PRICE_BONUS 1.2
 
+// Deal gain bounds are compared to float balances, keep them above the rounding
+#define DEAL_BOUND_MARGIN 1.001f
+
+// Minimal raise of a deal price in the cargo auction, relative to the best deal balance
+#define CARGO_AUCTION_EPSILON 0.001f
+
 /*----------------------------------------------------
 	Constructor
 ----------------------------------------------------*/
@@ -22,6 +28,7 @@ void UFlareCompanyAI::Load(UFlareCompany* ParentCompany, const FFlareCompanyAISa
 {
 	Company = ParentCompany;
 	Game = Company->GetGame();
+	Planned = false;
 	ResetShipGroup(EFlareCombatTactic::AttackMilitary);
 }
 
@@ -35,8 +42,31 @@ FFlareCompanyAISave* UFlareCompanyAI::Save()
 	Gameplay
 ----------------------------------------------------*/
 
+void UFlareCompanyAI::Plan()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareCompanyAI_Plan);
+
+	Planned = false;
+
+	if (Company == Game->GetPC()->GetCompany())
+	{
+		return;
+	}
+
+	ComputeResourceVariations();
+	ComputeBestStation();
+
+	Planned = true;
+}
+
 void UFlareCompanyAI::Simulate()
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlareCompanyAI_Simulate);
+
+	// Use the plan of the day once, then plan again before the next day
+	bool UsePlan = Planned;
+	Planned = false;
+
 	if (Company == Game->GetPC()->GetCompany())
 	{
 		return;
@@ -115,26 +145,21 @@ void UFlareCompanyAI::Simulate()
 
 	// TODO IF AT LEAST ONE IDLE SHIP
 
-	TMap<UFlareSimulatedSector*, SectorVariation> WorldResourceVariation;
-
-	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	if (!UsePlan)
 	{
-		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
-
-
-		// Compute input and output ressource equation (ex: 100 + 10/ day)
-
-		// TODO, cache in sector for all company
-
-
-		SectorVariation Variation = ComputeSectorResourceVariation(Sector);
+		ComputeResourceVariations();
+	}
 
-		WorldResourceVariation.Add(Sector, Variation);
-		//DumpSectorResourceVariation(Sector, &Variation);
 
+	// Assign all the idle cargos at once, or search the best deal of each ship in turn
+	bool AuctionAssignment = Game->GetGameWorld()->IsAuctionCargoAssignment();
+	TArray<SectorDeal> AssignedDeals;
+	TMap<UFlareSimulatedSector*, SectorVariation> LiveVariations;
+	if (AuctionAssignment)
+	{
+		AssignCargosByAuction(IdleCargos, AssignedDeals);
 	}
 
-
 	for (int32 ShipIndex = 0 ; ShipIndex < IdleCargos.Num(); ShipIndex++)
 	{
 		UFlareSimulatedSpacecraft* Ship = IdleCargos[ShipIndex];
@@ -145,142 +170,17 @@ void UFlareCompanyAI::Simulate()
 		}
 	//	FLOGV("Search something to do for %s", *Ship->GetImmatriculation().ToString());
 
+		SectorDeal BestDeal = (AuctionAssignment ? AssignedDeals[ShipIndex] : FindBestDealForShip(Ship));
 
-		SectorDeal BestDeal;
-		BestDeal.BuyQuantity = 0;
-		BestDeal.MoneyBalanceParDay = 0;
-		BestDeal.Resource = NULL;
-		BestDeal.SectorA = NULL;
-		BestDeal.SectorB = NULL;
-
-
-		// Stay here option
-
-
-		for (int32 SectorAIndex = 0; SectorAIndex < Company->GetKnownSectors().Num(); SectorAIndex++)
+		// The plan saw the world before the companies simulated earlier today : search again while its deal is gone
+		while (UsePlan && BestDeal.Resource && !ValidatePlannedDeal(Ship, BestDeal, LiveVariations))
 		{
-			UFlareSimulatedSector* SectorA = Company->GetKnownSectors()[SectorAIndex];
-
-			SectorDeal SectorBestDeal;
-			SectorBestDeal.Resource = NULL;
-			SectorBestDeal.BuyQuantity = 0;
-			SectorBestDeal.MoneyBalanceParDay = 0;
-			SectorBestDeal.Resource = NULL;
-			SectorBestDeal.SectorA = NULL;
-			SectorBestDeal.SectorB = NULL;
-
-
-			while (true)
-			{
-				SectorBestDeal = FindBestDealForShipFromSector(Ship, SectorA, &BestDeal, &WorldResourceVariation);
-				if(!SectorBestDeal.Resource)
-				{
-					// No best deal found
-					break;
-				}
-
-				SectorVariation* SectorVariationA = &WorldResourceVariation[SectorA];
-				if(Ship->GetCurrentSector() != SectorA && SectorVariationA->IncomingCapacity > 0 && SectorBestDeal.BuyQuantity > 0)
-				{
-					//FLOGV("IncomingCapacity to %s = %d", *SectorA->GetSectorName().ToString(), SectorVariationA->IncomingCapacity);
-					int32 UsedIncomingCapacity = FMath::Min(SectorBestDeal.BuyQuantity, SectorVariationA->IncomingCapacity);
-
-					SectorVariationA->IncomingCapacity -= UsedIncomingCapacity;
-					struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[SectorBestDeal.Resource];
-					VariationA->OwnedStock -= UsedIncomingCapacity;
-				}
-				else
-				{
-					break;
-				}
-			}
-
-			if(SectorBestDeal.Resource)
-			{
-				BestDeal = SectorBestDeal;
-			}
+			BestDeal = FindBestDealForShip(Ship);
 		}
 
 		if(BestDeal.Resource)
 		{
-			FLOGV("Best balance for %s (%s) : %f credit per day", *Ship->GetImmatriculation().ToString(), *Ship->GetCurrentSector()->GetSectorName().ToString(), BestDeal.MoneyBalanceParDay/100);
-
-
-			FLOGV(" -> Transfert %s from %s to %s", *BestDeal.Resource->Name.ToString(), *BestDeal.SectorA->GetSectorName().ToString(), *BestDeal.SectorB->GetSectorName().ToString());
-			if (Ship->GetCurrentSector() == BestDeal.SectorA)
-			{
-				// Already in A, buy resources and go to B
-				SectorHelper::FlareTradeRequest Request;
-				Request.Resource = BestDeal.Resource;
-				Request.Operation = EFlareTradeRouteOperation::LoadOrBuy;
-				Request.Client = Ship;
-				Request.MaxQuantity = Ship->GetCargoBay()->GetFreeSpaceForResource(BestDeal.Resource);
-
-				UFlareSimulatedSpacecraft* StationCandidate = SectorHelper::FindTradeStation(Request);
-
-				uint32 BroughtResource = 0;
-				if(StationCandidate)
-				{
-					BroughtResource = SectorHelper::Trade(StationCandidate, Ship, BestDeal.Resource, Request.MaxQuantity);
-				}
-
-				// TODO reduce computed sector stock
-
-				FLOGV(" -> Buy %d / %d", BroughtResource, BestDeal.BuyQuantity);
-				if(BroughtResource == BestDeal.BuyQuantity)
-				{
-					// Virtualy decrease the stock for other ships in sector A
-					SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
-					struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
-					VariationA->OwnedStock -= BestDeal.BuyQuantity;
-
-
-					// Virtualy say some capacity arrive in sector B
-					SectorVariation* SectorVariationB = &WorldResourceVariation[BestDeal.SectorB];
-					SectorVariationB->IncomingCapacity += BestDeal.BuyQuantity;
-
-					// Virtualy decrease the capacity for other ships in sector B
-					struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[BestDeal.Resource];
-					VariationB->OwnedCapacity -= BestDeal.BuyQuantity;
-				}
-				else if(BroughtResource == 0)
-				{
-					// Fail to buy the promised resources, remove the deal from the list
-					SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
-					struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
-					VariationA->FactoryStock = 0;
-					VariationA->OwnedStock = 0;
-					VariationA->StorageStock = 0;
-					if(VariationA->OwnedFlow > 0)
-						VariationA->OwnedFlow = 0;
-					if(VariationA->FactoryFlow > 0)
-						VariationA->FactoryFlow = 0;
-
-					FLOG(" -> Buy Fail remove the deal from the list");
-				}
-			}
-			else
-			{
-				if (BestDeal.SectorA != Ship->GetCurrentSector())
-				{
-					Game->GetGameWorld()->StartTravel(Ship->GetCurrentFleet(), BestDeal.SectorA);
-					FLOGV(" -> Travel to %s", *BestDeal.SectorA->GetSectorName().ToString());
-				}
-				else
-				{
-					FLOGV(" -> Wait to %s", *BestDeal.SectorA->GetSectorName().ToString());
-				}
-
-				// Reserve the deal by virtualy decrease the stock for other ships
-				SectorVariation* SectorVariationA = &WorldResourceVariation[BestDeal.SectorA];
-				struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[BestDeal.Resource];
-				VariationA->OwnedStock -= BestDeal.BuyQuantity;
-
-				// Reserve the deal by virtualy decrease the capacity for other ships
-				SectorVariation* SectorVariationB = &WorldResourceVariation[BestDeal.SectorB];
-				struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[BestDeal.Resource];
-				VariationB->OwnedCapacity -= BestDeal.BuyQuantity;
-			}
+			ApplyDeal(Ship, BestDeal);
 		}
 		else
 		{
@@ -331,168 +231,15 @@ void UFlareCompanyAI::Simulate()
 	//TODO always keep money for production
 	// Acquire ship
 
-	TArray<UFlareSpacecraftCatalogEntry*>& StationCatalog = Game->GetSpacecraftCatalog()->StationCatalog;
-
-	TMap<FFlareResourceDescription*, int32> ResourceFlow = ComputeWorldResourceFlow();
-
 	// Build station
-
-
-
-
-
-	// Count factories for the company
-
-
-	// Compute rentability in each sector for each station
-	// Add weight if the company already have another station in this type
-
-	float CurrentConstructionScore = 0;
-	float BestScore = 0;
-	FFlareSpacecraftDescription* BestStationDescription = NULL;
-	UFlareSimulatedSector* BestSector = NULL;
-
-
-	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	if (!UsePlan)
 	{
-		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
-
-
-		for (int32 StationIndex = 0; StationIndex < StationCatalog.Num(); StationIndex++)
-		{
-			FFlareSpacecraftDescription* StationDescription = &StationCatalog[StationIndex]->Data;
-
-			// Check sector limitations
-			TArray<FText> Reasons;
-			if (!Sector->CanBuildStation(StationDescription, Company, Reasons, true))
-			{
-				continue;
-			}
-
-
-
-			for (int FactoryIndex = 0; FactoryIndex < StationDescription->Factories.Num(); FactoryIndex++)
-			{
-				FFlareFactoryDescription* FactoryDescription = &StationDescription->Factories[FactoryIndex]->Data;
-
-				bool Shipyard = false;
-
-				for (int32 Index = 0; Index < FactoryDescription->OutputActions.Num(); Index++)
-				{
-					if (FactoryDescription->OutputActions[Index].Action == EFlareFactoryAction::CreateShip)
-					{
-						Shipyard = true;
-						break;
-					}
-				}
-
-				if(Shipyard)
-				{
-					// TODO Shipyard case
-					continue;
-				}
-
-				float GainPerDay = 0;
-				float GainPerCycle = 0;
-
-				GainPerCycle -= Sector->GetStationConstructionFee(FactoryDescription->CycleCost.ProductionCost);
-
-				float Malus = 0;
-				float Bonus = 0;
-
-				for (int32 ResourceIndex = 0 ; ResourceIndex < FactoryDescription->CycleCost.InputResources.Num() ; ResourceIndex++)
-				{
-					const FFlareFactoryResource* Resource = &FactoryDescription->CycleCost.InputResources[ResourceIndex];
-					GainPerCycle -= Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::FactoryInput) * Resource->Quantity;
-
-					float NeededFlow = (float) Resource->Quantity / (float) FactoryDescription->CycleCost.ProductionTime;
-					//FLOGV("%s, %s: ResourceFlow = %d Flow needed = %f",
-					//	  *FactoryDescription->Name.ToString(),
-					//	  *Resource->Resource->Data.Name.ToString(),
-					//	  ResourceFlow[&Resource->Resource->Data] ,NeededFlow);
-					if(ResourceFlow[&Resource->Resource->Data] <= NeededFlow)
-					{
-						float DisponibilityMalus = (NeededFlow - (float) ResourceFlow[&Resource->Resource->Data]);
-						Malus += DisponibilityMalus;
-						//FLOGV("Factory %s as %f as malus for resource %s", *FactoryDescription->Name.ToString(), DisponibilityMalus, *Resource->Resource->Data.Name.ToString());
-
-					}
-
-				}
-
-				for (int32 ResourceIndex = 0 ; ResourceIndex < FactoryDescription->CycleCost.OutputResources.Num() ; ResourceIndex++)
-				{
-					const FFlareFactoryResource* Resource = &FactoryDescription->CycleCost.OutputResources[ResourceIndex];
-					GainPerCycle += Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::FactoryOutput) * Resource->Quantity;
-
-
-					float ProducedFlow = (float) Resource->Quantity / (float) FactoryDescription->CycleCost.ProductionTime;
-					//FLOGV("%s, %s: ResourceFlow = %d Flow produced = %f",
-					//	  *FactoryDescription->Name.ToString(),
-					//	  *Resource->Resource->Data.Name.ToString(),
-					//	  ResourceFlow[&Resource->Resource->Data] ,ProducedFlow);
-					if(ResourceFlow[&Resource->Resource->Data] <=  0)
-					{
-						float DisponibilityBonus = ProducedFlow - (float) ResourceFlow[&Resource->Resource->Data];
-						//FLOGV("Factory %s as %f as bonus for resource %s", *FactoryDescription->Name.ToString(), DisponibilityBonus, *Resource->Resource->Data.Name.ToString());
-						Bonus += DisponibilityBonus;
-					}
-
-				}
-
-				GainPerDay = GainPerCycle / FactoryDescription->CycleCost.ProductionTime;
-
-				//FLOGV("%s in %s GainPerDay=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), GainPerDay / 100);
-
-				// Price with station resources prices bonus
-				float StationPrice = STATION_CONSTRUCTION_PRICE_BONUS * UFlareGameTools::ComputeShipPrice(StationDescription->Identifier, Sector, true);
-				float DayToPayPrice = StationPrice / GainPerDay;
-				float MissingMoneyRatio = FMath::Min(1.0f, Company->GetMoney() / StationPrice);
-
-
-				//FLOGV("StationPrice=%f DayToPayPrice=%f", StationPrice, DayToPayPrice);
-
-
-
-				float Score =  (100.f / DayToPayPrice) * MissingMoneyRatio;
-
-				//FLOGV("%s in %s Score=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Score);
-				//FLOGV("         Bonus=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Bonus);
-				//FLOGV("         Malus=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Malus);
-
-
-				if(Bonus > 0)
-				{
-					Score *= Bonus;
-				}
-
-				if(Malus > 0)
-				{
-					Score /= Malus;
-				}
-
-				//FLOGV("         Final Score =%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Score);
-
-
-				if(ConstructionProjectSector == Sector && ConstructionProjectStation == StationDescription)
-				{
-					CurrentConstructionScore = Score;
-				}
-
-				if (GainPerDay > 0 && (!BestStationDescription || Score > BestScore))
-				{
-					//FLOGV("New Best : StationPrice=%f DayToPayPrice=%f", StationPrice, DayToPayPrice);
-					//FLOGV("           MissingMoneyRatio=%f Score=%f", MissingMoneyRatio, Score);
-
-
-					BestScore = Score;
-					BestStationDescription = StationDescription;
-					BestSector = Sector;
-				}
-			}
-		}
+		ComputeBestStation();
+	}
+	else
+	{
+		RescorePlannedStation();
 	}
-
 
 	if (BestSector && BestStationDescription)
 	{
@@ -921,7 +668,7 @@ void UFlareCompanyAI::ManagerConstructionShips(TMap<UFlareSimulatedSector*, Sect
 						FFlareResourceDescription* MissingResource = MissingResources[ResourceIndex];
 
 
-						struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[MissingResource];
+						struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[MissingResource->Index];
 
 						int32 Stock = Variation->FactoryStock + Variation->OwnedStock + Variation->StorageStock;
 
@@ -968,7 +715,7 @@ void UFlareCompanyAI::ManagerConstructionShips(TMap<UFlareSimulatedSector*, Sect
 							FFlareResourceDescription* MissingResource = MissingResources[ResourceIndex];
 
 
-							struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[MissingResource];
+							struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[MissingResource->Index];
 
 							int32 Flow = Variation->FactoryFlow + Variation->OwnedFlow;
 
@@ -1013,7 +760,7 @@ void UFlareCompanyAI::ManagerConstructionShips(TMap<UFlareSimulatedSector*, Sect
 					}
 					MissingResourcesQuantity[BestResource] -= FMath::Max(0, BestEstimateTake);
 					SectorVariation* SectorVariation = &WorldResourceVariation[BestSector];
-					struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[BestResource];
+					struct ResourceVariation* Variation = &SectorVariation->ResourceVariations[BestResource->Index];
 
 					Variation->OwnedStock -= FMath::Max(0, BestEstimateTake);
 				}
@@ -1025,161 +772,923 @@ void UFlareCompanyAI::ManagerConstructionShips(TMap<UFlareSimulatedSector*, Sect
 
 }
 
-SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat, TMap<UFlareSimulatedSector*, SectorVariation> *WorldResourceVariation)
+void UFlareCompanyAI::ComputeResourceVariations()
 {
-	SectorDeal BestDeal;
-	BestDeal.Resource = NULL;
-	BestDeal.BuyQuantity = 0;
-	BestDeal.MoneyBalanceParDay = DealToBeat->MoneyBalanceParDay;
-	BestDeal.Resource = NULL;
-	BestDeal.SectorA = NULL;
-	BestDeal.SectorB = NULL;
+	WorldResourceVariation.Empty(Company->GetKnownSectors().Num());
+	UFlareWorld* World = Game->GetGameWorld();
 
-	for (int32 SectorBIndex = 0; SectorBIndex < Company->GetKnownSectors().Num(); SectorBIndex++)
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
 	{
-		UFlareSimulatedSector* SectorB = Company->GetKnownSectors()[SectorBIndex];
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
 
-		int64 TravelTimeToA;
-		int64 TravelTimeToB;
 
-		if(SectorA == SectorB)
+		// Compute input and output ressource equation (ex: 100 + 10/ day)
+		// The world scan is shared by all companies, only the company overlay is computed here
+		SectorVariation Variation;
+		if (World->IsSharedResourceVariation())
 		{
-			// Stay in sector option
-			TravelTimeToA = 1;
-			TravelTimeToB = 0;
+			Variation = World->GetResourceVariationCache().GetSectorVariation(Sector, Company);
 		}
 		else
 		{
-			// Travel time
-			TravelTimeToA = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), Ship->GetCurrentSector(), SectorA);
-			TravelTimeToB = UFlareTravel::ComputeTravelDuration(Game->GetGameWorld(), SectorA, SectorB);
-
+			Variation = ComputeSectorResourceVariation(Sector);
 		}
-		int64 TravelTime = TravelTimeToA + TravelTimeToB;
-
 
-		SectorVariation* SectorVariationA = &(*WorldResourceVariation)[SectorA];
-		SectorVariation* SectorVariationB = &(*WorldResourceVariation)[SectorB];
-
-		for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
-		{
-			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-			struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Resource];
-			struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[Resource];
-
-			if(!VariationA->OwnedFlow &&
-					!VariationA->FactoryFlow &&
-					!VariationA->OwnedStock &&
-					!VariationA->FactoryStock &&
-					!VariationA->StorageStock &&
-					!VariationA->OwnedCapacity &&
-					!VariationA->FactoryCapacity &&
-					!VariationA->StorageCapacity &&
-					!VariationB->OwnedFlow &&
-					!VariationB->FactoryFlow &&
-					!VariationB->OwnedStock &&
-					!VariationB->FactoryStock &&
-					!VariationB->StorageStock &&
-					!VariationB->OwnedCapacity &&
-					!VariationB->FactoryCapacity &&
-					!VariationB->StorageCapacity)
-			{
-				continue;
-			}
+		WorldResourceVariation.Add(Sector, Variation);
+		//DumpSectorResourceVariation(Sector, &Variation);
 
+	}
 
-			int32 InitialQuantity = Ship->GetCargoBay()->GetResourceQuantity(Resource);
-			int32 FreeSpace = Ship->GetCargoBay()->GetFreeSpaceForResource(Resource);
+	ComputeDealIndex();
+}
 
-			int32 StockInAAfterTravel =
-					VariationA->OwnedStock
-					+ VariationA->FactoryStock
-					+ VariationA->StorageStock
-					- (VariationA->OwnedFlow * TravelTimeToA)
-					- (VariationA->FactoryFlow * TravelTimeToA);
+void UFlareCompanyAI::ComputeBestStation()
+{
+	TArray<UFlareSpacecraftCatalogEntry*>& StationCatalog = Game->GetSpacecraftCatalog()->StationCatalog;
 
-			if(StockInAAfterTravel <= 0 && InitialQuantity == 0)
-			{
-				continue;
-			}
+	TArray<int32> ResourceFlow = ComputeWorldResourceFlow();
 
-			int32 CanBuyQuantity = FMath::Min(FreeSpace, StockInAAfterTravel);
+	// Compute rentability in each sector for each station
+	// Add weight if the company already have another station in this type
 
-			// Affordable quantity
-			CanBuyQuantity =  FMath::Min(CanBuyQuantity, (int32) (Company->GetMoney() / SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput)));
+	CurrentConstructionScore = 0;
+	BestScore = 0;
+	BestStationDescription = NULL;
+	BestSector = NULL;
 
-			int32 CapacityInBAfterTravel =
-					VariationB->OwnedCapacity
-					+ VariationB->FactoryCapacity
-					+ VariationB->StorageCapacity
-					+ VariationB->OwnedFlow * TravelTime
-					+ VariationB->FactoryFlow * TravelTime
-					- VariationB->IncomingResources;
 
-			int32 SellQuantity = FMath::Min(CapacityInBAfterTravel, CanBuyQuantity + InitialQuantity);
-			int32  BuyQuantity = FMath::Max(0, SellQuantity - InitialQuantity);
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
 
-			// Use price details
 
-			int32 MoneyGain = 0;
-			int32 QuantityToSell = SellQuantity;
+		for (int32 StationIndex = 0; StationIndex < StationCatalog.Num(); StationIndex++)
+		{
+			FFlareSpacecraftDescription* StationDescription = &StationCatalog[StationIndex]->Data;
 
-			int32 OwnedCapacity = FMath::Max(0, (int32) (VariationB->OwnedCapacity + VariationB->OwnedFlow * TravelTime));
-			int32 FactoryCapacity = FMath::Max(0, (int32) (VariationB->FactoryCapacity + VariationB->FactoryFlow * TravelTime));
-			int32 StorageCapacity = VariationB->StorageCapacity;
+			// Check sector limitations
+			TArray<FText> Reasons;
+			if (!Sector->CanBuildStation(StationDescription, Company, Reasons, true))
+			{
+				continue;
+			}
 
-			int32 OwnedSellQuantity = FMath::Min(OwnedCapacity, QuantityToSell);
-			MoneyGain += OwnedSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 1.1; // Valorise transport to its own station
-			QuantityToSell -= OwnedSellQuantity;
 
-			int32 FactorySellQuantity = FMath::Min(FactoryCapacity, QuantityToSell);
-			MoneyGain += FactorySellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput);
-			QuantityToSell -= FactorySellQuantity;
 
-			int32 StorageSellQuantity = FMath::Min(StorageCapacity, QuantityToSell);
-			MoneyGain += StorageSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
-			QuantityToSell -= StorageSellQuantity;
+			for (int FactoryIndex = 0; FactoryIndex < StationDescription->Factories.Num(); FactoryIndex++)
+			{
+				FFlareFactoryDescription* FactoryDescription = &StationDescription->Factories[FactoryIndex]->Data;
 
-			int32 MoneySpend = 0;
-			int32 QuantityToBuy = BuyQuantity;
+				float GainPerDay = 0;
+				float Score = 0;
+				if (!ComputeFactoryScore(Sector, StationDescription, FactoryDescription, ResourceFlow, GainPerDay, Score))
+				{
+					// TODO Shipyard case
+					continue;
+				}
 
-			int32 OwnedStock = FMath::Max(0, (int32) (VariationA->OwnedStock - VariationA->OwnedFlow * TravelTimeToA));
-			int32 FactoryStock = FMath::Max(0, (int32) (VariationA->FactoryStock - VariationA->FactoryFlow * TravelTimeToA));
-			int32 StorageStock = VariationA->StorageStock;
+				if(ConstructionProjectSector == Sector && ConstructionProjectStation == StationDescription)
+				{
+					CurrentConstructionScore = Score;
+				}
 
+				if (GainPerDay > 0 && (!BestStationDescription || Score > BestScore))
+				{
+					//FLOGV("New Best : StationPrice=%f DayToPayPrice=%f", StationPrice, DayToPayPrice);
+					//FLOGV("           MissingMoneyRatio=%f Score=%f", MissingMoneyRatio, Score);
+
+
+					BestScore = Score;
+					BestStationDescription = StationDescription;
+					BestSector = Sector;
+				}
+			}
+		}
+	}
+}
+
+bool UFlareCompanyAI::ComputeFactoryScore(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription,
+	const TArray<int32>& ResourceFlow, float& OutGainPerDay, float& OutScore)
+{
+	OutGainPerDay = 0;
+	OutScore = 0;
+
+	bool Shipyard = false;
+
+	for (int32 Index = 0; Index < FactoryDescription->OutputActions.Num(); Index++)
+	{
+		if (FactoryDescription->OutputActions[Index].Action == EFlareFactoryAction::CreateShip)
+		{
+			Shipyard = true;
+			break;
+		}
+	}
+
+	if(Shipyard)
+	{
+		return false;
+	}
+
+	float GainPerCycle = 0;
+
+	GainPerCycle -= Sector->GetStationConstructionFee(FactoryDescription->CycleCost.ProductionCost);
+
+	float Malus = 0;
+	float Bonus = 0;
+
+	for (int32 ResourceIndex = 0 ; ResourceIndex < FactoryDescription->CycleCost.InputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &FactoryDescription->CycleCost.InputResources[ResourceIndex];
+		GainPerCycle -= Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::FactoryInput) * Resource->Quantity;
+
+		float NeededFlow = (float) Resource->Quantity / (float) FactoryDescription->CycleCost.ProductionTime;
+		//FLOGV("%s, %s: ResourceFlow = %d Flow needed = %f",
+		//	  *FactoryDescription->Name.ToString(),
+		//	  *Resource->Resource->Data.Name.ToString(),
+		//	  ResourceFlow[Resource->Resource->Data.Index] ,NeededFlow);
+		if(ResourceFlow[Resource->Resource->Data.Index] <= NeededFlow)
+		{
+			float DisponibilityMalus = (NeededFlow - (float) ResourceFlow[Resource->Resource->Data.Index]);
+			Malus += DisponibilityMalus;
+			//FLOGV("Factory %s as %f as malus for resource %s", *FactoryDescription->Name.ToString(), DisponibilityMalus, *Resource->Resource->Data.Name.ToString());
+
+		}
+
+	}
+
+	for (int32 ResourceIndex = 0 ; ResourceIndex < FactoryDescription->CycleCost.OutputResources.Num() ; ResourceIndex++)
+	{
+		const FFlareFactoryResource* Resource = &FactoryDescription->CycleCost.OutputResources[ResourceIndex];
+		GainPerCycle += Sector->GetResourcePrice(&Resource->Resource->Data, EFlareResourcePriceContext::FactoryOutput) * Resource->Quantity;
+
+
+		float ProducedFlow = (float) Resource->Quantity / (float) FactoryDescription->CycleCost.ProductionTime;
+		//FLOGV("%s, %s: ResourceFlow = %d Flow produced = %f",
+		//	  *FactoryDescription->Name.ToString(),
+		//	  *Resource->Resource->Data.Name.ToString(),
+		//	  ResourceFlow[Resource->Resource->Data.Index] ,ProducedFlow);
+		if(ResourceFlow[Resource->Resource->Data.Index] <=  0)
+		{
+			float DisponibilityBonus = ProducedFlow - (float) ResourceFlow[Resource->Resource->Data.Index];
+			//FLOGV("Factory %s as %f as bonus for resource %s", *FactoryDescription->Name.ToString(), DisponibilityBonus, *Resource->Resource->Data.Name.ToString());
+			Bonus += DisponibilityBonus;
+		}
+
+	}
+
+	OutGainPerDay = GainPerCycle / FactoryDescription->CycleCost.ProductionTime;
+
+	//FLOGV("%s in %s GainPerDay=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), GainPerDay / 100);
+
+	// Price with station resources prices bonus
+	float StationPrice = STATION_CONSTRUCTION_PRICE_BONUS * UFlareGameTools::ComputeShipPrice(StationDescription->Identifier, Sector, true);
+	float DayToPayPrice = StationPrice / OutGainPerDay;
+	float MissingMoneyRatio = FMath::Min(1.0f, Company->GetMoney() / StationPrice);
+
+
+	//FLOGV("StationPrice=%f DayToPayPrice=%f", StationPrice, DayToPayPrice);
+
+
+
+	OutScore =  (100.f / DayToPayPrice) * MissingMoneyRatio;
+
+	//FLOGV("%s in %s Score=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), OutScore);
+	//FLOGV("         Bonus=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Bonus);
+	//FLOGV("         Malus=%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), Malus);
+
+
+	if(Bonus > 0)
+	{
+		OutScore *= Bonus;
+	}
+
+	if(Malus > 0)
+	{
+		OutScore /= Malus;
+	}
+
+	//FLOGV("         Final Score =%f", *StationDescription->Name.ToString(), *Sector->GetSectorName().ToString(), OutScore);
+
+	return true;
+}
+
+SectorDeal UFlareCompanyAI::FindBestDealForShip(UFlareSimulatedSpacecraft* Ship)
+{
+	SectorDeal BestDeal;
+	BestDeal.BuyQuantity = 0;
+	BestDeal.MoneyBalanceParDay = 0;
+	BestDeal.Resource = NULL;
+	BestDeal.SectorA = NULL;
+	BestDeal.SectorB = NULL;
+
+
+	// Stay here option
+
+
+	for (int32 SectorAIndex = 0; SectorAIndex < Company->GetKnownSectors().Num(); SectorAIndex++)
+	{
+		UFlareSimulatedSector* SectorA = Company->GetKnownSectors()[SectorAIndex];
+
+		SectorDeal SectorBestDeal = FindBestDealForShipInSector(Ship, SectorA, &BestDeal);
+
+		if(SectorBestDeal.Resource)
+		{
+			BestDeal = SectorBestDeal;
+		}
+	}
+
+	return BestDeal;
+}
+
+SectorDeal UFlareCompanyAI::FindBestDealForShipInSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat)
+{
+	SectorDeal SectorBestDeal;
+	SectorBestDeal.Resource = NULL;
+	SectorBestDeal.BuyQuantity = 0;
+	SectorBestDeal.MoneyBalanceParDay = 0;
+	SectorBestDeal.SectorA = NULL;
+	SectorBestDeal.SectorB = NULL;
+
+	while (true)
+	{
+		SectorBestDeal = FindBestDealForShipFromSector(Ship, SectorA, DealToBeat, &WorldResourceVariation);
+		if(!SectorBestDeal.Resource)
+		{
+			// No best deal found
+			break;
+		}
+
+		// The cargos traveling to sector A take its stock first : search again without it
+		if (!ReserveIncomingCapacity(Ship, SectorBestDeal))
+		{
+			break;
+		}
+	}
+
+	return SectorBestDeal;
+}
+
+bool UFlareCompanyAI::ReserveIncomingCapacity(UFlareSimulatedSpacecraft* Ship, const SectorDeal& Deal)
+{
+	SectorVariation* SectorVariationA = &WorldResourceVariation[Deal.SectorA];
+	if(Ship->GetCurrentSector() == Deal.SectorA || SectorVariationA->IncomingCapacity <= 0 || Deal.BuyQuantity <= 0)
+	{
+		return false;
+	}
+
+	//FLOGV("IncomingCapacity to %s = %d", *Deal.SectorA->GetSectorName().ToString(), SectorVariationA->IncomingCapacity);
+	int32 UsedIncomingCapacity = FMath::Min(Deal.BuyQuantity, SectorVariationA->IncomingCapacity);
+
+	SectorVariationA->IncomingCapacity -= UsedIncomingCapacity;
+	struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Deal.Resource->Index];
+	VariationA->OwnedStock -= UsedIncomingCapacity;
+
+	return true;
+}
+
+void UFlareCompanyAI::ReserveDeal(const SectorDeal& Deal, bool Loaded)
+{
+	// Virtualy decrease the stock for other ships in sector A
+	SectorVariation* SectorVariationA = &WorldResourceVariation[Deal.SectorA];
+	struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Deal.Resource->Index];
+	VariationA->OwnedStock -= Deal.BuyQuantity;
+
+	// Virtualy decrease the capacity for other ships in sector B
+	SectorVariation* SectorVariationB = &WorldResourceVariation[Deal.SectorB];
+	struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[Deal.Resource->Index];
+	VariationB->OwnedCapacity -= Deal.BuyQuantity;
+
+	// Virtualy say some capacity arrive in sector B
+	if (Loaded)
+	{
+		SectorVariationB->IncomingCapacity += Deal.BuyQuantity;
+	}
+}
+
+void UFlareCompanyAI::ApplyDeal(UFlareSimulatedSpacecraft* Ship, const SectorDeal& BestDeal)
+{
+	FLOGV("Best balance for %s (%s) : %f credit per day", *Ship->GetImmatriculation().ToString(), *Ship->GetCurrentSector()->GetSectorName().ToString(), BestDeal.MoneyBalanceParDay/100);
+
+
+	FLOGV(" -> Transfert %s from %s to %s", *BestDeal.Resource->Name.ToString(), *BestDeal.SectorA->GetSectorName().ToString(), *BestDeal.SectorB->GetSectorName().ToString());
+	if (Ship->GetCurrentSector() == BestDeal.SectorA)
+	{
+		// Already in A, buy resources and go to B
+		SectorHelper::FlareTradeRequest Request;
+		Request.Resource = BestDeal.Resource;
+		Request.Operation = EFlareTradeRouteOperation::LoadOrBuy;
+		Request.Client = Ship;
+		Request.MaxQuantity = Ship->GetCargoBay()->GetFreeSpaceForResource(BestDeal.Resource);
 
-			int32 OwnedBuyQuantity = FMath::Min(OwnedStock, QuantityToBuy);
-			MoneySpend += OwnedBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 0.9; // Valorise buy to self
-			QuantityToBuy -= OwnedBuyQuantity;
+		UFlareSimulatedSpacecraft* StationCandidate = SectorHelper::FindTradeStation(Request);
 
-			int32 FactoryBuyQuantity = FMath::Min(FactoryStock, QuantityToBuy);
-			MoneySpend += FactoryBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryOutput);
-			QuantityToBuy -= FactoryBuyQuantity;
+		uint32 BroughtResource = 0;
+		if(StationCandidate)
+		{
+			BroughtResource = SectorHelper::Trade(StationCandidate, Ship, BestDeal.Resource, Request.MaxQuantity);
+		}
+
+		// TODO reduce computed sector stock
+
+		FLOGV(" -> Buy %d / %d", BroughtResource, BestDeal.BuyQuantity);
+		if(BroughtResource == BestDeal.BuyQuantity)
+		{
+			ReserveDeal(BestDeal, true);
+		}
+		else if(BroughtResource == 0)
+		{
+			// Fail to buy the promised resources, remove the deal from the list
+			RemoveDealStock(BestDeal.SectorA, BestDeal.Resource);
+
+			FLOG(" -> Buy Fail remove the deal from the list");
+		}
+	}
+	else
+	{
+		if (BestDeal.SectorA != Ship->GetCurrentSector())
+		{
+			Game->GetGameWorld()->StartTravel(Ship->GetCurrentFleet(), BestDeal.SectorA);
+			FLOGV(" -> Travel to %s", *BestDeal.SectorA->GetSectorName().ToString());
+		}
+		else
+		{
+			FLOGV(" -> Wait to %s", *BestDeal.SectorA->GetSectorName().ToString());
+		}
+
+		// Reserve the deal for other ships
+		ReserveDeal(BestDeal, false);
+	}
+}
+
+bool UFlareCompanyAI::ValidatePlannedDeal(UFlareSimulatedSpacecraft* Ship, const SectorDeal& Deal, TMap<UFlareSimulatedSector*, SectorVariation>& LiveVariations)
+{
+	if (!LiveVariations.Contains(Deal.SectorA))
+	{
+		LiveVariations.Add(Deal.SectorA, ComputeSectorResourceVariation(Deal.SectorA));
+	}
+	if (!LiveVariations.Contains(Deal.SectorB))
+	{
+		LiveVariations.Add(Deal.SectorB, ComputeSectorResourceVariation(Deal.SectorB));
+	}
+
+	int64 TravelTimeToA = 1;
+	int64 TravelTime = 1;
+	if (Deal.SectorA != Deal.SectorB)
+	{
+		TravelTimeToA = Game->GetGameWorld()->GetTravelDuration(Ship->GetCurrentSector(), Deal.SectorA);
+		TravelTime = TravelTimeToA + Game->GetGameWorld()->GetTravelDuration(Deal.SectorA, Deal.SectorB);
+	}
+
+	// Same balance as the deal search, on the current prices and stations
+	int32 BuyQuantity = 0;
+	float MoneyBalanceParDay = ComputeDealBalance(Ship, Deal.SectorA, Deal.SectorB, Deal.Resource,
+		&LiveVariations[Deal.SectorA].ResourceVariations[Deal.Resource->Index],
+		&LiveVariations[Deal.SectorB].ResourceVariations[Deal.Resource->Index],
+		TravelTimeToA, TravelTime, BuyQuantity);
+
+	if (MoneyBalanceParDay > 0 && (BuyQuantity > 0 || Deal.BuyQuantity == 0))
+	{
+		return true;
+	}
+
+	FLOGV("%s planned deal of %s from %s to %s is gone", *Ship->GetImmatriculation().ToString(), *Deal.Resource->Name.ToString(),
+		*Deal.SectorA->GetSectorName().ToString(), *Deal.SectorB->GetSectorName().ToString());
+
+	if (Deal.BuyQuantity > 0 && BuyQuantity == 0)
+	{
+		RemoveDealStock(Deal.SectorA, Deal.Resource);
+	}
+	else
+	{
+		RemoveDealCapacity(Deal.SectorB, Deal.Resource);
+	}
+
+	return false;
+}
 
-			int32 StorageBuyQuantity = FMath::Min(StorageStock, QuantityToBuy);
-			MoneySpend += StorageBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
-			QuantityToBuy -= StorageBuyQuantity;
+void UFlareCompanyAI::RemoveDealStock(UFlareSimulatedSector* Sector, FFlareResourceDescription* Resource)
+{
+	struct ResourceVariation* Variation = &WorldResourceVariation[Sector].ResourceVariations[Resource->Index];
+	Variation->FactoryStock = 0;
+	Variation->OwnedStock = 0;
+	Variation->StorageStock = 0;
+	if(Variation->OwnedFlow > 0)
+		Variation->OwnedFlow = 0;
+	if(Variation->FactoryFlow > 0)
+		Variation->FactoryFlow = 0;
+}
 
+void UFlareCompanyAI::RemoveDealCapacity(UFlareSimulatedSector* Sector, FFlareResourceDescription* Resource)
+{
+	struct ResourceVariation* Variation = &WorldResourceVariation[Sector].ResourceVariations[Resource->Index];
+	Variation->FactoryCapacity = 0;
+	Variation->OwnedCapacity = 0;
+	Variation->StorageCapacity = 0;
+	if(Variation->OwnedFlow > 0)
+		Variation->OwnedFlow = 0;
+	if(Variation->FactoryFlow > 0)
+		Variation->FactoryFlow = 0;
+}
 
-			// Station construction incitation
-			/*if (SectorB == ConstructionProjectSector)
+void UFlareCompanyAI::RescorePlannedStation()
+{
+	TArray<int32> ResourceFlow = ComputeWorldResourceFlow();
+	TArray<FText> Reasons;
+
+	// Same scores as ComputeBestStation, for the current project and the planned station only
+	CurrentConstructionScore = 0;
+	if (ConstructionProjectSector && ConstructionProjectStation && ConstructionProjectSector->CanBuildStation(ConstructionProjectStation, Company, Reasons, true))
+	{
+		for (int FactoryIndex = 0; FactoryIndex < ConstructionProjectStation->Factories.Num(); FactoryIndex++)
+		{
+			float GainPerDay = 0;
+			float Score = 0;
+			if (ComputeFactoryScore(ConstructionProjectSector, ConstructionProjectStation, &ConstructionProjectStation->Factories[FactoryIndex]->Data, ResourceFlow, GainPerDay, Score))
 			{
-				for (int ConstructionResourceIndex = 0; ConstructionResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ConstructionResourceIndex++)
+				CurrentConstructionScore = Score;
+			}
+		}
+	}
+
+	if (!BestSector || !BestStationDescription)
+	{
+		return;
+	}
+
+	bool Profitable = false;
+	if (BestSector->CanBuildStation(BestStationDescription, Company, Reasons, true))
+	{
+		for (int FactoryIndex = 0; FactoryIndex < BestStationDescription->Factories.Num(); FactoryIndex++)
+		{
+			float GainPerDay = 0;
+			float Score = 0;
+			if (ComputeFactoryScore(BestSector, BestStationDescription, &BestStationDescription->Factories[FactoryIndex]->Data, ResourceFlow, GainPerDay, Score)
+				&& GainPerDay > 0 && (!Profitable || Score > BestScore))
+			{
+				BestScore = Score;
+				Profitable = true;
+			}
+		}
+	}
+
+	if (!Profitable)
+	{
+		FLOGV("%s drops the planned %s in %s", *Company->GetCompanyName().ToString(), *BestStationDescription->Name.ToString(), *BestSector->GetSectorName().ToString());
+		BestScore = 0;
+		BestStationDescription = NULL;
+		BestSector = NULL;
+	}
+}
+
+void UFlareCompanyAI::AssignCargosByAuction(const TArray<UFlareSimulatedSpacecraft*>& Ships, TArray<SectorDeal>& OutDeals)
+{
+	SectorDeal NoDeal;
+	NoDeal.Resource = NULL;
+	NoDeal.BuyQuantity = 0;
+	NoDeal.MoneyBalanceParDay = 0;
+	NoDeal.SectorA = NULL;
+	NoDeal.SectorB = NULL;
+
+	OutDeals.Init(NoDeal, Ships.Num());
+
+	// Gather the best deal from each known sector once for all the ships with the same cargo in the same sector.
+	// The search leaves the variations untouched : only the assigned deals reserve stock and capacity
+	int32 SectorCount = Game->GetGameWorld()->GetSectors().Num();
+	int32 ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+	TMap<int32, int32> DealSlots;
+	TArray<TArray<CargoDealCandidate>> ShipCandidates;
+	ShipCandidates.SetNum(Ships.Num());
+
+	// Quantity and free space by resource, and candidate deals, by cargo profile
+	TMap<UFlareSimulatedSector*, TArray<int32>> SectorProfiles;
+	TArray<TArray<uint32>> ProfileCargos;
+	TArray<TArray<CargoDealCandidate>> ProfileCandidates;
+
+	// First deal found, largest quantities bought and sold by a ship and number of bidders, by deal slot
+	TArray<SectorDeal> SlotDeals;
+	TArray<int32> DealBuyQuantities;
+	TArray<int32> DealSellQuantities;
+	TArray<int32> DealCapacities;
+
+	for (int32 ShipIndex = 0 ; ShipIndex < Ships.Num(); ShipIndex++)
+	{
+		UFlareSimulatedSpacecraft* Ship = Ships[ShipIndex];
+
+		if(Ship->IsTrading())
+		{
+			continue;
+		}
+
+		TArray<uint32> Cargo;
+		for(int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+			Cargo.Add(Ship->GetCargoBay()->GetResourceQuantity(Resource));
+			Cargo.Add(Ship->GetCargoBay()->GetFreeSpaceForResource(Resource));
+		}
+
+		TArray<int32>& Profiles = SectorProfiles.FindOrAdd(Ship->GetCurrentSector());
+		int32 Profile = -1;
+		for (int32 ProfileIndex = 0; ProfileIndex < Profiles.Num(); ProfileIndex++)
+		{
+			if (ProfileCargos[Profiles[ProfileIndex]] == Cargo)
+			{
+				Profile = Profiles[ProfileIndex];
+				break;
+			}
+		}
+
+		if (Profile < 0)
+		{
+			Profile = ProfileCargos.Add(Cargo);
+			Profiles.Add(Profile);
+			TArray<CargoDealCandidate>& Candidates = ProfileCandidates[ProfileCandidates.AddDefaulted()];
+
+			for (int32 SectorAIndex = 0; SectorAIndex < Company->GetKnownSectors().Num(); SectorAIndex++)
+			{
+				SectorDeal Deal = FindBestDealForShipFromSector(Ship, Company->GetKnownSectors()[SectorAIndex], &NoDeal, &WorldResourceVariation);
+				if (!Deal.Resource)
 				{
-					FFlareFactoryResource* ConstructionResource = &ConstructionProjectStation->CycleCost.InputResources[ConstructionResourceIndex];
+					continue;
+				}
 
-					if (Resource == &ConstructionResource->Resource->Data)
-					{
-						MoneyGain *= STATION_CONSTRUCTION_PRICE_BONUS;
-						break;
-					}
+				// Ships bidding on the same sectors and resource compete for the same deal
+				int32 DealKey = (Deal.SectorA->GetSectorSlot() * SectorCount + Deal.SectorB->GetSectorSlot()) * ResourceCount + Deal.Resource->Index;
+				int32* DealSlot = DealSlots.Find(DealKey);
+
+				CargoDealCandidate Candidate;
+				Candidate.DealSlot = (DealSlot ? *DealSlot : DealSlots.Add(DealKey, DealSlots.Num()));
+				Candidate.Deal = Deal;
+				Candidates.Add(Candidate);
+
+				if (!DealSlot)
+				{
+					SlotDeals.Add(Deal);
+					DealBuyQuantities.Add(0);
+					DealSellQuantities.Add(0);
+					DealCapacities.Add(0);
 				}
-			}*/
+			}
+		}
 
-			int32 MoneyBalance = MoneyGain - MoneySpend;
+		ShipCandidates[ShipIndex] = ProfileCandidates[Profile];
 
-			float MoneyBalanceParDay = (float) MoneyBalance / (float) TravelTime;
+		for (int32 CandidateIndex = 0; CandidateIndex < ShipCandidates[ShipIndex].Num(); CandidateIndex++)
+		{
+			const CargoDealCandidate& Candidate = ShipCandidates[ShipIndex][CandidateIndex];
+			int32 SellQuantity = Candidate.Deal.BuyQuantity + Ship->GetCargoBay()->GetResourceQuantity(Candidate.Deal.Resource);
+			DealBuyQuantities[Candidate.DealSlot] = FMath::Max(DealBuyQuantities[Candidate.DealSlot], Candidate.Deal.BuyQuantity);
+			DealSellQuantities[Candidate.DealSlot] = FMath::Max(DealSellQuantities[Candidate.DealSlot], SellQuantity);
+			DealCapacities[Candidate.DealSlot]++;
+		}
+	}
 
+	// A deal takes as many ships as the stock in A and the capacity in B can serve, at least one
+	for (int32 Slot = 0; Slot < SlotDeals.Num(); Slot++)
+	{
+		const SectorDeal& Deal = SlotDeals[Slot];
+		const struct ResourceVariation& VariationA = WorldResourceVariation[Deal.SectorA].ResourceVariations[Deal.Resource->Index];
+		const struct ResourceVariation& VariationB = WorldResourceVariation[Deal.SectorB].ResourceVariations[Deal.Resource->Index];
+		int32 StockInA = VariationA.OwnedStock + VariationA.FactoryStock + VariationA.StorageStock;
+		int32 CapacityInB = VariationB.OwnedCapacity + VariationB.FactoryCapacity + VariationB.StorageCapacity - VariationB.IncomingResources;
+
+		if (DealBuyQuantities[Slot] > 0)
+		{
+			DealCapacities[Slot] = FMath::Min(DealCapacities[Slot], StockInA / DealBuyQuantities[Slot]);
+		}
+		if (DealSellQuantities[Slot] > 0)
+		{
+			DealCapacities[Slot] = FMath::Min(DealCapacities[Slot], CapacityInB / DealSellQuantities[Slot]);
+		}
+		DealCapacities[Slot] = FMath::Max(DealCapacities[Slot], 1);
+	}
+
+	TArray<int32> Assignments;
+	SolveCargoAuction(ShipCandidates, DealCapacities, Assignments);
+
+	for (int32 ShipIndex = 0 ; ShipIndex < Ships.Num(); ShipIndex++)
+	{
+		if (Assignments[ShipIndex] >= 0)
+		{
+			OutDeals[ShipIndex] = ShipCandidates[ShipIndex][Assignments[ShipIndex]].Deal;
+			ReserveIncomingCapacity(Ships[ShipIndex], OutDeals[ShipIndex]);
+		}
+	}
+
+	FLOGV("%s assigned %d idle cargos with %d cargo profiles to %d deals", *Company->GetCompanyName().ToString(), Ships.Num(), ProfileCargos.Num(), DealSlots.Num());
+}
+
+void UFlareCompanyAI::PlanCargoAssignment(bool Auction, TArray<UFlareSimulatedSpacecraft*>& OutShips, TArray<SectorDeal>& OutDeals)
+{
+	OutShips.Empty();
+	OutDeals.Empty();
+
+	if (!Planned)
+	{
+		return;
+	}
+
+	TMap<UFlareSimulatedSector*, SectorVariation> PlannedVariations = WorldResourceVariation;
+	OutShips = FindIdleCargos();
+
+	if (Auction)
+	{
+		AssignCargosByAuction(OutShips, OutDeals);
+	}
+	else
+	{
+		SectorDeal NoDeal;
+		NoDeal.Resource = NULL;
+		NoDeal.BuyQuantity = 0;
+		NoDeal.MoneyBalanceParDay = 0;
+		NoDeal.SectorA = NULL;
+		NoDeal.SectorB = NULL;
+		OutDeals.Init(NoDeal, OutShips.Num());
+	}
+
+	// Same searches and reservations as Simulate, the trade of a ship in sector A is assumed to succeed
+	for (int32 ShipIndex = 0 ; ShipIndex < OutShips.Num(); ShipIndex++)
+	{
+		UFlareSimulatedSpacecraft* Ship = OutShips[ShipIndex];
+
+		if(Ship->IsTrading())
+		{
+			continue;
+		}
+
+		if (!Auction)
+		{
+			OutDeals[ShipIndex] = FindBestDealForShip(Ship);
+		}
+
+		if (OutDeals[ShipIndex].Resource)
+		{
+			ReserveDeal(OutDeals[ShipIndex], Ship->GetCurrentSector() == OutDeals[ShipIndex].SectorA);
+		}
+	}
+
+	WorldResourceVariation = PlannedVariations;
+}
+
+void UFlareCompanyAI::SolveCargoAuction(const TArray<TArray<CargoDealCandidate>>& ShipCandidates, const TArray<int32>& DealCapacities, TArray<int32>& OutAssignments)
+{
+	OutAssignments.Init(-1, ShipCandidates.Num());
+
+	// Each deal is sold as one unit per ship it can take, the units of deal N start at UnitStarts[N]
+	TArray<int32> UnitStarts;
+	int32 UnitCount = 0;
+	for (int32 DealSlot = 0; DealSlot < DealCapacities.Num(); DealSlot++)
+	{
+		UnitStarts.Add(UnitCount);
+		UnitCount += FMath::Max(DealCapacities[DealSlot], 0);
+	}
+	UnitStarts.Add(UnitCount);
+
+	TArray<float> UnitPrices;
+	TArray<int32> UnitOwners;
+	UnitPrices.SetNumZeroed(UnitCount);
+	UnitOwners.Init(-1, UnitCount);
+
+	// Prices rise by at least Epsilon at each bid : the auction ends, within Epsilon per ship of the best assignment
+	float MaxBalance = 0;
+	TArray<int32> Bidders;
+	for (int32 ShipIndex = 0; ShipIndex < ShipCandidates.Num(); ShipIndex++)
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < ShipCandidates[ShipIndex].Num(); CandidateIndex++)
+		{
+			MaxBalance = FMath::Max(MaxBalance, ShipCandidates[ShipIndex][CandidateIndex].Deal.MoneyBalanceParDay);
+		}
+
+		if (ShipCandidates[ShipIndex].Num())
+		{
+			Bidders.Add(ShipIndex);
+		}
+	}
+
+	float Epsilon = MaxBalance * CARGO_AUCTION_EPSILON;
+	if (Epsilon <= 0)
+	{
+		return;
+	}
+
+	// Outbid ships bid again after the waiting ones, in a fixed order
+	for (int32 BidderIndex = 0; BidderIndex < Bidders.Num(); BidderIndex++)
+	{
+		int32 ShipIndex = Bidders[BidderIndex];
+		const TArray<CargoDealCandidate>& Candidates = ShipCandidates[ShipIndex];
+
+		// Staying idle is worth nothing
+		int32 BestCandidate = -1;
+		int32 BestUnit = -1;
+		float BestValue = 0;
+		float SecondValue = 0;
+
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+		{
+			int32 DealSlot = Candidates[CandidateIndex].DealSlot;
+
+			// Cheapest and second cheapest units of the deal, the first one on equal prices
+			int32 CheapestUnit = -1;
+			int32 SecondCheapestUnit = -1;
+			for (int32 Unit = UnitStarts[DealSlot]; Unit < UnitStarts[DealSlot + 1]; Unit++)
+			{
+				if (CheapestUnit < 0 || UnitPrices[Unit] < UnitPrices[CheapestUnit])
+				{
+					SecondCheapestUnit = CheapestUnit;
+					CheapestUnit = Unit;
+				}
+				else if (SecondCheapestUnit < 0 || UnitPrices[Unit] < UnitPrices[SecondCheapestUnit])
+				{
+					SecondCheapestUnit = Unit;
+				}
+			}
+
+			if (CheapestUnit < 0)
+			{
+				continue;
+			}
+
+			float Value = Candidates[CandidateIndex].Deal.MoneyBalanceParDay - UnitPrices[CheapestUnit];
+			if (Value > BestValue)
+			{
+				SecondValue = BestValue;
+				BestValue = Value;
+				BestCandidate = CandidateIndex;
+				BestUnit = CheapestUnit;
+			}
+			else if (Value > SecondValue)
+			{
+				SecondValue = Value;
+			}
+
+			// The other units of the same deal are other choices for this ship
+			if (SecondCheapestUnit >= 0)
+			{
+				SecondValue = FMath::Max(SecondValue, Candidates[CandidateIndex].Deal.MoneyBalanceParDay - UnitPrices[SecondCheapestUnit]);
+			}
+		}
+
+		if (BestCandidate < 0)
+		{
+			continue;
+		}
+
+		UnitPrices[BestUnit] += BestValue - SecondValue + Epsilon;
+
+		int32 PreviousOwner = UnitOwners[BestUnit];
+		if (PreviousOwner >= 0)
+		{
+			OutAssignments[PreviousOwner] = -1;
+			Bidders.Add(PreviousOwner);
+		}
+
+		UnitOwners[BestUnit] = ShipIndex;
+		OutAssignments[ShipIndex] = BestCandidate;
+	}
+}
+
+void UFlareCompanyAI::SolveCargoGreedy(const TArray<TArray<CargoDealCandidate>>& ShipCandidates, const TArray<int32>& DealCapacities, TArray<int32>& OutAssignments)
+{
+	OutAssignments.Init(-1, ShipCandidates.Num());
+
+	TArray<int32> RemainingCapacities = DealCapacities;
+	for (int32 ShipIndex = 0; ShipIndex < ShipCandidates.Num(); ShipIndex++)
+	{
+		const TArray<CargoDealCandidate>& Candidates = ShipCandidates[ShipIndex];
+		float BestValue = 0;
+
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
+		{
+			if (RemainingCapacities[Candidates[CandidateIndex].DealSlot] > 0 && Candidates[CandidateIndex].Deal.MoneyBalanceParDay > BestValue)
+			{
+				BestValue = Candidates[CandidateIndex].Deal.MoneyBalanceParDay;
+				OutAssignments[ShipIndex] = CandidateIndex;
+			}
+		}
+
+		if (OutAssignments[ShipIndex] >= 0)
+		{
+			RemainingCapacities[Candidates[OutAssignments[ShipIndex]].DealSlot]--;
+		}
+	}
+}
+
+void UFlareCompanyAI::ComputeDealIndex()
+{
+	int32 SectorCount = Game->GetGameWorld()->GetSectors().Num();
+	SellDeals.ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+	SellDeals.SellPrices.Empty(SectorCount * SellDeals.ResourceCount);
+	SellDeals.SellPrices.SetNumZeroed(SectorCount * SellDeals.ResourceCount);
+	SellDeals.SectorSellPrices.Empty(SectorCount);
+	SellDeals.SectorSellPrices.SetNumZeroed(SectorCount);
+	SellDeals.ResourceSellPrices.Empty(SellDeals.ResourceCount);
+	SellDeals.ResourceSellPrices.SetNumZeroed(SellDeals.ResourceCount);
+
+	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Company->GetKnownSectors()[SectorIndex];
+		int32 SectorSlot = Sector->GetSectorSlot();
+		if (SectorSlot < 0)
+		{
+			continue;
+		}
+
+		for(int32 ResourceIndex = 0; ResourceIndex < SellDeals.ResourceCount; ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+
+			// Own stations are valued 10% over the default price, see FindBestDealForShipFromSector
+			float SellPrice = FMath::Max(Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 1.1f,
+				(float) Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
+
+			SellDeals.SellPrices[SectorSlot * SellDeals.ResourceCount + Resource->Index] = SellPrice;
+			SellDeals.SectorSellPrices[SectorSlot] = FMath::Max(SellDeals.SectorSellPrices[SectorSlot], SellPrice);
+			SellDeals.ResourceSellPrices[Resource->Index] = FMath::Max(SellDeals.ResourceSellPrices[Resource->Index], SellPrice);
+		}
+	}
+}
+
+SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat, TMap<UFlareSimulatedSector*, SectorVariation> *WorldResourceVariation)
+{
+	SectorDeal BestDeal;
+	BestDeal.Resource = NULL;
+	BestDeal.BuyQuantity = 0;
+	BestDeal.MoneyBalanceParDay = DealToBeat->MoneyBalanceParDay;
+	BestDeal.Resource = NULL;
+	BestDeal.SectorA = NULL;
+	BestDeal.SectorB = NULL;
+
+	// A deal never sells more than the ship can carry, at the best sell price, in less than a day :
+	// skip the sectors and resources whose best gain can't beat the best deal
+	bool PrunedSearch = Game->GetGameWorld()->IsPrunedDealSearch();
+	TArray<int32> ShipQuantities;
+	int32 MaxShipQuantity = 0;
+	float MaxDealGain = 0;
+
+	if (PrunedSearch)
+	{
+		ShipQuantities.SetNumZeroed(SellDeals.ResourceCount);
+		for(int32 ResourceIndex = 0; ResourceIndex < SellDeals.ResourceCount; ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+			int32 ShipQuantity = Ship->GetCargoBay()->GetResourceQuantity(Resource) + Ship->GetCargoBay()->GetFreeSpaceForResource(Resource);
+
+			ShipQuantities[Resource->Index] = ShipQuantity;
+			MaxShipQuantity = FMath::Max(MaxShipQuantity, ShipQuantity);
+			MaxDealGain = FMath::Max(MaxDealGain, ShipQuantity * SellDeals.ResourceSellPrices[Resource->Index]);
+		}
+
+		if (MaxDealGain * DEAL_BOUND_MARGIN <= BestDeal.MoneyBalanceParDay)
+		{
+			return BestDeal;
+		}
+	}
+
+	for (int32 SectorBIndex = 0; SectorBIndex < Company->GetKnownSectors().Num(); SectorBIndex++)
+	{
+		UFlareSimulatedSector* SectorB = Company->GetKnownSectors()[SectorBIndex];
+		int32 SectorBSlot = SectorB->GetSectorSlot();
+		bool PrunedSectorB = PrunedSearch && SectorBSlot >= 0;
+
+		int64 TravelTimeToA;
+		int64 TravelTimeToB;
+
+		if(SectorA == SectorB)
+		{
+			// Stay in sector option
+			TravelTimeToA = 1;
+			TravelTimeToB = 0;
+		}
+		else
+		{
+			// Travel time
+			TravelTimeToA = Game->GetGameWorld()->GetTravelDuration(Ship->GetCurrentSector(), SectorA);
+			TravelTimeToB = Game->GetGameWorld()->GetTravelDuration(SectorA, SectorB);
+
+		}
+		int64 TravelTime = TravelTimeToA + TravelTimeToB;
+
+		if (PrunedSectorB && MaxShipQuantity * SellDeals.SectorSellPrices[SectorBSlot] * DEAL_BOUND_MARGIN / TravelTime <= BestDeal.MoneyBalanceParDay)
+		{
+			continue;
+		}
+
+		SectorVariation* SectorVariationA = &(*WorldResourceVariation)[SectorA];
+		SectorVariation* SectorVariationB = &(*WorldResourceVariation)[SectorB];
+
+		for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+			struct ResourceVariation* VariationA = &SectorVariationA->ResourceVariations[Resource->Index];
+			struct ResourceVariation* VariationB = &SectorVariationB->ResourceVariations[Resource->Index];
+
+			if (PrunedSectorB && ShipQuantities[Resource->Index] * SellDeals.SellPrices[SectorBSlot * SellDeals.ResourceCount + Resource->Index] * DEAL_BOUND_MARGIN / TravelTime <= BestDeal.MoneyBalanceParDay)
+			{
+				continue;
+			}
+
+			int32 BuyQuantity = 0;
+			float MoneyBalanceParDay = ComputeDealBalance(Ship, SectorA, SectorB, Resource, VariationA, VariationB, TravelTimeToA, TravelTime, BuyQuantity);
 
 			if(MoneyBalanceParDay > BestDeal.MoneyBalanceParDay)
 			{
@@ -1195,20 +1704,7 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 
 				FLOGV("New Best Resource %s", *Resource->Name.ToString())
 
-				FLOGV(" -> IncomingCapacity=%u", SectorVariationA->IncomingCapacity);
-				FLOGV(" -> IncomingResources=%u", VariationA->IncomingResources);
-				FLOGV(" -> InitialQuantity=%u", InitialQuantity);
-				FLOGV(" -> FreeSpace=%u", FreeSpace);
-				FLOGV(" -> StockInAAfterTravel=%u", StockInAAfterTravel);
 				FLOGV(" -> BuyQuantity=%u", BuyQuantity);
-				FLOGV(" -> CapacityInBAfterTravel=%u", CapacityInBAfterTravel);
-				FLOGV(" -> SellQuantity=%u", SellQuantity);
-				FLOGV(" -> MoneyGain=%d", MoneyGain);
-				FLOGV(" -> MoneySpend=%d", MoneySpend);
-				FLOGV("   -> OwnedBuyQuantity=%d", OwnedBuyQuantity);
-				FLOGV("   -> FactoryBuyQuantity=%d", FactoryBuyQuantity);
-				FLOGV("   -> StorageBuyQuantity=%d", StorageBuyQuantity);
-				FLOGV(" -> MoneyBalance=%d", MoneyBalance);
 				FLOGV(" -> MoneyBalanceParDay=%f", MoneyBalanceParDay);*/
 			}
 		}
@@ -1217,6 +1713,126 @@ SectorDeal UFlareCompanyAI::FindBestDealForShipFromSector(UFlareSimulatedSpacecr
 	return BestDeal;
 }
 
+float UFlareCompanyAI::ComputeDealBalance(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, UFlareSimulatedSector* SectorB, FFlareResourceDescription* Resource,
+	const struct ResourceVariation* VariationA, const struct ResourceVariation* VariationB, int64 TravelTimeToA, int64 TravelTime, int32& OutBuyQuantity)
+{
+	OutBuyQuantity = 0;
+
+	if(!VariationA->OwnedFlow &&
+			!VariationA->FactoryFlow &&
+			!VariationA->OwnedStock &&
+			!VariationA->FactoryStock &&
+			!VariationA->StorageStock &&
+			!VariationA->OwnedCapacity &&
+			!VariationA->FactoryCapacity &&
+			!VariationA->StorageCapacity &&
+			!VariationB->OwnedFlow &&
+			!VariationB->FactoryFlow &&
+			!VariationB->OwnedStock &&
+			!VariationB->FactoryStock &&
+			!VariationB->StorageStock &&
+			!VariationB->OwnedCapacity &&
+			!VariationB->FactoryCapacity &&
+			!VariationB->StorageCapacity)
+	{
+		return 0;
+	}
+
+
+	int32 InitialQuantity = Ship->GetCargoBay()->GetResourceQuantity(Resource);
+	int32 FreeSpace = Ship->GetCargoBay()->GetFreeSpaceForResource(Resource);
+
+	int32 StockInAAfterTravel =
+			VariationA->OwnedStock
+			+ VariationA->FactoryStock
+			+ VariationA->StorageStock
+			- (VariationA->OwnedFlow * TravelTimeToA)
+			- (VariationA->FactoryFlow * TravelTimeToA);
+
+	if(StockInAAfterTravel <= 0 && InitialQuantity == 0)
+	{
+		return 0;
+	}
+
+	int32 CanBuyQuantity = FMath::Min(FreeSpace, StockInAAfterTravel);
+
+	// Affordable quantity
+	CanBuyQuantity =  FMath::Min(CanBuyQuantity, (int32) (Company->GetMoney() / SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput)));
+
+	int32 CapacityInBAfterTravel =
+			VariationB->OwnedCapacity
+			+ VariationB->FactoryCapacity
+			+ VariationB->StorageCapacity
+			+ VariationB->OwnedFlow * TravelTime
+			+ VariationB->FactoryFlow * TravelTime
+			- VariationB->IncomingResources;
+
+	int32 SellQuantity = FMath::Min(CapacityInBAfterTravel, CanBuyQuantity + InitialQuantity);
+	int32  BuyQuantity = FMath::Max(0, SellQuantity - InitialQuantity);
+
+	// Use price details
+
+	int32 MoneyGain = 0;
+	int32 QuantityToSell = SellQuantity;
+
+	int32 OwnedCapacity = FMath::Max(0, (int32) (VariationB->OwnedCapacity + VariationB->OwnedFlow * TravelTime));
+	int32 FactoryCapacity = FMath::Max(0, (int32) (VariationB->FactoryCapacity + VariationB->FactoryFlow * TravelTime));
+	int32 StorageCapacity = VariationB->StorageCapacity;
+
+	int32 OwnedSellQuantity = FMath::Min(OwnedCapacity, QuantityToSell);
+	MoneyGain += OwnedSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 1.1; // Valorise transport to its own station
+	QuantityToSell -= OwnedSellQuantity;
+
+	int32 FactorySellQuantity = FMath::Min(FactoryCapacity, QuantityToSell);
+	MoneyGain += FactorySellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput);
+	QuantityToSell -= FactorySellQuantity;
+
+	int32 StorageSellQuantity = FMath::Min(StorageCapacity, QuantityToSell);
+	MoneyGain += StorageSellQuantity * SectorB->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
+	QuantityToSell -= StorageSellQuantity;
+
+	int32 MoneySpend = 0;
+	int32 QuantityToBuy = BuyQuantity;
+
+	int32 OwnedStock = FMath::Max(0, (int32) (VariationA->OwnedStock - VariationA->OwnedFlow * TravelTimeToA));
+	int32 FactoryStock = FMath::Max(0, (int32) (VariationA->FactoryStock - VariationA->FactoryFlow * TravelTimeToA));
+	int32 StorageStock = VariationA->StorageStock;
+
+
+	int32 OwnedBuyQuantity = FMath::Min(OwnedStock, QuantityToBuy);
+	MoneySpend += OwnedBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default) * 0.9; // Valorise buy to self
+	QuantityToBuy -= OwnedBuyQuantity;
+
+	int32 FactoryBuyQuantity = FMath::Min(FactoryStock, QuantityToBuy);
+	MoneySpend += FactoryBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryOutput);
+	QuantityToBuy -= FactoryBuyQuantity;
+
+	int32 StorageBuyQuantity = FMath::Min(StorageStock, QuantityToBuy);
+	MoneySpend += StorageBuyQuantity * SectorA->GetResourcePrice(Resource, EFlareResourcePriceContext::Default);
+	QuantityToBuy -= StorageBuyQuantity;
+
+
+	// Station construction incitation
+	/*if (SectorB == ConstructionProjectSector)
+	{
+		for (int ConstructionResourceIndex = 0; ConstructionResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ConstructionResourceIndex++)
+		{
+			FFlareFactoryResource* ConstructionResource = &ConstructionProjectStation->CycleCost.InputResources[ConstructionResourceIndex];
+
+			if (Resource == &ConstructionResource->Resource->Data)
+			{
+				MoneyGain *= STATION_CONSTRUCTION_PRICE_BONUS;
+				break;
+			}
+		}
+	}*/
+
+	int32 MoneyBalance = MoneyGain - MoneySpend;
+
+	OutBuyQuantity = BuyQuantity;
+	return (float) MoneyBalance / (float) TravelTime;
+}
+
 void UFlareCompanyAI::Tick()
 {
 	if (Company == Game->GetPC()->GetCompany())
@@ -1388,15 +2004,10 @@ void UFlareCompanyAI::ResetShipGroup(EFlareCombatTactic::Type Tactic)
 	}
 }
 
-TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlow()
+TArray<int32> UFlareCompanyAI::ComputeWorldResourceFlow()
 {
-	TMap<FFlareResourceDescription*, int32> WorldResourceFlow;
-	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
-	{
-		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-
-		WorldResourceFlow.Add(Resource, 0);
-	}
+	TArray<int32> WorldResourceFlow;
+	WorldResourceFlow.SetNumZeroed(Game->GetResourceCatalog()->Resources.Num());
 
 	for (int32 SectorIndex = 0; SectorIndex < Company->GetKnownSectors().Num(); SectorIndex++)
 	{
@@ -1435,7 +2046,7 @@ TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlo
 
 
 					uint32 Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-					WorldResourceFlow[Resource] -=Flow;
+					WorldResourceFlow[Resource->Index] -=Flow;
 				}
 
 				// Ouput flow
@@ -1444,7 +2055,7 @@ TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlo
 					FFlareResourceDescription* Resource = Factory->GetOutputResource(ResourceIndex);
 
 					uint32 Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
-					WorldResourceFlow[Resource] +=Flow;
+					WorldResourceFlow[Resource->Index] +=Flow;
 				}
 			}
 		}
@@ -1456,7 +2067,7 @@ TMap<FFlareResourceDescription*, int32> UFlareCompanyAI::ComputeWorldResourceFlo
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
 
 				uint32 Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource);
-				WorldResourceFlow[Resource] -= Consumption;
+				WorldResourceFlow[Resource->Index] -= Consumption;
 			}
 		}
 
@@ -1470,7 +2081,6 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 	SectorVariation SectorVariation;
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
-		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
 		struct ResourceVariation ResourceVariation;
 		ResourceVariation.OwnedFlow = 0;
 		ResourceVariation.FactoryFlow = 0;
@@ -1481,7 +2091,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 		ResourceVariation.FactoryCapacity = 0;
 		ResourceVariation.StorageCapacity = 0;
 		ResourceVariation.IncomingResources = 0;
-		SectorVariation.ResourceVariations.Add(Resource, ResourceVariation);
+		SectorVariation.ResourceVariations.Add(ResourceVariation);
 	}
 
 	uint32 OwnedCustomerStation = 0;
@@ -1512,7 +2122,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetInputResourcesCount(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = Factory->GetInputResource(ResourceIndex);
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 
 				int32 Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
@@ -1559,7 +2169,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetOutputResourcesCount(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = Factory->GetOutputResource(ResourceIndex);
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 				uint32 Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
 
@@ -1613,7 +2223,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->ConsumerResources.Num(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 				uint32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource);
 
@@ -1641,7 +2251,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->MaintenanceResources.Num(); ResourceIndex++)
 			{
 				FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->MaintenanceResources[ResourceIndex]->Data;
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 				uint32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource);
 
@@ -1671,7 +2281,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 			for (int ResourceIndex = 0; ResourceIndex < ConstructionProjectStation->CycleCost.InputResources.Num() ; ResourceIndex++)
 			{
 				FFlareFactoryResource* Resource = &ConstructionProjectStation->CycleCost.InputResources[ResourceIndex];
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[&Resource->Resource->Data];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Resource->Data.Index];
 				Variation->OwnedCapacity += Resource->Quantity;
 			}
 		}*/
@@ -1685,7 +2295,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->ConsumerResources.Num(); ResourceIndex++)
 		{
 			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
-			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 
 			uint32 Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource);
@@ -1729,7 +2339,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 				{
 					continue;
 				}
-				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Cargo.Resource];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Cargo.Resource->Index];
 
 				Variation->IncomingResources += Cargo.Quantity / (RemainingTravelDuration * 0.5);
 			}
@@ -1751,7 +2361,7 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 		{
 			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource];
+			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
 
 			int32 TotalFlow =  Variation->FactoryFlow + Variation->OwnedFlow;
 
@@ -1773,13 +2383,13 @@ SectorVariation UFlareCompanyAI::ComputeSectorResourceVariation(UFlareSimulatedS
 	return SectorVariation;
 }
 
-void UFlareCompanyAI::DumpSectorResourceVariation(UFlareSimulatedSector* Sector, TMap<FFlareResourceDescription*, struct ResourceVariation>* SectorVariation)
+void UFlareCompanyAI::DumpSectorResourceVariation(UFlareSimulatedSector* Sector, TArray<struct ResourceVariation>* SectorVariation)
 {
 	FLOGV("Sector %s resource variation: ", *Sector->GetSectorName().ToString());
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-		struct ResourceVariation* Variation = &(*SectorVariation)[Resource];
+		struct ResourceVariation* Variation = &(*SectorVariation)[ResourceIndex];
 		if(Variation->OwnedFlow ||
 				Variation->FactoryFlow ||
 				Variation->OwnedStock ||
@@ -2,6 +2,7 @@
 
 #include "Object.h"
 #include "../FlareGameTypes.h"
+#include "FlareResourceVariationCache.h"
 #include "FlareCompanyAI.generated.h"
 
 class UFlareCompany;
@@ -18,28 +19,31 @@ struct SectorDeal
 	int32 BuyQuantity;
 };
 
-
-struct ResourceVariation
+/** Deal found for a ship, as a bid in the cargo auction */
+struct CargoDealCandidate
 {
-	int32 OwnedFlow;
-	int32 FactoryFlow;
-
-	int32 OwnedStock;
-	int32 FactoryStock;
-	int32 StorageStock;
-	int32 IncomingResources;
+	/** Index of the sectors and resource of the deal, shared by the ships bidding on it */
+	int32 DealSlot;
 
-	int32 OwnedCapacity;
-	int32 FactoryCapacity;
-	int32 StorageCapacity;
+	SectorDeal Deal;
 };
 
-struct SectorVariation
+/** Best sell prices of the known sectors, bounding the gain of any deal */
+struct DealIndex
 {
-	int32 IncomingCapacity;
-	TMap<FFlareResourceDescription*, ResourceVariation> ResourceVariations;
+	int32 ResourceCount;
+
+	/** Best sell price by sector slot then resource index, 0 for the unknown sectors */
+	TArray<float> SellPrices;
+
+	/** Best sell price of any resource, by sector slot */
+	TArray<float> SectorSellPrices;
+
+	/** Best sell price in any known sector, by resource index */
+	TArray<float> ResourceSellPrices;
 };
 
+
 UCLASS()
 class HELIUMRAIN_API UFlareCompanyAI : public UObject
 {
@@ -63,6 +67,10 @@ public:
 		Gameplay
 	----------------------------------------------------*/
 
+	/** Plan the day on the world as it is, without modifying it. Can run in a worker task */
+	virtual void Plan();
+
+	/** Apply the plan of the day, or plan and apply it if not planned */
 	virtual void Simulate();
 
 	virtual void Tick();
@@ -72,6 +80,15 @@ public:
 	/** Destroy a spacecraft */
 	virtual void DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft);
 
+	/** Assign each ship at most one candidate and each deal at most its capacity in ships, for the best total balance. Deterministic */
+	static void SolveCargoAuction(const TArray<TArray<CargoDealCandidate>>& ShipCandidates, const TArray<int32>& DealCapacities, TArray<int32>& OutAssignments);
+
+	/** Assign each ship in turn its best candidate among the deals with capacity left, as the ship by ship search */
+	static void SolveCargoGreedy(const TArray<TArray<CargoDealCandidate>>& ShipCandidates, const TArray<int32>& DealCapacities, TArray<int32>& OutAssignments);
+
+	/** Assign the idle cargos on the plan of the day as Simulate would, ship by ship or by auction, without trading nor traveling. The plan is left as it was */
+	void PlanCargoAssignment(bool Auction, TArray<UFlareSimulatedSpacecraft*>& OutShips, TArray<SectorDeal>& OutDeals);
+
 
 	/*----------------------------------------------------
 		Command groups
@@ -104,15 +121,63 @@ protected:
 
 	SectorVariation ComputeSectorResourceVariation(UFlareSimulatedSector* Sector);
 
-	void DumpSectorResourceVariation(UFlareSimulatedSector* Sector, TMap<FFlareResourceDescription*, struct ResourceVariation>* Variation);
+	/** Compute the resource variation of the known sectors, and index their deals */
+	void ComputeResourceVariations();
+
+	/** Score the stations to build in the known sectors, and keep the best one */
+	void ComputeBestStation();
+
+	/** Score a factory of a station to build in a sector. False for shipyards, which are not scored */
+	bool ComputeFactoryScore(UFlareSimulatedSector* Sector, FFlareSpacecraftDescription* StationDescription, FFlareFactoryDescription* FactoryDescription,
+		const TArray<int32>& ResourceFlow, float& OutGainPerDay, float& OutScore);
+
+	/** Score the planned station and the current project again, and drop the planned station if it can't be built or earn money anymore */
+	void RescorePlannedStation();
+
+	void DumpSectorResourceVariation(UFlareSimulatedSector* Sector, TArray<struct ResourceVariation>* Variation);
 
 	TArray<UFlareSimulatedSpacecraft*> FindIdleCargos();
 
+	/** Best deal for a ship, searching from every known sector */
+	SectorDeal FindBestDealForShip(UFlareSimulatedSpacecraft* Ship);
+
+	/** Best deal for a ship from a sector, after the cargos already traveling to this sector */
+	SectorDeal FindBestDealForShipInSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat);
+
+	/** Trade or travel for a deal, and reserve it for the other ships */
+	void ApplyDeal(UFlareSimulatedSpacecraft* Ship, const SectorDeal& BestDeal);
+
+	/** Give the stock of sector A to the cargos traveling there before a ship coming for a deal. False if there was nothing to give */
+	bool ReserveIncomingCapacity(UFlareSimulatedSpacecraft* Ship, const SectorDeal& Deal);
+
+	/** Remove the stock and capacity of a deal from the variations. A loaded ship is also capacity arriving in sector B */
+	void ReserveDeal(const SectorDeal& Deal, bool Loaded);
+
+	/** Check a planned deal on the current stations and prices of its sectors, scanned once in LiveVariations. Remove it from the variations if gone */
+	bool ValidatePlannedDeal(UFlareSimulatedSpacecraft* Ship, const SectorDeal& Deal, TMap<UFlareSimulatedSector*, SectorVariation>& LiveVariations);
+
+	/** Remove the stock of a resource in a sector from the variations, after a failed deal */
+	void RemoveDealStock(UFlareSimulatedSector* Sector, FFlareResourceDescription* Resource);
+
+	/** Remove the capacity for a resource in a sector from the variations, after a failed deal */
+	void RemoveDealCapacity(UFlareSimulatedSector* Sector, FFlareResourceDescription* Resource);
+
+	/** Find the candidate deals once per cargo profile without reserving them, and assign them by auction. Ships without deal get no resource */
+	void AssignCargosByAuction(const TArray<UFlareSimulatedSpacecraft*>& Ships, TArray<SectorDeal>& OutDeals);
+
+	/** Index the best sell prices of the known sectors */
+	void ComputeDealIndex();
+
+	/** Balance per day of carrying a resource from sector A to sector B, 0 if there is nothing to carry */
+	float ComputeDealBalance(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, UFlareSimulatedSector* SectorB, FFlareResourceDescription* Resource,
+		const struct ResourceVariation* VariationA, const struct ResourceVariation* VariationB, int64 TravelTimeToA, int64 TravelTime, int32& OutBuyQuantity);
+
 	SectorDeal FindBestDealForShipFromSector(UFlareSimulatedSpacecraft* Ship, UFlareSimulatedSector* SectorA, SectorDeal* DealToBeat, TMap<UFlareSimulatedSector*, SectorVariation> *WorldResourceVariation);
 
 	void ManagerConstructionShips(TMap<UFlareSimulatedSector*, SectorVariation> & WorldResourceVariation);
 
-	TMap<FFlareResourceDescription*, int32> ComputeWorldResourceFlow();
+	/** Production minus consumption in the known sectors, by resource index */
+	TArray<int32> ComputeWorldResourceFlow();
 
 	protected:
 
@@ -120,6 +185,21 @@ protected:
 	FFlareCompanyAISave					   AIData;
 	AFlareGame*                            Game;
 
+	/** Sell prices of the day, to skip the deals that can't beat the best one */
+	DealIndex                              SellDeals;
+
+	/** The variations and the best station below were computed by Plan */
+	bool                                   Planned;
+
+	/** Resource variations of the known sectors, updated by the trades of the day */
+	TMap<UFlareSimulatedSector*, SectorVariation> WorldResourceVariation;
+
+	/** Best station to build, and the score of the current construction project */
+	float                                  CurrentConstructionScore;
+	float                                  BestScore;
+	FFlareSpacecraftDescription*           BestStationDescription;
+	UFlareSimulatedSector*                 BestSector;
+
 	// Command groups
 	TEnumAsByte<EFlareCombatGroup::Type>     CurrentShipGroup;
 	TArray<TEnumAsByte<EFlareCombatTactic::Type>> CurrentCombatTactics;
@@ -0,0 +1,330 @@
+
+#include "../../Flare.h"
+#include "FlareResourceVariationCache.h"
+#include "../FlareGame.h"
+#include "../FlareWorld.h"
+#include "../FlareCompany.h"
+#include "../FlareTravel.h"
+#include "../FlareFleet.h"
+#include "../../Spacecrafts/FlareSimulatedSpacecraft.h"
+#include "../../Economy/FlareCargoBay.h"
+#include "../../Economy/FlareFactory.h"
+
+
+/*----------------------------------------------------
+	Update
+----------------------------------------------------*/
+
+void FFlareResourceVariationCache::Update(UFlareWorld* World, AFlareGame* CurrentGame)
+{
+	Game = CurrentGame;
+	Date = World->GetDate();
+	ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+	Sectors.Empty(World->GetSectors().Num());
+
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = World->GetSectors()[SectorIndex];
+		FSectorEntry& Entry = Sectors.Add(Sector);
+		Entry.IncomingCapacity = 0;
+		Entry.IncomingResources.SetNumZeroed(ResourceCount);
+
+		for (int32 StationIndex = 0 ; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+		{
+			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
+			FOwnerVariation& Owner = FindOrAddOwner(Entry, Station->GetCompany());
+			uint32 SlotCapacity = Station->GetCargoBay()->GetSlotCapacity();
+
+			for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
+			{
+				UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
+				if ((!Factory->IsActive() || !Factory->IsNeedProduction()))
+				{
+					// No resources needed
+					break;
+				}
+
+				// Input flow, limited by the money of the owner for the other companies
+				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetInputResourcesCount(); ResourceIndex++)
+				{
+					FFlareResourceDescription* Resource = Factory->GetInputResource(ResourceIndex);
+					struct ResourceVariation* Variation = &Owner.ResourceVariations[Resource->Index];
+
+					int32 Flow = Factory->GetInputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
+
+					int32 CanBuyQuantity =  (int32) (Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
+
+					if (Flow == 0)
+					{
+						continue;
+					}
+
+					if(Factory->IsProducing())
+					{
+						Variation->OwnedFlow += Flow;
+						Variation->FactoryFlow += FMath::Min(Flow, CanBuyQuantity);
+					}
+
+					uint32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource);
+					if (ResourceQuantity < SlotCapacity)
+					{
+						int32 Capacity = SlotCapacity - ResourceQuantity;
+						Variation->OwnedCapacity += Capacity;
+						Variation->FactoryCapacity += FMath::Min(Capacity, CanBuyQuantity);
+					}
+				}
+
+				// Ouput flow
+				for (int32 ResourceIndex = 0; ResourceIndex < Factory->GetOutputResourcesCount(); ResourceIndex++)
+				{
+					FFlareResourceDescription* Resource = Factory->GetOutputResource(ResourceIndex);
+					struct ResourceVariation* Variation = &Owner.ResourceVariations[Resource->Index];
+
+					uint32 Flow = Factory->GetOutputResourceQuantity(ResourceIndex) / Factory->GetProductionDuration();
+
+					if (Flow == 0)
+					{
+						continue;
+					}
+
+					if(Factory->IsProducing())
+					{
+						Variation->OwnedFlow -= Flow;
+						Variation->FactoryFlow -= Flow;
+					}
+
+					uint32 Stock = Station->GetCargoBay()->GetResourceQuantity(Resource);
+					Variation->OwnedStock += Stock;
+					Variation->FactoryStock += Stock;
+				}
+			}
+
+			// Customer flow
+			if (Station->HasCapability(EFlareSpacecraftCapability::Consumer))
+			{
+				Owner.CustomerStationCount++;
+
+				for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->ConsumerResources.Num(); ResourceIndex++)
+				{
+					FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
+					struct ResourceVariation* Variation = &Owner.ResourceVariations[Resource->Index];
+
+					uint32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource);
+
+					// Dept are allowed for sell to customers
+					if (ResourceQuantity < SlotCapacity)
+					{
+						int32 Capacity = SlotCapacity - ResourceQuantity;
+						Variation->OwnedCapacity += Capacity;
+						Variation->FactoryCapacity += Capacity;
+					}
+				}
+			}
+
+			// Maintenance
+			if (Station->HasCapability(EFlareSpacecraftCapability::Maintenance))
+			{
+				for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->MaintenanceResources.Num(); ResourceIndex++)
+				{
+					FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->MaintenanceResources[ResourceIndex]->Data;
+					struct ResourceVariation* Variation = &Owner.ResourceVariations[Resource->Index];
+
+					uint32 ResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Resource);
+
+					int32 CanBuyQuantity =  (int32) (Station->GetCompany()->GetMoney() / Sector->GetResourcePrice(Resource, EFlareResourcePriceContext::FactoryInput));
+
+					if (ResourceQuantity < SlotCapacity)
+					{
+						int32 Capacity = SlotCapacity - ResourceQuantity;
+						Variation->OwnedCapacity += Capacity;
+						Variation->FactoryCapacity += FMath::Min(Capacity, CanBuyQuantity);
+					}
+				}
+			}
+
+			// Storage stock, compared to the consumption of each company later
+			if (Station->HasCapability(EFlareSpacecraftCapability::Storage))
+			{
+				FStorageStock Storage;
+				Storage.Owner = Station->GetCompany();
+				Storage.Quantities.SetNumZeroed(ResourceCount);
+
+				for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+				{
+					FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+					Storage.Quantities[Resource->Index] = Station->GetCargoBay()->GetResourceQuantity(Resource);
+				}
+
+				Entry.Storages.Add(Storage);
+			}
+		}
+	}
+
+	// Compute incoming capacity and resources, in a single pass on the travels
+	for (int32 TravelIndex = 0; TravelIndex < World->GetTravels().Num(); TravelIndex++)
+	{
+		UFlareTravel* Travel = World->GetTravels()[TravelIndex];
+		FSectorEntry* Entry = Sectors.Find(Travel->GetDestinationSector());
+		if (!Entry)
+		{
+			continue;
+		}
+
+		int64 RemainingTravelDuration = FMath::Max((int64) 1, Travel->GetRemainingTravelDuration());
+
+		UFlareFleet* IncomingFleet = Travel->GetFleet();
+
+		for (int ShipIndex = 0; ShipIndex < IncomingFleet->GetShips().Num(); ShipIndex++)
+		{
+			UFlareSimulatedSpacecraft* Ship = IncomingFleet->GetShips()[ShipIndex];
+
+			if (Ship->GetCargoBay()->GetSlotCapacity() == 0)
+			{
+				continue;
+			}
+			Entry->IncomingCapacity += Ship->GetCargoBay()->GetCapacity() / RemainingTravelDuration;
+
+			TArray<FFlareCargo>& CargoBaySlots = Ship->GetCargoBay()->GetSlots();
+			for (int CargoIndex = 0; CargoIndex < CargoBaySlots.Num(); CargoIndex++)
+			{
+				FFlareCargo& Cargo = CargoBaySlots[CargoIndex];
+
+				if (!Cargo.Resource)
+				{
+					continue;
+				}
+
+				Entry->IncomingResources[Cargo.Resource->Index] += Cargo.Quantity / (RemainingTravelDuration * 0.5);
+			}
+		}
+	}
+}
+
+FFlareResourceVariationCache::FOwnerVariation& FFlareResourceVariationCache::FindOrAddOwner(FSectorEntry& Entry, UFlareCompany* Owner)
+{
+	for (int32 OwnerIndex = 0; OwnerIndex < Entry.Owners.Num(); OwnerIndex++)
+	{
+		if (Entry.Owners[OwnerIndex].Owner == Owner)
+		{
+			return Entry.Owners[OwnerIndex];
+		}
+	}
+
+	FOwnerVariation& OwnerVariation = Entry.Owners[Entry.Owners.AddDefaulted()];
+	OwnerVariation.Owner = Owner;
+	OwnerVariation.CustomerStationCount = 0;
+	OwnerVariation.ResourceVariations.SetNumZeroed(ResourceCount);
+	return OwnerVariation;
+}
+
+
+/*----------------------------------------------------
+	Company overlay
+----------------------------------------------------*/
+
+SectorVariation FFlareResourceVariationCache::GetSectorVariation(UFlareSimulatedSector* Sector, UFlareCompany* Company) const
+{
+	SectorVariation SectorVariation;
+	SectorVariation.IncomingCapacity = 0;
+	SectorVariation.ResourceVariations.SetNumZeroed(ResourceCount);
+
+	const FSectorEntry* Entry = Sectors.Find(Sector);
+	if (!Entry)
+	{
+		FLOGV("FFlareResourceVariationCache::GetSectorVariation : no variation for %s", *Sector->GetSectorName().ToString());
+		return SectorVariation;
+	}
+
+	SectorVariation.IncomingCapacity = Entry->IncomingCapacity;
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+	{
+		SectorVariation.ResourceVariations[ResourceIndex].IncomingResources = Entry->IncomingResources[ResourceIndex];
+	}
+
+	// Sum the stations of each non-hostile owner, as seen by this company
+	uint32 OwnedCustomerStation = 0;
+	uint32 NotOwnedCustomerStation = 0;
+
+	for (int32 OwnerIndex = 0; OwnerIndex < Entry->Owners.Num(); OwnerIndex++)
+	{
+		const FOwnerVariation& Owner = Entry->Owners[OwnerIndex];
+
+		if (Owner.Owner->GetWarState(Company) == EFlareHostility::Hostile)
+		{
+			continue;
+		}
+
+		if (Owner.Owner == Company)
+		{
+			OwnedCustomerStation += Owner.CustomerStationCount;
+			for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+			{
+				const struct ResourceVariation& OwnerVariation = Owner.ResourceVariations[ResourceIndex];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[ResourceIndex];
+				Variation->OwnedFlow += OwnerVariation.OwnedFlow;
+				Variation->OwnedStock += OwnerVariation.OwnedStock;
+				Variation->OwnedCapacity += OwnerVariation.OwnedCapacity;
+			}
+		}
+		else
+		{
+			NotOwnedCustomerStation += Owner.CustomerStationCount;
+			for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+			{
+				const struct ResourceVariation& OwnerVariation = Owner.ResourceVariations[ResourceIndex];
+				struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[ResourceIndex];
+				Variation->FactoryFlow += OwnerVariation.FactoryFlow;
+				Variation->FactoryStock += OwnerVariation.FactoryStock;
+				Variation->FactoryCapacity += OwnerVariation.FactoryCapacity;
+			}
+		}
+	}
+
+	if(OwnedCustomerStation || NotOwnedCustomerStation)
+	{
+		float OwnedCustomerRatio = (float) OwnedCustomerStation / (float) (OwnedCustomerStation + NotOwnedCustomerStation);
+		float NotOwnedCustomerRatio = (float) NotOwnedCustomerStation / (float) (OwnedCustomerStation + NotOwnedCustomerStation);
+
+		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->ConsumerResources.Num(); ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->ConsumerResources[ResourceIndex]->Data;
+			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[Resource->Index];
+
+			uint32 Consumption = Sector->GetPeople()->GetRessourceConsumption(Resource);
+
+			Variation->OwnedFlow = OwnedCustomerRatio * Consumption;
+			Variation->FactoryFlow = NotOwnedCustomerRatio * Consumption;
+		}
+	}
+
+	// Consider resource over 10 days of consumption as IncomingResources
+	for (int32 StorageIndex = 0; StorageIndex < Entry->Storages.Num(); StorageIndex++)
+	{
+		const FStorageStock& Storage = Entry->Storages[StorageIndex];
+
+		if (Storage.Owner->GetWarState(Company) == EFlareHostility::Hostile)
+		{
+			continue;
+		}
+
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			struct ResourceVariation* Variation = &SectorVariation.ResourceVariations[ResourceIndex];
+
+			int32 TotalFlow =  Variation->FactoryFlow + Variation->OwnedFlow;
+
+			if(TotalFlow >= 0)
+			{
+				int32 LongTermConsumption = TotalFlow * 10;
+				int32 ResourceQuantity = Storage.Quantities[ResourceIndex];
+
+				if (ResourceQuantity > LongTermConsumption)
+				{
+					Variation->IncomingResources += ResourceQuantity - LongTermConsumption;
+				}
+			}
+		}
+	}
+
+	return SectorVariation;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+class UFlareCompany;
+class UFlareSimulatedSector;
+class UFlareWorld;
+class AFlareGame;
+
+
+struct ResourceVariation
+{
+	int32 OwnedFlow;
+	int32 FactoryFlow;
+
+	int32 OwnedStock;
+	int32 FactoryStock;
+	int32 StorageStock;
+	int32 IncomingResources;
+
+	int32 OwnedCapacity;
+	int32 FactoryCapacity;
+	int32 StorageCapacity;
+};
+
+struct SectorVariation
+{
+	int32 IncomingCapacity;
+
+	/** Variations by resource index */
+	TArray<ResourceVariation> ResourceVariations;
+};
+
+
+/** Resource variations of all sectors, computed once a day and shared by all AI companies */
+struct FFlareResourceVariationCache
+{
+	FFlareResourceVariationCache()
+		: Date(-1)
+	{}
+
+	/** Scan all sectors and travels of the world */
+	void Update(UFlareWorld* World, AFlareGame* Game);
+
+	/** Rebuild at the next use */
+	void Invalidate()
+	{
+		Date = -1;
+	}
+
+	/** Date of the last update, -1 if invalid */
+	inline int64 GetDate() const
+	{
+		return Date;
+	}
+
+	/** Variation of a sector as seen by a company : its own stations, and the stations of the non-hostile companies */
+	SectorVariation GetSectorVariation(UFlareSimulatedSector* Sector, UFlareCompany* Company) const;
+
+protected:
+
+	/** Stations of one company in a sector. Owned fields are the variation seen by this company, factory fields the variation seen by the others */
+	struct FOwnerVariation
+	{
+		UFlareCompany* Owner;
+
+		int32 CustomerStationCount;
+
+		TArray<ResourceVariation> ResourceVariations;
+	};
+
+	/** Storage station stock, for the long term consumption */
+	struct FStorageStock
+	{
+		UFlareCompany* Owner;
+
+		TArray<int32> Quantities;
+	};
+
+	struct FSectorEntry
+	{
+		int32 IncomingCapacity;
+
+		TArray<int32> IncomingResources;
+
+		TArray<FOwnerVariation> Owners;
+
+		TArray<FStorageStock> Storages;
+	};
+
+	FOwnerVariation& FindOrAddOwner(FSectorEntry& Entry, UFlareCompany* Owner);
+
+	int64                                        Date;
+
+	int32                                        ResourceCount;
+
+	AFlareGame*                                  Game;
+
+	TMap<UFlareSimulatedSector*, FSectorEntry>   Sectors;
+
+};
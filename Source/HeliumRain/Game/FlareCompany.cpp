@@ -19,6 +19,7 @@
 
 UFlareCompany::UFlareCompany(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, CompanySlot(-1)
 {
 }
 
@@ -77,6 +78,7 @@ void UFlareCompany::PostLoad()
 	VisitedSectors.Empty();
 	KnownSectors.Empty();
 	CompanyTradeRoutes.Empty();
+	TradeRoutesByIdentifier.Empty();
 
 	// Load all trade routes
 	for (int32 i = 0; i < CompanyData.TradeRoutes.Num(); i++)
@@ -160,9 +162,54 @@ FFlareCompanySave* UFlareCompany::Save()
 
 	CompanyData.CompanyValue = GetCompanyValue().TotalValue;
 
+	// Relations
+	CompanyData.HostileCompanies.Empty();
+	CompanyData.CompaniesReputation.Empty();
+
+	const FFlareCompanyRelations& Relations = Game->GetGameWorld()->GetCompanyRelations();
+	TArray<UFlareCompany*> Companies = Game->GetGameWorld()->GetCompanies();
+	for (int i = 0 ; i < Companies.Num(); i++)
+	{
+		UFlareCompany* OtherCompany = Companies[i];
+		if (OtherCompany == this)
+		{
+			continue;
+		}
+
+		if (Relations.IsHostile(CompanySlot, OtherCompany->GetCompanySlot()))
+		{
+			CompanyData.HostileCompanies.Add(OtherCompany->GetIdentifier());
+		}
+
+		float Reputation = Relations.GetReputation(CompanySlot, OtherCompany->GetCompanySlot());
+		if (Reputation != 0.f)
+		{
+			FFlareCompanyReputationSave CompanyReputation;
+			CompanyReputation.CompanyIdentifier = OtherCompany->GetIdentifier();
+			CompanyReputation.Reputation = Reputation;
+			CompanyData.CompaniesReputation.Add(CompanyReputation);
+		}
+	}
+
 	return &CompanyData;
 }
 
+void UFlareCompany::LoadRelations(UFlareCompany* TargetCompany)
+{
+	FFlareCompanyRelations& Relations = Game->GetGameWorld()->GetCompanyRelations();
+
+	Relations.SetHostile(CompanySlot, TargetCompany->GetCompanySlot(), CompanyData.HostileCompanies.Contains(TargetCompany->GetIdentifier()));
+
+	for (int32 CompanyIndex = 0; CompanyIndex < CompanyData.CompaniesReputation.Num(); CompanyIndex++)
+	{
+		if (TargetCompany->GetIdentifier() == CompanyData.CompaniesReputation[CompanyIndex].CompanyIdentifier)
+		{
+			Relations.SetReputation(CompanySlot, TargetCompany->GetCompanySlot(), CompanyData.CompaniesReputation[CompanyIndex].Reputation);
+			break;
+		}
+	}
+}
+
 
 /*----------------------------------------------------
 	Gameplay
@@ -197,7 +244,7 @@ EFlareHostility::Type UFlareCompany::GetHostility(const UFlareCompany* TargetCom
 	{
 		return EFlareHostility::Owned;
 	}
-	else if (TargetCompany && CompanyData.HostileCompanies.Contains(TargetCompany->GetIdentifier()))
+	else if (TargetCompany && Game->GetGameWorld()->GetCompanyRelations().IsHostile(CompanySlot, TargetCompany->GetCompanySlot()))
 	{
 		return EFlareHostility::Hostile;
 	}
@@ -235,15 +282,16 @@ void UFlareCompany::SetHostilityTo(UFlareCompany* TargetCompany, bool Hostile)
 {
 	if (TargetCompany && TargetCompany != this)
 	{
-		bool WasHostile = CompanyData.HostileCompanies.Contains(TargetCompany->GetIdentifier());
+		FFlareCompanyRelations& Relations = Game->GetGameWorld()->GetCompanyRelations();
+		bool WasHostile = Relations.IsHostile(CompanySlot, TargetCompany->GetCompanySlot());
 		if (Hostile && !WasHostile)
 		{
-			CompanyData.HostileCompanies.AddUnique(TargetCompany->GetIdentifier());
+			Relations.SetHostile(CompanySlot, TargetCompany->GetCompanySlot(), true);
 			TargetCompany->GiveReputation(this, -50, true);
 		}
 		else if(!Hostile && WasHostile)
 		{
-			CompanyData.HostileCompanies.Remove(TargetCompany->GetIdentifier());
+			Relations.SetHostile(CompanySlot, TargetCompany->GetCompanySlot(), false);
 			TargetCompany->GiveReputation(this, 20, true);
 		}
 	}
@@ -335,6 +383,8 @@ UFlareFleet* UFlareCompany::LoadFleet(const FFlareFleetSave& FleetData)
 	Fleet = NewObject<UFlareFleet>(this, UFlareFleet::StaticClass());
 	Fleet->Load(FleetData);
 	CompanyFleets.AddUnique(Fleet);
+	FleetsByIdentifier.Add(Fleet->GetIdentifier(), Fleet);
+	Game->GetGameWorld()->MarkCompanyDirty(this);
 
 	FLOGV("UFlareWorld::LoadFleet : loaded fleet '%s'", *Fleet->GetFleetName().ToString());
 
@@ -344,6 +394,8 @@ UFlareFleet* UFlareCompany::LoadFleet(const FFlareFleetSave& FleetData)
 void UFlareCompany::RemoveFleet(UFlareFleet* Fleet)
 {
 	CompanyFleets.Remove(Fleet);
+	FleetsByIdentifier.Remove(Fleet->GetIdentifier());
+	Game->GetGameWorld()->MarkCompanyDirty(this);
 }
 
 UFlareTradeRoute* UFlareCompany::CreateTradeRoute(FText TradeRouteName)
@@ -371,6 +423,7 @@ UFlareTradeRoute* UFlareCompany::LoadTradeRoute(const FFlareTradeRouteSave& Trad
 	TradeRoute = NewObject<UFlareTradeRoute>(this, UFlareTradeRoute::StaticClass());
 	TradeRoute->Load(TradeRouteData);
 	CompanyTradeRoutes.AddUnique(TradeRoute);
+	TradeRoutesByIdentifier.Add(TradeRoute->GetIdentifier(), TradeRoute);
 
 	FLOGV("UFlareCompany::LoadTradeRoute : loaded trade route '%s'", *TradeRoute->GetTradeRouteName().ToString());
 
@@ -380,6 +433,7 @@ UFlareTradeRoute* UFlareCompany::LoadTradeRoute(const FFlareTradeRouteSave& Trad
 void UFlareCompany::RemoveTradeRoute(UFlareTradeRoute* TradeRoute)
 {
 	CompanyTradeRoutes.Remove(TradeRoute);
+	TradeRoutesByIdentifier.Remove(TradeRoute->GetIdentifier());
 }
 
 UFlareSimulatedSpacecraft* UFlareCompany::LoadSpacecraft(const FFlareSpacecraftSave& SpacecraftData)
@@ -415,6 +469,8 @@ UFlareSimulatedSpacecraft* UFlareCompany::LoadSpacecraft(const FFlareSpacecraftS
 		}
 
 		CompanySpacecrafts.AddUnique((Spacecraft));
+		SpacecraftsByImmatriculation.Add(Spacecraft->GetImmatriculation(), Spacecraft);
+		Game->GetGameWorld()->MarkCompanyDirty(this);
 	}
 	else
 	{
@@ -431,6 +487,9 @@ void UFlareCompany::DestroySpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 	CompanySpacecrafts.Remove(Spacecraft);
 	CompanyStations.Remove(Spacecraft);
 	CompanyShips.Remove(Spacecraft);
+	SpacecraftsByImmatriculation.Remove(Spacecraft->GetImmatriculation());
+	GetGame()->GetGameWorld()->MarkCompanyDirty(this);
+
 	if (Spacecraft->GetCurrentFleet())
 	{
 		Spacecraft->GetCurrentFleet()->RemoveShip(Spacecraft, true);
@@ -493,97 +552,21 @@ void UFlareCompany::GiveMoney(int64 Amount)
 	}*/
 }
 
-#define REPUTATION_RANGE 200.f
 void UFlareCompany::GiveReputation(UFlareCompany* Company, float Amount, bool Propagate)
 {
-	FFlareCompanyReputationSave* CompanyReputation = NULL;
-
 	if (Company == this)
 	{
 		FLOG("ERROR: A company don't have reputation for itself!");
 		return;
 	}
 
-	for (int32 CompanyIndex = 0; CompanyIndex < CompanyData.CompaniesReputation.Num(); CompanyIndex++)
-	{
-		if(Company->GetIdentifier() == CompanyData.CompaniesReputation[CompanyIndex].CompanyIdentifier)
-		{
-			CompanyReputation = &CompanyData.CompaniesReputation[CompanyIndex];
-			break;
-		}
-	}
-
-	if (CompanyReputation == NULL)
-	{
-		FFlareCompanyReputationSave NewCompanyReputation;
-		NewCompanyReputation.CompanyIdentifier = Company->GetIdentifier();
-		NewCompanyReputation.Reputation = 0;
-		CompanyData.CompaniesReputation.Add(NewCompanyReputation);
-		CompanyReputation = &CompanyData.CompaniesReputation[CompanyData.CompaniesReputation.Num()-1];
-	}
-
-	// Gain reputation is easier with low reputation and loose reputation is easier with hight reputation.
-	// Reputation vary between -200 and 200
-	// 0% if reputation in variation direction = 200
-	// 10% if reputation in variation direction = 100
-	// 100% if reputation in variation direction = 0
-	// 200% if reputation in variation direction = -100
-	// 1000% if reputation in variation direction = -200
-
-	// -200 = 0, 200 = 1
-	float ReputationRatioInVarationDirection = (CompanyReputation->Reputation * FMath::Sign(Amount) + REPUTATION_RANGE) / (2*REPUTATION_RANGE);
-	float ReputationGainFactor = 1.f;
-
-	if (ReputationRatioInVarationDirection < 0.25f)
-	{
-		ReputationGainFactor = - 32.f * ReputationRatioInVarationDirection + 10.f;
-	}
-	else if (ReputationRatioInVarationDirection < 0.50f)
-	{
-		ReputationGainFactor = - 4.f * ReputationRatioInVarationDirection + 3.f;
-	}
-	else if (ReputationRatioInVarationDirection < 0.75f)
-	{
-		ReputationGainFactor = - 3.6f * ReputationRatioInVarationDirection + 2.8f;
-	}
-	else
-	{
-		ReputationGainFactor = - 0.4f * ReputationRatioInVarationDirection + 0.4f;
-	}
-
-	float ReputationScaledGain = Amount * ReputationGainFactor;
-
-	CompanyReputation->Reputation = FMath::Clamp(CompanyReputation->Reputation + ReputationScaledGain, -200.f, 200.f);
-	if (FMath::Abs(CompanyReputation->Reputation) < 1.f)
-	{
-		CompanyReputation->Reputation = 0.f;
-	}
+	FFlareCompanyRelations& Relations = Game->GetGameWorld()->GetCompanyRelations();
+	float ReputationScaledGain = Relations.GiveReputation(CompanySlot, Company->GetCompanySlot(), Amount);
 
 	if (Propagate)
 	{
-		// Other companies gain a part of reputation gain according to their affinity :
-		// 200 = 50 % of the gain
-		// -200 = -50 % of the gain
-		// 0 = 0% the the gain
-
-
-		for (int32 CompanyIndex = 0; CompanyIndex < Game->GetGameWorld()->GetCompanies().Num(); CompanyIndex++)
-		{
-			UFlareCompany* OtherCompany = Game->GetGameWorld()->GetCompanies()[CompanyIndex];
-
-			if (OtherCompany == Company || OtherCompany == this)
-			{
-				continue;
-			}
-
-			float OtherReputation = OtherCompany->GetReputation(Company);
-			float PropagationRatio = OtherReputation / 400.f;
-			OtherCompany->GiveReputation(Company, PropagationRatio * ReputationScaledGain, false);
-		}
-
-
+		Relations.PropagateReputation(CompanySlot, Company->GetCompanySlot(), ReputationScaledGain);
 	}
-
 }
 
 
@@ -762,17 +745,49 @@ struct CompanyValue UFlareCompany::GetCompanyValue() const
 	return Value;
 }
 
-UFlareSimulatedSpacecraft* UFlareCompany::FindSpacecraft(FName ShipImmatriculation)
+bool UFlareCompany::CheckLookupIndices() const
 {
+	bool Integrity = true;
+
+	if (SpacecraftsByImmatriculation.Num() != CompanySpacecrafts.Num()
+	 || FleetsByIdentifier.Num() != CompanyFleets.Num()
+	 || TradeRoutesByIdentifier.Num() != CompanyTradeRoutes.Num())
+	{
+		FLOGV("WARNING : %s lookup indices have %d spacecrafts, %d fleets and %d trade routes for %d, %d and %d",
+			*GetCompanyName().ToString(),
+			SpacecraftsByImmatriculation.Num(), FleetsByIdentifier.Num(), TradeRoutesByIdentifier.Num(),
+			CompanySpacecrafts.Num(), CompanyFleets.Num(), CompanyTradeRoutes.Num());
+		Integrity = false;
+	}
+
 	for (int i = 0; i < CompanySpacecrafts.Num(); i++)
 	{
-		if (CompanySpacecrafts[i]->GetImmatriculation() == ShipImmatriculation)
+		if (FindSpacecraft(CompanySpacecrafts[i]->GetImmatriculation()) != CompanySpacecrafts[i])
+		{
+			FLOGV("WARNING : %s is not indexed by %s", *CompanySpacecrafts[i]->GetImmatriculation().ToString(), *GetCompanyName().ToString());
+			Integrity = false;
+		}
+	}
+
+	for (int i = 0; i < CompanyFleets.Num(); i++)
+	{
+		if (FindFleet(CompanyFleets[i]->GetIdentifier()) != CompanyFleets[i])
+		{
+			FLOGV("WARNING : fleet %s is not indexed by %s", *CompanyFleets[i]->GetIdentifier().ToString(), *GetCompanyName().ToString());
+			Integrity = false;
+		}
+	}
+
+	for (int i = 0; i < CompanyTradeRoutes.Num(); i++)
+	{
+		if (FindTradeRoute(CompanyTradeRoutes[i]->GetIdentifier()) != CompanyTradeRoutes[i])
 		{
-			return CompanySpacecrafts[i];
+			FLOGV("WARNING : trade route %s is not indexed by %s", *CompanyTradeRoutes[i]->GetIdentifier().ToString(), *GetCompanyName().ToString());
+			Integrity = false;
 		}
 	}
 
-	return NULL;
+	return Integrity;
 }
 
 bool UFlareCompany::HasVisitedSector(const UFlareSimulatedSector* Sector) const
@@ -782,15 +797,12 @@ bool UFlareCompany::HasVisitedSector(const UFlareSimulatedSector* Sector) const
 
 float UFlareCompany::GetReputation(UFlareCompany* Company)
 {
-	for (int32 CompanyIndex = 0; CompanyIndex < CompanyData.CompaniesReputation.Num(); CompanyIndex++)
+	if (Company == this)
 	{
-		if(Company->GetIdentifier() == CompanyData.CompaniesReputation[CompanyIndex].CompanyIdentifier)
-		{
-			return CompanyData.CompaniesReputation[CompanyIndex].Reputation;
-		}
+		return 0;
 	}
 
-	return 0;
+	return Game->GetGameWorld()->GetCompanyRelations().GetReputation(CompanySlot, Company->GetCompanySlot());
 }
 
 FText UFlareCompany::GetPlayerHostilityText() const
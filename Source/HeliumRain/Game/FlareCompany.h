@@ -105,6 +105,9 @@ public:
 	/** Load a trade route from save */
 	virtual UFlareTradeRoute* LoadTradeRoute(const FFlareTradeRouteSave& TradeRouteData);
 
+	/** Load the saved reputation and hostility of this company toward another one into the world relations */
+	virtual void LoadRelations(UFlareCompany* TargetCompany);
+
 
 	/*----------------------------------------------------
 		Gameplay
@@ -215,6 +218,11 @@ protected:
 	UPROPERTY()
 	TArray<UFlareTradeRoute*>               CompanyTradeRoutes;
 
+	/** Lookup indices, kept in sync with the lists above */
+	TMap<FName, UFlareSimulatedSpacecraft*> SpacecraftsByImmatriculation;
+	TMap<FName, UFlareFleet*>               FleetsByIdentifier;
+	TMap<FName, UFlareTradeRoute*>          TradeRoutesByIdentifier;
+
 	UPROPERTY()
 	UMaterialInstanceDynamic*               CompanyEmblem;
 
@@ -225,6 +233,9 @@ protected:
 	TArray<UFlareSimulatedSector*>          KnownSectors;
 	TArray<UFlareSimulatedSector*>          VisitedSectors;
 
+	/** Index of this company in the world relations */
+	int32                                   CompanySlot;
+
 
 public:
 
@@ -336,34 +347,36 @@ public:
 
 	UFlareFleet* FindFleet(FName Identifier) const
 	{
-		for (int i = 0; i < CompanyFleets.Num(); i++)
-		{
-			if (CompanyFleets[i]->GetIdentifier() == Identifier)
-			{
-				return CompanyFleets[i];
-			}
-		}
-		return NULL;
+		return FleetsByIdentifier.FindRef(Identifier);
 	}
 
 	UFlareTradeRoute* FindTradeRoute(FName Identifier) const
 	{
-		for (int i = 0; i < CompanyTradeRoutes.Num(); i++)
-		{
-			if (CompanyTradeRoutes[i]->GetIdentifier() == Identifier)
-			{
-				return CompanyTradeRoutes[i];
-			}
-		}
-		return NULL;
+		return TradeRoutesByIdentifier.FindRef(Identifier);
+	}
+
+	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation) const
+	{
+		return SpacecraftsByImmatriculation.FindRef(ShipImmatriculation);
 	}
 
-	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation);
+	/** Check the lookup indices against the company lists */
+	bool CheckLookupIndices() const;
 
 	bool HasVisitedSector(const UFlareSimulatedSector* Sector) const;
 
 	float GetReputation(UFlareCompany* Company);
 
+	inline int32 GetCompanySlot() const
+	{
+		return CompanySlot;
+	}
+
+	inline void SetCompanySlot(int32 Slot)
+	{
+		CompanySlot = Slot;
+	}
+
 	inline UFlareCompanyAI* GetAI()
 	{
 		return CompanyAI;
@@ -0,0 +1,121 @@
+
+#include "../Flare.h"
+
+#include "FlareCompanyRelations.h"
+
+
+#define REPUTATION_RANGE 200.f
+
+
+/*----------------------------------------------------
+	Relations
+----------------------------------------------------*/
+
+void FFlareCompanyRelations::SetCompanyCount(int32 Count)
+{
+	if (Count == CompanyCount)
+	{
+		return;
+	}
+
+	TArray<float> OldReputations = Reputations;
+	TArray<uint8> OldHostilities = Hostilities;
+	int32 CopiedCount = FMath::Min(Count, CompanyCount);
+
+	Reputations.Empty(Count * Count);
+	Reputations.SetNumZeroed(Count * Count);
+	Hostilities.Empty(Count * Count);
+	Hostilities.SetNumZeroed(Count * Count);
+
+	for (int32 Owner = 0; Owner < CopiedCount; Owner++)
+	{
+		for (int32 Target = 0; Target < CopiedCount; Target++)
+		{
+			Reputations[Owner * Count + Target] = OldReputations[Owner * CompanyCount + Target];
+			Hostilities[Owner * Count + Target] = OldHostilities[Owner * CompanyCount + Target];
+		}
+	}
+
+	CompanyCount = Count;
+}
+
+float FFlareCompanyRelations::GiveReputation(int32 Owner, int32 Target, float Amount)
+{
+	float& Reputation = Reputations[Owner * CompanyCount + Target];
+	float ReputationScaledGain = GetReputationGain(Reputation, Amount);
+
+	Reputation = FMath::Clamp(Reputation + ReputationScaledGain, -REPUTATION_RANGE, REPUTATION_RANGE);
+	if (FMath::Abs(Reputation) < 1.f)
+	{
+		Reputation = 0.f;
+	}
+
+	return ReputationScaledGain;
+}
+
+void FFlareCompanyRelations::PropagateReputation(int32 Source, int32 Target, float ScaledGain)
+{
+	// Other companies gain a part of reputation gain according to their affinity :
+	// 200 = 50 % of the gain
+	// -200 = -50 % of the gain
+	// 0 = 0% the the gain
+	for (int32 Owner = 0; Owner < CompanyCount; Owner++)
+	{
+		if (Owner == Target || Owner == Source)
+		{
+			continue;
+		}
+
+		float PropagationRatio = GetReputation(Owner, Target) / 400.f;
+		GiveReputation(Owner, Target, PropagationRatio * ScaledGain);
+	}
+}
+
+void FFlareCompanyRelations::StabilizeReputations(float Amount)
+{
+	for (int32 Owner = 0; Owner < CompanyCount; Owner++)
+	{
+		for (int32 Target = 0; Target < CompanyCount; Target++)
+		{
+			float Reputation = Reputations[Owner * CompanyCount + Target];
+			if (Owner != Target && Reputation != 0.f)
+			{
+				GiveReputation(Owner, Target, -Amount * FMath::Sign(Reputation));
+			}
+		}
+	}
+}
+
+float FFlareCompanyRelations::GetReputationGain(float Reputation, float Amount)
+{
+	// Gain reputation is easier with low reputation and loose reputation is easier with hight reputation.
+	// Reputation vary between -200 and 200
+	// 0% if reputation in variation direction = 200
+	// 10% if reputation in variation direction = 100
+	// 100% if reputation in variation direction = 0
+	// 200% if reputation in variation direction = -100
+	// 1000% if reputation in variation direction = -200
+
+	// -200 = 0, 200 = 1
+	float ReputationRatioInVarationDirection = (Reputation * FMath::Sign(Amount) + REPUTATION_RANGE) / (2*REPUTATION_RANGE);
+	float ReputationGainFactor = 1.f;
+
+	if (ReputationRatioInVarationDirection < 0.25f)
+	{
+		ReputationGainFactor = - 32.f * ReputationRatioInVarationDirection + 10.f;
+	}
+	else if (ReputationRatioInVarationDirection < 0.50f)
+	{
+		ReputationGainFactor = - 4.f * ReputationRatioInVarationDirection + 3.f;
+	}
+	else if (ReputationRatioInVarationDirection < 0.75f)
+	{
+		ReputationGainFactor = - 3.6f * ReputationRatioInVarationDirection + 2.8f;
+	}
+	else
+	{
+		ReputationGainFactor = - 0.4f * ReputationRatioInVarationDirection + 0.4f;
+	}
+
+	return Amount * ReputationGainFactor;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+
+/** Reputation and hostility between all companies, indexed by company slot */
+struct FFlareCompanyRelations
+{
+	FFlareCompanyRelations()
+		: CompanyCount(0)
+	{}
+
+	/** Resize for a new company count, keeping the relations of the existing slots */
+	void SetCompanyCount(int32 Count);
+
+	/** Apply a reputation variation of Owner toward Target, and return the gain after scaling */
+	float GiveReputation(int32 Owner, int32 Target, float Amount);
+
+	/** Let the other companies follow a reputation gain toward Target, according to their own reputation toward it */
+	void PropagateReputation(int32 Source, int32 Target, float ScaledGain);
+
+	/** Move every reputation toward zero */
+	void StabilizeReputations(float Amount);
+
+	/** Scale a reputation variation : easier from a low reputation, harder from a high one */
+	static float GetReputationGain(float Reputation, float Amount);
+
+	inline int32 GetCompanyCount() const
+	{
+		return CompanyCount;
+	}
+
+	inline float GetReputation(int32 Owner, int32 Target) const
+	{
+		return Reputations[Owner * CompanyCount + Target];
+	}
+
+	inline void SetReputation(int32 Owner, int32 Target, float Reputation)
+	{
+		Reputations[Owner * CompanyCount + Target] = Reputation;
+	}
+
+	inline bool IsHostile(int32 Owner, int32 Target) const
+	{
+		return Hostilities[Owner * CompanyCount + Target] != 0;
+	}
+
+	inline void SetHostile(int32 Owner, int32 Target, bool Hostile)
+	{
+		Hostilities[Owner * CompanyCount + Target] = Hostile ? 1 : 0;
+	}
+
+protected:
+
+	int32                                    CompanyCount;
+
+	/** Reputation of the row company toward the column company */
+	TArray<float>                            Reputations;
+
+	/** Hostility of the row company toward the column company */
+	TArray<uint8>                            Hostilities;
+
+};
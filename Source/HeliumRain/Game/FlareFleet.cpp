@@ -3,6 +3,7 @@
 #include "FlareFleet.h"
 #include "FlareCompany.h"
 #include "FlareSimulatedSector.h"
+#include "FlareGame.h"
 
 
 #define LOCTEXT_NAMESPACE "FlareFleet"
@@ -171,6 +172,7 @@ void UFlareFleet::AddShip(UFlareSimulatedSpacecraft* Ship)
 	FleetData.ShipImmatriculations.Add(Ship->GetImmatriculation());
 	FleetShips.AddUnique(Ship);
 	Ship->SetCurrentFleet(this);
+	Game->GetGameWorld()->MarkCompanyDirty(FleetCompany);
 }
 
 void UFlareFleet::RemoveShip(UFlareSimulatedSpacecraft* Ship, bool destroyed)
@@ -184,6 +186,7 @@ void UFlareFleet::RemoveShip(UFlareSimulatedSpacecraft* Ship, bool destroyed)
 	FleetData.ShipImmatriculations.Remove(Ship->GetImmatriculation());
 	FleetShips.Remove(Ship);
 	Ship->SetCurrentFleet(NULL);
+	Game->GetGameWorld()->MarkCompanyDirty(FleetCompany);
 
 	if (!destroyed)
 	{
@@ -272,6 +275,7 @@ void UFlareFleet::SetCurrentSector(UFlareSimulatedSector* Sector)
 		CurrentTravel = NULL;
 	}
 	InitShipList();
+	Game->GetGameWorld()->MarkCompanyDirty(FleetCompany);
 }
 
 void UFlareFleet::SetCurrentTravel(UFlareTravel* Travel)
@@ -279,6 +283,7 @@ void UFlareFleet::SetCurrentTravel(UFlareTravel* Travel)
 	CurrentSector = Travel->GetTravelSector();
 	CurrentTravel = Travel;
 	InitShipList();
+	Game->GetGameWorld()->MarkCompanyDirty(FleetCompany);
 	for (int ShipIndex = 0; ShipIndex < FleetShips.Num(); ShipIndex++)
 	{
 		FleetShips[ShipIndex]->SetSpawnMode(EFlareSpawnMode::Travel);
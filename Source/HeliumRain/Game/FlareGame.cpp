@@ -270,8 +270,7 @@ void AFlareGame::Scrap(FName ShipImmatriculation, FName TargetStationImmatricula
 
 	if (ScrapingStation->GetCompany() != ShipToScrap->GetCompany())
 	{
-		ScrapingStation->GetCompany()->TakeMoney(ScrapRevenue);
-		ShipToScrap->GetCompany()->GiveMoney(ScrapRevenue);
+		World->GetMoneyLedger().Transfer(ScrapingStation->GetCompany(), ShipToScrap->GetCompany(), ScrapRevenue, EFlareMoneyReason::Scrap);
 		GetPC()->Notify(LOCTEXT("ShipSellScrap", "Ship scrap complete"),
 			FText::Format(LOCTEXT("ShipSellScrapFormat", "Your ship {0} has been scrapped for {1} credits!"), FText::FromString(ShipToScrap->GetImmatriculation().ToString()), FText::AsNumber(UFlareGameTools::DisplayMoney(ScrapRevenue))),
 			FName("ship-own-scraped"),
@@ -6,6 +6,7 @@
 #include "../Player/FlarePlayerController.h"
 #include "FlareCompany.h"
 #include "FlareSectorHelper.h"
+#include "FlareSimulationBenchmark.h"
 
 #define LOCTEXT_NAMESPACE "FlareGameTools"
 
@@ -154,6 +155,189 @@ void UFlareGameTools::Simulate()
 	GetGame()->ActivateCurrentSector();
 }
 
+void UFlareGameTools::BenchmarkSimulation(int32 Days)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::BenchmarkSimulation failed: no loaded world");
+		return;
+	}
+
+	if (GetActiveSector())
+	{
+		FLOG("AFlareGame::BenchmarkSimulation failed: a sector is active");
+		return;
+	}
+
+	SimulationBenchmark::Run(GetGameWorld(), Days, SimulationBenchmark::GetDefaultOutputPath());
+}
+
+void UFlareGameTools::PrintSimulationStats(int32 Days)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::PrintSimulationStats failed: no loaded world");
+		return;
+	}
+
+	const TArray<FFlareSimulationTimings>& History = GetGameWorld()->GetSimulationHistory();
+	int32 FirstIndex = FMath::Max(0, History.Num() - Days);
+
+	FLOGV("> PrintSimulationStats: %d days (times in ms)", History.Num() - FirstIndex);
+	FLOG("  Date   | AI      | Factory | People  | Routes  | Travels | Prices  | Money   | Total   | Travel calls | Quantity calls | Trade calls");
+	for (int32 DayIndex = FirstIndex; DayIndex < History.Num(); DayIndex++)
+	{
+		const FFlareSimulationTimings& Timings = History[DayIndex];
+		FLOGV("  %6lld | %7.2f | %7.2f | %7.2f | %7.2f | %7.2f | %7.2f | %7.2f | %7.2f | %12d | %14d | %11d",
+			Timings.Date,
+			Timings.AI * 1000, Timings.Factories * 1000, Timings.People * 1000, Timings.TradeRoutes * 1000,
+			Timings.Travels * 1000, Timings.PriceVariation * 1000, Timings.MoneyMigration * 1000, Timings.Total * 1000,
+			Timings.ComputeTravelDurationCalls, Timings.GetResourceQuantityCalls, Timings.FindTradeStationCalls);
+	}
+}
+
+void UFlareGameTools::SetParallelSimulation(bool Parallel)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetParallelSimulation failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetParallelSimulation(Parallel);
+}
+
+void UFlareGameTools::SetPooledMoneyMigration(bool Pooled)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetPooledMoneyMigration failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetPooledMoneyMigration(Pooled);
+}
+
+void UFlareGameTools::SetBatchedPriceVariation(bool Batched)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetBatchedPriceVariation failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetBatchedPriceVariation(Batched);
+}
+
+void UFlareGameTools::SetSharedResourceVariation(bool Shared)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetSharedResourceVariation failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetSharedResourceVariation(Shared);
+}
+
+void UFlareGameTools::SetPrunedDealSearch(bool Pruned)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetPrunedDealSearch failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetPrunedDealSearch(Pruned);
+}
+
+void UFlareGameTools::SetParallelAIPlanning(bool Parallel)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetParallelAIPlanning failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetParallelAIPlanning(Parallel);
+}
+
+void UFlareGameTools::SetAuctionCargoAssignment(bool Auction)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetAuctionCargoAssignment failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetAuctionCargoAssignment(Auction);
+}
+
+void UFlareGameTools::SetBulkFastForward(bool Bulk)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetBulkFastForward failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetBulkFastForward(Bulk);
+}
+
+void UFlareGameTools::SetIntegrityAuditPeriod(int32 Days)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetIntegrityAuditPeriod failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetIntegrityAuditPeriod(Days);
+}
+
+void UFlareGameTools::SetLookupValidation(bool Validate)
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::SetLookupValidation failed: no loaded world");
+		return;
+	}
+
+	GetGameWorld()->SetLookupValidation(Validate);
+}
+
+void UFlareGameTools::CheckWorldIntegrity()
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::CheckWorldIntegrity failed: no loaded world");
+		return;
+	}
+
+	bool Integrity = GetGameWorld()->CheckIntegrity();
+	FLOGV("> CheckWorldIntegrity: %s", Integrity ? TEXT("OK") : TEXT("failures found"));
+}
+
+void UFlareGameTools::PrintMoneyLedger()
+{
+	if (!GetGameWorld())
+	{
+		FLOG("AFlareGame::PrintMoneyLedger failed: no loaded world");
+		return;
+	}
+
+	const FFlareMoneyLedger& Ledger = GetGameWorld()->GetMoneyLedger();
+
+	FLOGV("> PrintMoneyLedger: world money %lld, %d transfers today", Ledger.GetWorldMoney(), Ledger.GetDayTransfers().Num());
+	FLOG("  Reason           | Today          | Since load");
+	for (int32 Reason = 0; Reason < EFlareMoneyReason::Count; Reason++)
+	{
+		EFlareMoneyReason::Type ReasonType = (EFlareMoneyReason::Type) Reason;
+		FLOGV("  %-16s | %14lld | %14lld", FFlareMoneyLedger::GetReasonName(ReasonType),
+			Ledger.GetReasonDayTotal(ReasonType), Ledger.GetReasonTotal(ReasonType));
+	}
+}
+
 void UFlareGameTools::SetPlanatariumTimeMultiplier(float Multiplier)
 {
 	GetGame()->GetPlanetarium()->SetTimeMultiplier(Multiplier);
@@ -1033,7 +1217,7 @@ void UFlareGameTools::TakeMoney(FName CompanyShortName, int64 Amount)
 		return;
 	}
 
-	Company->TakeMoney(Amount);
+	GetGameWorld()->GetMoneyLedger().Transfer(Company, NULL, Amount, EFlareMoneyReason::Grant);
 }
 
 void UFlareGameTools::GiveMoney(FName CompanyShortName, int64 Amount)
@@ -1051,7 +1235,7 @@ void UFlareGameTools::GiveMoney(FName CompanyShortName, int64 Amount)
 		return;
 	}
 
-	Company->GiveMoney(Amount);
+	GetGameWorld()->GetMoneyLedger().Transfer(NULL, Company, Amount, EFlareMoneyReason::Grant);
 }
 
 void UFlareGameTools::TransferResources(FName SourceImmatriculation, FName DestinationImmatriculation, FName ResourceIdentifier, uint32 Quantity)
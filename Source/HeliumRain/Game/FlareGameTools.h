@@ -60,6 +60,62 @@ public:
 	UFUNCTION(exec)
 	void Simulate();
 
+	/** Simulate some days and write the phase timings to the benchmark report */
+	UFUNCTION(exec)
+	void BenchmarkSimulation(int32 Days);
+
+	/** Print the phase timings and hot call counts of the last simulated days */
+	UFUNCTION(exec)
+	void PrintSimulationStats(int32 Days);
+
+	/** Enable or disable the parallel sector simulation */
+	UFUNCTION(exec)
+	void SetParallelSimulation(bool Parallel);
+
+	/** Use the pooled people money migration, or the legacy pairwise one */
+	UFUNCTION(exec)
+	void SetPooledMoneyMigration(bool Pooled);
+
+	/** Vary the prices in one world table, or sector by sector */
+	UFUNCTION(exec)
+	void SetBatchedPriceVariation(bool Batched);
+
+	/** Share the daily sector resource variations between all AI companies, or scan the world for each one */
+	UFUNCTION(exec)
+	void SetSharedResourceVariation(bool Shared);
+
+	/** Skip the AI deals that can't beat the best deal found, or evaluate all of them */
+	UFUNCTION(exec)
+	void SetPrunedDealSearch(bool Pruned);
+
+	/** Plan the AI of all companies in parallel, or each company at its turn */
+	UFUNCTION(exec)
+	void SetParallelAIPlanning(bool Parallel);
+
+	/** Assign the idle AI cargos by auction, or greedily one ship at a time */
+	UFUNCTION(exec)
+	void SetAuctionCargoAssignment(bool Auction);
+
+	/** Fast forward in spans of days, or simulate every day fully */
+	UFUNCTION(exec)
+	void SetBulkFastForward(bool Bulk);
+
+	/** Audit the whole world integrity every Days days, 0 to only check modified entities */
+	UFUNCTION(exec)
+	void SetIntegrityAuditPeriod(int32 Days);
+
+	/** Check all the lookup indices at each integrity audit */
+	UFUNCTION(exec)
+	void SetLookupValidation(bool Validate);
+
+	/** Check the whole world integrity now */
+	UFUNCTION(exec)
+	void CheckWorldIntegrity();
+
+	/** Print the world money and the money moved by reason */
+	UFUNCTION(exec)
+	void PrintMoneyLedger();
+
 	/** Configure time multiplier for active sector planetarium */
 	UFUNCTION(exec)
 	void SetPlanatariumTimeMultiplier(float Multiplier);
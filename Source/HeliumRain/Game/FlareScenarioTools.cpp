@@ -145,7 +145,7 @@ void UFlareScenarioTools::GenerateDebugScenario()
 
 	CreatePlayerShip(MinersHome, "ship-omen");
 	CreatePlayerShip(FrozenRealm, "ship-omen");
-	PlayerCompany->GiveMoney(10000000);
+	GrantMoney(PlayerCompany, 10000000);
 	CreateStations(StationIceMine, PlayerCompany, FrozenRealm, 1);
 	CreateStations(StationIceMine, PlayerCompany, MinersHome, 1);
 }
@@ -180,13 +180,13 @@ void UFlareScenarioTools::SetupWorld()
 	PlayerCompany->DiscoverSector(Solitude);
 
 	// Company setup
-	PlayerCompany->GiveMoney(5000000);
-	MiningSyndicate->GiveMoney(100000000);
-	HelixFoundries->GiveMoney(100000000);
-	Sunwatch->GiveMoney(100000000);
-	UnitedFarmsChemicals->GiveMoney(100000000);
-	IonLane->GiveMoney(100000000);
-	GhostWorksShipyards->GiveMoney(100000000);
+	GrantMoney(PlayerCompany, 5000000);
+	GrantMoney(MiningSyndicate, 100000000);
+	GrantMoney(HelixFoundries, 100000000);
+	GrantMoney(Sunwatch, 100000000);
+	GrantMoney(UnitedFarmsChemicals, 100000000);
+	GrantMoney(IonLane, 100000000);
+	GrantMoney(GhostWorksShipyards, 100000000);
 
 	// Population setup
 	BlueHeart->GetPeople()->GiveBirth(3000);
@@ -389,4 +389,9 @@ void UFlareScenarioTools::CreateStations(FName StationClass, UFlareCompany* Comp
 	}
 }
 
+void UFlareScenarioTools::GrantMoney(UFlareCompany* Company, int64 Amount)
+{
+	World->GetMoneyLedger().Transfer(NULL, Company, Amount, EFlareMoneyReason::Grant);
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -63,6 +63,9 @@ protected:
 	/** Create a station and fill its input */
 	void CreateStations(FName StationClass, UFlareCompany* Company, UFlareSimulatedSector* Sector, uint32 Count);
 
+	/** Give starting money to a company */
+	void GrantMoney(UFlareCompany* Company, int64 Amount);
+
 
 	/*----------------------------------------------------
 		Protected data
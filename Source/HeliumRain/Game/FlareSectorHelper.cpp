@@ -2,9 +2,12 @@
 #include "FlareSectorHelper.h"
 #include "../Economy/FlareCargoBay.h"
 #include "FlareCompany.h"
+#include "FlareGame.h"
 
 UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Request)
 {
+	FLARE_COUNT_CALL(FindTradeStation);
+
 	if(!Request.Client || !Request.Client->GetCurrentSector())
 	{
 		FLOG("Invalid find trade query");
@@ -12,7 +15,6 @@ UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Req
 	}
 
 	UFlareSimulatedSector* Sector = Request.Client->GetCurrentSector();
-	TArray<UFlareSimulatedSpacecraft*>& SectorStations = Sector->GetSectorStations();
 
 	float UnloadQuantityScoreMultiplier = 0;
 	float LoadQuantityScoreMultiplier = 0;
@@ -56,22 +58,21 @@ UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Req
 	uint32 AvailableQuantity = Request.Client->GetCargoBay()->GetResourceQuantity(Request.Resource);
 	uint32 FreeSpace = Request.Client->GetCargoBay()->GetFreeSpaceForResource(Request.Resource);
 
-	for (int32 StationIndex = 0; StationIndex < SectorStations.Num(); StationIndex++)
+	// Only the stations with stock or free space for the resource can score
+	const TArray<FFlareTradeCandidate>& Candidates = Sector->GetTradeCandidates(Request.Resource);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); CandidateIndex++)
 	{
-		UFlareSimulatedSpacecraft* Station = SectorStations[StationIndex];
+		const FFlareTradeCandidate& Candidate = Candidates[CandidateIndex];
+		UFlareSimulatedSpacecraft* Station = Candidate.Station;
 
 		if(!Request.Client->CanTradeWith(Station))
 		{
 			continue;
 		}
 
-		uint32 StationFreeSpace = Station->GetCargoBay()->GetFreeSpaceForResource(Request.Resource);
-		uint32 StationResourceQuantity = Station->GetCargoBay()->GetResourceQuantity(Request.Resource);
-
-		if (StationFreeSpace == 0 && StationResourceQuantity == 0)
-		{
-			continue;
-		}
+		uint32 StationFreeSpace = Candidate.FreeSpace;
+		uint32 StationResourceQuantity = Candidate.Quantity;
 
 		float Score = 0;
 		float FullRatio =  (float) StationResourceQuantity / (float) (StationResourceQuantity + StationFreeSpace);
@@ -80,13 +81,13 @@ UFlareSimulatedSpacecraft*  SectorHelper::FindTradeStation(FlareTradeRequest Req
 		uint32 LoadMaxQuantity  = 0;
 
 
-		if(Station->GetCargoBay()->WantBuy(Request.Resource))
+		if(Candidate.WantBuy)
 		{
 			UnloadMaxQuantity = StationFreeSpace;
 			UnloadMaxQuantity  = FMath::Max(UnloadMaxQuantity , AvailableQuantity);
 		}
 
-		if(Station->GetCargoBay()->WantSell(Request.Resource))
+		if(Candidate.WantSell)
 		{
 			LoadMaxQuantity = StationResourceQuantity;
 			LoadMaxQuantity = FMath::Max(LoadMaxQuantity , FreeSpace);
@@ -154,6 +155,7 @@ int32 SectorHelper::Trade(UFlareSimulatedSpacecraft*  SourceSpacecraft, UFlareSi
 		int64 Price = ResourcePrice * GivenResources;
 		DestinationSpacecraft->GetCompany()->TakeMoney(Price);
 		SourceSpacecraft->GetCompany()->GiveMoney(Price);
+		SourceSpacecraft->GetGame()->GetGameWorld()->GetMoneyLedger().RecordTransfer(DestinationSpacecraft->GetCompany(), SourceSpacecraft->GetCompany(), Price, EFlareMoneyReason::Trade);
 
 		SourceSpacecraft->GetCompany()->GiveReputation(DestinationSpacecraft->GetCompany(), 0.5f, true);
 		DestinationSpacecraft->GetCompany()->GiveReputation(SourceSpacecraft->GetCompany(), 0.5f, true);
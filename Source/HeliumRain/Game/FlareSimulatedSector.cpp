@@ -18,6 +18,11 @@ UFlareSimulatedSector::UFlareSimulatedSector(const FObjectInitializer& ObjectIni
 	: Super(ObjectInitializer)
 {
 	PersistentStationIndex = 0;
+	SectorSlot = -1;
+	SimulationBuffer = NULL;
+	StockCompanyCount = 0;
+	ResourceUsesDirty = true;
+	TradeCandidateScans = 0;
 }
 
 void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, const FFlareSectorSave& Data, const FFlareSectorOrbitParameters& OrbitParameters)
@@ -36,10 +41,16 @@ void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, con
 	SectorData = Data;
 	SectorDescription = Description;
 	SectorOrbitParameters = OrbitParameters;
+	for (int i = 0 ; i < SectorSpacecrafts.Num(); i++)
+	{
+		RemoveCargoStock(SectorSpacecrafts[i]);
+	}
 	SectorShips.Empty();
 	SectorStations.Empty();
 	SectorSpacecrafts.Empty();
 	SectorFleets.Empty();
+	InvalidateResourceUses();
+	InvalidateTradeCandidates();
 
 	FFlareCelestialBody* Body = Game->GetGameWorld()->GetPlanerarium()->FindCelestialBody(SectorOrbitParameters.CelestialBodyIdentifier);
 	if (Body)
@@ -72,6 +83,7 @@ void UFlareSimulatedSector::Load(const FFlareSectorDescription* Description, con
 			SectorShips.Add(Spacecraft);
 		}
 		SectorSpacecrafts.Add(Spacecraft);
+		AddCargoStock(Spacecraft);
 		Spacecraft->SetCurrentSector(this);
 	}
 
@@ -311,12 +323,15 @@ UFlareSimulatedSpacecraft* UFlareSimulatedSector::CreateShip(FFlareSpacecraftDes
 	if (Spacecraft->IsStation())
 	{
 		SectorStations.Add(Spacecraft);
+		InvalidateResourceUses();
 	}
 	else
 	{
 		SectorShips.Add(Spacecraft);
 	}
 	SectorSpacecrafts.Add(Spacecraft);
+	AddCargoStock(Spacecraft);
+	Game->GetGameWorld()->MarkSectorDirty(this);
 
 	Spacecraft->SetCurrentSector(this);
 
@@ -361,12 +376,15 @@ void UFlareSimulatedSector::CreateAsteroid(int32 ID, FName Name, FVector Locatio
 void UFlareSimulatedSector::AddFleet(UFlareFleet* Fleet)
 {
 	SectorFleets.AddUnique(Fleet);
+	Game->GetGameWorld()->MarkSectorDirty(this);
+	Game->GetGameWorld()->MarkCompanyDirty(Fleet->GetFleetCompany());
 
 	for (int ShipIndex = 0; ShipIndex < Fleet->GetShips().Num(); ShipIndex++)
 	{
 		Fleet->GetShips()[ShipIndex]->SetCurrentSector(this);
 		SectorShips.AddUnique(Fleet->GetShips()[ShipIndex]);
 		SectorSpacecrafts.AddUnique(Fleet->GetShips()[ShipIndex]);
+		AddCargoStock(Fleet->GetShips()[ShipIndex]);
 	}
 }
 
@@ -402,7 +420,11 @@ void UFlareSimulatedSector::RetireFleet(UFlareFleet* Fleet)
 
 int UFlareSimulatedSector::RemoveSpacecraft(UFlareSimulatedSpacecraft* Spacecraft)
 {
+	Game->GetGameWorld()->MarkSectorDirty(this);
+	Game->GetGameWorld()->MarkCompanyDirty(Spacecraft->GetCompany());
 	SectorSpacecrafts.Remove(Spacecraft);
+	RemoveCargoStock(Spacecraft);
+	InvalidateResourceUses();
 	return SectorShips.Remove(Spacecraft);
 }
 
@@ -599,13 +621,11 @@ UFlareSimulatedSpacecraft* UFlareSimulatedSector::BuildStation(FFlareSpacecraftD
 	int64 ProductionCost = GetStationConstructionFee(StationDescription->CycleCost.ProductionCost);
 
 	// Pay station cost
-	if (!Company->TakeMoney(ProductionCost))
+	if (!Game->GetGameWorld()->GetMoneyLedger().Transfer(Company, GetPeople(), ProductionCost, EFlareMoneyReason::Construction))
 	{
 		return NULL;
 	}
 
-	GetPeople()->Pay(ProductionCost);
-
 	// Take resource cost
 	for (int ResourceIndex = 0; ResourceIndex < StationDescription->CycleCost.InputResources.Num(); ResourceIndex++)
 	{
@@ -751,13 +771,11 @@ bool UFlareSimulatedSector::UpgradeStation(UFlareSimulatedSpacecraft* Station)
 	int64 ProductionCost = Station->GetStationUpgradeFee();
 
 	// Pay station cost
-	if(!Company->TakeMoney(ProductionCost))
+	if (!Game->GetGameWorld()->GetMoneyLedger().Transfer(Company, GetPeople(), ProductionCost, EFlareMoneyReason::Construction))
 	{
 		return false;
 	}
 
-	GetPeople()->Pay(ProductionCost);
-
 	// Take resource cost
 	for (int ResourceIndex = 0; ResourceIndex < Station->GetDescription()->CycleCost.InputResources.Num(); ResourceIndex++)
 	{
@@ -822,145 +840,467 @@ void UFlareSimulatedSector::AttachStationToAsteroid(UFlareSimulatedSpacecraft* S
 	}
 }
 
-void UFlareSimulatedSector::SimulatePriceVariation()
+void UFlareSimulatedSector::RecordMoneyTransfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason)
 {
-	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	if (SimulationBuffer)
 	{
-		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-		SimulatePriceVariation(Resource);
+		SimulationBuffer->RecordTransfer(Source, Destination, Amount, Reason);
+	}
+	else
+	{
+		Game->GetGameWorld()->GetMoneyLedger().RecordTransfer(Source, Destination, Amount, Reason);
 	}
 }
 
-void UFlareSimulatedSector::SimulatePriceVariation(FFlareResourceDescription* Resource)
+
+/*----------------------------------------------------
+	Company stocks
+----------------------------------------------------*/
+
+void UFlareSimulatedSector::AddCargoStock(UFlareSimulatedSpacecraft* Spacecraft)
 {
-	float OldPrice = GetPreciseResourcePrice(Resource);
-	// Prices can increase because :
+	UFlareCargoBay* CargoBay = Spacecraft->GetCargoBay();
+	if (CargoBay->GetStockSector() == this)
+	{
+		return;
+	}
+	else if (CargoBay->GetStockSector())
+	{
+		CargoBay->GetStockSector()->RemoveCargoStock(Spacecraft);
+	}
 
-	//  - The input of a station is low (and less than half)
-	//  - Consumer ressource is low
-	//  - Maintenance ressource is low (and less than half)
+	ReserveCompanyStocks(Spacecraft->GetCompany()->GetCompanySlot());
 
+	for (int CargoIndex = 0; CargoIndex < CargoBay->GetSlots().Num(); CargoIndex++)
+	{
+		UpdateCargoStock(Spacecraft, CargoBay->GetSlots()[CargoIndex], 1);
+	}
+	CargoBay->SetStockSector(this);
+}
 
-	// Prices can decrease because :
-	//  - Output of a station is full (and more than half)
-	//  - Consumer ressource is full (and more than half)
-	//  - Maintenance ressource is full (and more than half) (very slow decrease)
+void UFlareSimulatedSector::RemoveCargoStock(UFlareSimulatedSpacecraft* Spacecraft)
+{
+	UFlareCargoBay* CargoBay = Spacecraft->GetCargoBay();
+	if (CargoBay->GetStockSector() != this)
+	{
+		return;
+	}
 
+	for (int CargoIndex = 0; CargoIndex < CargoBay->GetSlots().Num(); CargoIndex++)
+	{
+		UpdateCargoStock(Spacecraft, CargoBay->GetSlots()[CargoIndex], -1);
+	}
+	CargoBay->SetStockSector(NULL);
+}
 
-	float WantedVariation = 0;
-	float WantedTotal = 0;
+void UFlareSimulatedSector::UpdateCargoStock(UFlareSimulatedSpacecraft* Spacecraft, const FFlareCargo& Cargo, int32 Sign)
+{
+	int32 CompanySlot = Spacecraft->GetCompany()->GetCompanySlot();
 
+	if (Spacecraft->IsStation())
+	{
+		// Empty slots give free space for any resource
+		InvalidateStationTradeCandidates(Spacecraft, Cargo.Resource);
 
-	// Prices never go below min production cost
-	for (int32 CountIndex = 0 ; CountIndex < SectorStations.Num(); CountIndex++)
+		if (Cargo.Resource == NULL)
+		{
+			StationEmptySlotCapacities[CompanySlot] += Sign * (int32) Cargo.Capacity;
+		}
+		else
+		{
+			int32 StockIndex = CompanySlot * Game->GetResourceCatalog()->Resources.Num() + Cargo.Resource->Index;
+			StationStocks[StockIndex] += Sign * (int32) Cargo.Quantity;
+			StationFreeSpaces[StockIndex] += Sign * ((int32) Cargo.Capacity - (int32) Cargo.Quantity);
+		}
+	}
+	else if (Cargo.Resource)
 	{
-		UFlareSimulatedSpacecraft* Station = SectorStations[CountIndex];
+		int32 StockIndex = CompanySlot * Game->GetResourceCatalog()->Resources.Num() + Cargo.Resource->Index;
+		ShipStocks[StockIndex] += Sign * (int32) Cargo.Quantity;
+	}
+}
 
-		float StockRatio = FMath::Clamp((float) Station->GetCargoBay()->GetResourceQuantity(Resource) / (float) Station->GetCargoBay()->GetSlotCapacity(), 0.f, 1.f);
+void UFlareSimulatedSector::ReserveCompanyStocks(int32 CompanySlot)
+{
+	if (CompanySlot < StockCompanyCount)
+	{
+		return;
+	}
+
+	// Tables are ordered by company, new companies are added at the end
+	StockCompanyCount = CompanySlot + 1;
+	int32 ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+	StationStocks.SetNumZeroed(StockCompanyCount * ResourceCount);
+	ShipStocks.SetNumZeroed(StockCompanyCount * ResourceCount);
+	StationFreeSpaces.SetNumZeroed(StockCompanyCount * ResourceCount);
+	StationEmptySlotCapacities.SetNumZeroed(StockCompanyCount);
+}
+
+bool UFlareSimulatedSector::CheckCargoStocks()
+{
+	bool Integrity = true;
+
+	TArray<int32> OldStationStocks = StationStocks;
+	TArray<int32> OldShipStocks = ShipStocks;
+	TArray<int32> OldStationFreeSpaces = StationFreeSpaces;
+	TArray<int32> OldStationEmptySlotCapacities = StationEmptySlotCapacities;
+
+	// Count again from the cargo bays
+	StationStocks.Init(0, StationStocks.Num());
+	ShipStocks.Init(0, ShipStocks.Num());
+	StationFreeSpaces.Init(0, StationFreeSpaces.Num());
+	StationEmptySlotCapacities.Init(0, StationEmptySlotCapacities.Num());
+
+	for (int SpacecraftIndex = 0; SpacecraftIndex < SectorSpacecrafts.Num(); SpacecraftIndex++)
+	{
+		UFlareSimulatedSpacecraft* Spacecraft = SectorSpacecrafts[SpacecraftIndex];
+		UFlareCargoBay* CargoBay = Spacecraft->GetCargoBay();
+
+		if (CargoBay->GetStockSector() != this)
+		{
+			FLOGV("WARNING : World integrity failure : cargo of %s is not counted in %s", *Spacecraft->GetImmatriculation().ToString(), *GetSectorName().ToString());
+			CargoBay->SetStockSector(this);
+			Integrity = false;
+		}
+
+		ReserveCompanyStocks(Spacecraft->GetCompany()->GetCompanySlot());
+		for (int CargoIndex = 0; CargoIndex < CargoBay->GetSlots().Num(); CargoIndex++)
+		{
+			UpdateCargoStock(Spacecraft, CargoBay->GetSlots()[CargoIndex], 1);
+		}
+	}
+
+	if (OldStationStocks != StationStocks || OldShipStocks != ShipStocks
+	 || OldStationFreeSpaces != StationFreeSpaces || OldStationEmptySlotCapacities != StationEmptySlotCapacities)
+	{
+		FLOGV("WARNING : World integrity failure : company stocks of %s don't match the cargo bays", *GetSectorName().ToString());
+		Integrity = false;
+	}
+
+	return Integrity;
+}
+
+
+/*----------------------------------------------------
+	Resource uses
+----------------------------------------------------*/
+
+const TArray<FFlareResourceUse>& UFlareSimulatedSector::GetResourceUses(FFlareResourceDescription* Resource)
+{
+	if (ResourceUsesDirty)
+	{
+		UpdateResourceUses();
+	}
+
+	return ResourceUses[Resource->Index];
+}
+
+void UFlareSimulatedSector::UpdateResourceUses()
+{
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	int32 ResourceCount = ResourceCatalog->Resources.Num();
+
+	ResourceUses.Empty(ResourceCount);
+	ResourceUses.SetNum(ResourceCount);
+
+	for (int32 StationIndex = 0 ; StationIndex < SectorStations.Num(); StationIndex++)
+	{
+		UFlareSimulatedSpacecraft* Station = SectorStations[StationIndex];
 
 		for (int32 FactoryIndex = 0; FactoryIndex < Station->GetFactories().Num(); FactoryIndex++)
 		{
 			UFlareFactory* Factory = Station->GetFactories()[FactoryIndex];
 
-			if(!Factory->IsActive())
+			// The cycle of a shipyard changes with the ship ordered, check it on use
+			if (Factory->IsShipyard())
 			{
+				for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+				{
+					FFlareResourceUse Use = { Station, Factory, EFlareResourcePriceContext::Default };
+					ResourceUses[ResourceIndex].Add(Use);
+				}
 				continue;
 			}
 
-
-			if (Factory->HasInputResource(Resource))
+			const FFlareProductionData& CycleData = Factory->GetCycleData();
+			for (int32 ResourceIndex = 0; ResourceIndex < CycleData.InputResources.Num(); ResourceIndex++)
 			{
-				if (StockRatio < 0.8f)
-				{
-					float Weight = Factory->GetInputResourceQuantity(Resource);
-					WantedVariation += Weight * (1.f - (StockRatio / 0.8)); // Max 1
-					WantedTotal += Weight;
-				}
+				FFlareResourceUse Use = { Station, Factory, EFlareResourcePriceContext::FactoryInput };
+				ResourceUses[CycleData.InputResources[ResourceIndex].Resource->Data.Index].AddUnique(Use);
+			}
+			for (int32 ResourceIndex = 0; ResourceIndex < CycleData.OutputResources.Num(); ResourceIndex++)
+			{
+				FFlareResourceUse Use = { Station, Factory, EFlareResourcePriceContext::FactoryOutput };
+				ResourceUses[CycleData.OutputResources[ResourceIndex].Resource->Data.Index].AddUnique(Use);
 			}
+		}
 
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
 
-			if (Factory->HasOutputResource(Resource))
+			if (Station->HasCapability(EFlareSpacecraftCapability::Consumer) && ResourceCatalog->IsCustomerResource(Resource))
 			{
-				if (StockRatio > 0.8f)
-				{
-					float Weight = Factory->GetOutputResourceQuantity(Resource);
-					WantedVariation -= Weight * (StockRatio - 0.8) / 0.2; // Max 1
-					WantedTotal += Weight;
-				}
+				FFlareResourceUse Use = { Station, NULL, EFlareResourcePriceContext::ConsumerConsumption };
+				ResourceUses[ResourceIndex].Add(Use);
+			}
+
+			if (Station->HasCapability(EFlareSpacecraftCapability::Maintenance) && ResourceCatalog->IsMaintenanceResource(Resource))
+			{
+				FFlareResourceUse Use = { Station, NULL, EFlareResourcePriceContext::MaintenanceConsumption };
+				ResourceUses[ResourceIndex].Add(Use);
 			}
 		}
+	}
+
+	ResourceUsesDirty = false;
+}
+
+const TArray<FFlareTradeCandidate>& UFlareSimulatedSector::GetTradeCandidates(FFlareResourceDescription* Resource)
+{
+	if (TradeCandidatesDirty.Num() != Game->GetResourceCatalog()->Resources.Num())
+	{
+		TradeCandidates.SetNum(Game->GetResourceCatalog()->Resources.Num());
+		TradeCandidateUpdates.SetNum(TradeCandidates.Num());
+		TradeCandidatesDirty.Init(true, TradeCandidates.Num());
+	}
+
+	TArray<FFlareTradeCandidate>& Candidates = TradeCandidates[Resource->Index];
+	TArray<UFlareSimulatedSpacecraft*>& Updates = TradeCandidateUpdates[Resource->Index];
+
+	if (TradeCandidatesDirty[Resource->Index])
+	{
+		Candidates.Empty();
 
-		if(Station->HasCapability(EFlareSpacecraftCapability::Consumer) && Game->GetResourceCatalog()->IsCustomerResource(Resource))
+		for (int32 StationIndex = 0; StationIndex < SectorStations.Num(); StationIndex++)
 		{
-			if (StockRatio < 0.8f)
+			FFlareTradeCandidate Candidate;
+			if (ComputeTradeCandidate(StationIndex, Resource, Candidate))
 			{
-				float Weight = GetPeople()->GetRessourceConsumption(Resource);
-				WantedVariation += Weight * (1.f - (StockRatio / 0.8)); // Max 1
-				WantedTotal += Weight;
+				Candidates.Add(Candidate);
 			}
 		}
 
-		if(Station->HasCapability(EFlareSpacecraftCapability::Maintenance) && Game->GetResourceCatalog()->IsMaintenanceResource(Resource))
+		TradeCandidatesDirty[Resource->Index] = false;
+	}
+	else
+	{
+		// Only the stations traded with since the last request are scanned again, and keep their place in station order
+		for (int32 UpdateIndex = 0; UpdateIndex < Updates.Num(); UpdateIndex++)
 		{
-			if (StockRatio < 0.8f)
+			UFlareSimulatedSpacecraft* Station = Updates[UpdateIndex];
+			int32 StationIndex = SectorStations.Find(Station);
+
+			if (StationIndex == INDEX_NONE)
 			{
-				WantedVariation += 1.f - (StockRatio / 0.8); // Max 1
-				WantedTotal += 1;
+				Candidates.RemoveAll([Station](const FFlareTradeCandidate& Candidate) { return Candidate.Station == Station; });
+				continue;
+			}
+
+			int32 CandidateIndex = 0;
+			while (CandidateIndex < Candidates.Num() && Candidates[CandidateIndex].StationIndex < StationIndex)
+			{
+				CandidateIndex++;
+			}
+			bool Listed = (CandidateIndex < Candidates.Num() && Candidates[CandidateIndex].Station == Station);
+
+			FFlareTradeCandidate Candidate;
+			if (ComputeTradeCandidate(StationIndex, Resource, Candidate))
+			{
+				if (Listed)
+				{
+					Candidates[CandidateIndex] = Candidate;
+				}
+				else
+				{
+					Candidates.Insert(Candidate, CandidateIndex);
+				}
+			}
+			else if (Listed)
+			{
+				Candidates.RemoveAt(CandidateIndex);
 			}
 		}
 	}
 
-	float MeanWantedVariation = (WantedTotal > 0 ? WantedVariation / WantedTotal : 0);
+	Updates.Reset();
+	return Candidates;
+}
 
+bool UFlareSimulatedSector::ComputeTradeCandidate(int32 StationIndex, FFlareResourceDescription* Resource, FFlareTradeCandidate& OutCandidate)
+{
+	UFlareSimulatedSpacecraft* Station = SectorStations[StationIndex];
+	UFlareCargoBay* CargoBay = Station->GetCargoBay();
+	TradeCandidateScans++;
 
-	if(MeanWantedVariation != 0.f)
+	OutCandidate.Station = Station;
+	OutCandidate.StationIndex = StationIndex;
+	OutCandidate.FreeSpace = CargoBay->GetFreeSpaceForResource(Resource);
+	OutCandidate.Quantity = CargoBay->GetResourceQuantity(Resource);
+
+	if (OutCandidate.FreeSpace == 0 && OutCandidate.Quantity == 0)
 	{
+		return false;
+	}
 
-		float OldPriceRatio = (OldPrice - Resource->MinPrice) / (float) (Resource->MaxPrice - Resource->MinPrice);
+	OutCandidate.WantBuy = CargoBay->WantBuy(Resource);
+	OutCandidate.WantSell = CargoBay->WantSell(Resource);
+	return true;
+}
 
-		float MaxPriceVariation = 10;
-		float OldPriceRatioToVariationDirection;
+void UFlareSimulatedSector::InvalidateTradeCandidates(FFlareResourceDescription* Resource)
+{
+	if (Resource && Resource->Index < TradeCandidatesDirty.Num())
+	{
+		TradeCandidatesDirty[Resource->Index] = true;
+	}
+	else if (!Resource)
+	{
+		TradeCandidatesDirty.Init(true, TradeCandidatesDirty.Num());
+	}
+}
 
-		if(MeanWantedVariation > 0)
-		{
-			OldPriceRatioToVariationDirection = OldPriceRatio;
-		}
-		else
+void UFlareSimulatedSector::InvalidateStationTradeCandidates(UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource)
+{
+	// The resources scanning all stations again don't need the station
+	for (int32 ResourceIndex = 0; ResourceIndex < TradeCandidatesDirty.Num(); ResourceIndex++)
+	{
+		if ((!Resource || Resource->Index == ResourceIndex) && !TradeCandidatesDirty[ResourceIndex])
 		{
-			OldPriceRatioToVariationDirection = 1 - OldPriceRatio;
+			TradeCandidateUpdates[ResourceIndex].AddUnique(Station);
 		}
+	}
+}
+
+void UFlareSimulatedSector::SimulatePriceVariation()
+{
+	SCOPE_CYCLE_COUNTER(STAT_FlareSector_SimulatePriceVariation);
+
+	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+		SimulatePriceVariation(Resource);
+	}
+}
+
+void UFlareSimulatedSector::SimulatePriceVariation(FFlareResourceDescription* Resource)
+{
+	float OldPrice = GetPreciseResourcePrice(Resource);
+	float MeanWantedVariation = ComputeWantedPriceVariation(Resource);
 
-		float A = (MaxPriceVariation - 2) * (MaxPriceVariation - 2) / (MaxPriceVariation * (MaxPriceVariation - 1));
-		float B = (MaxPriceVariation - 2) / (MaxPriceVariation * (MaxPriceVariation - 1));
-		float C = MaxPriceVariation / (MaxPriceVariation - 2);
+	if(MeanWantedVariation != 0.f)
+	{
+		float Variation;
+		float NewPrice = ComputeVariedPrice(OldPrice, MeanWantedVariation, Resource->MinPrice, Resource->MaxPrice, Variation);
+		ApplyPriceVariation(Resource, OldPrice, NewPrice, Variation);
+	}
+}
 
-		float VariationScale = (1 / (A*OldPriceRatioToVariationDirection + B)) - C;
+float UFlareSimulatedSector::ComputeWantedPriceVariation(FFlareResourceDescription* Resource)
+{
+	// Prices can increase because :
 
+	//  - The input of a station is low (and less than half)
+	//  - Consumer ressource is low
+	//  - Maintenance ressource is low (and less than half)
 
 
-		float Variation = VariationScale * MeanWantedVariation;
+	// Prices can decrease because :
+	//  - Output of a station is full (and more than half)
+	//  - Consumer ressource is full (and more than half)
+	//  - Maintenance ressource is full (and more than half) (very slow decrease)
 
 
-		float NewPrice = FMath::Max(1.f, OldPrice * (1 + Variation / 100.f));
+	float WantedVariation = 0;
+	float WantedTotal = 0;
+	const TArray<FFlareResourceUse>& Uses = GetResourceUses(Resource);
 
 
-		//
-		float MeanPrice = (float) (Resource->MaxPrice + Resource->MinPrice) / 2.f;
+	// Prices never go below min production cost
+	for (int32 UseIndex = 0 ; UseIndex < Uses.Num(); UseIndex++)
+	{
+		const FFlareResourceUse& Use = Uses[UseIndex];
+		UFlareSimulatedSpacecraft* Station = Use.Station;
 
-		SetPreciseResourcePrice(Resource, NewPrice);
-		if(NewPrice > Resource->MaxPrice)
+		if (Use.Factory && !Use.Factory->IsActive())
 		{
-			FLOGV("%s price at max in %s", *Resource->Name.ToString(), *GetSectorName().ToString());
+			continue;
 		}
-		else if(NewPrice < Resource->MinPrice)
+
+		float StockRatio = FMath::Clamp((float) Station->GetCargoBay()->GetResourceQuantity(Resource) / (float) Station->GetCargoBay()->GetSlotCapacity(), 0.f, 1.f);
+
+		// Shipyards follow the cycle of the ship they build
+		bool IsInput = (Use.Role == EFlareResourcePriceContext::FactoryInput);
+		bool IsOutput = (Use.Role == EFlareResourcePriceContext::FactoryOutput);
+		if (Use.Factory && Use.Role == EFlareResourcePriceContext::Default)
 		{
-			FLOGV("%s price at min in %s", *Resource->Name.ToString(), *GetSectorName().ToString());
+			IsInput = Use.Factory->HasInputResource(Resource);
+			IsOutput = Use.Factory->HasOutputResource(Resource);
 		}
-		else
+
+		if (IsInput)
+		{
+			if (StockRatio < 0.8f)
+			{
+				float Weight = Use.Factory->GetInputResourceQuantity(Resource);
+				WantedVariation += Weight * (1.f - (StockRatio / 0.8)); // Max 1
+				WantedTotal += Weight;
+			}
+		}
+
+		if (IsOutput)
+		{
+			if (StockRatio > 0.8f)
+			{
+				float Weight = Use.Factory->GetOutputResourceQuantity(Resource);
+				WantedVariation -= Weight * (StockRatio - 0.8) / 0.2; // Max 1
+				WantedTotal += Weight;
+			}
+		}
+
+		if (Use.Role == EFlareResourcePriceContext::ConsumerConsumption)
 		{
-			FLOGV("%s price in %s change from %f to %f (%f)", *Resource->Name.ToString(), *GetSectorName().ToString(), OldPrice / 100.f, NewPrice / 100.f, Variation);
+			if (StockRatio < 0.8f)
+			{
+				float Weight = GetPeople()->GetRessourceConsumption(Resource);
+				WantedVariation += Weight * (1.f - (StockRatio / 0.8)); // Max 1
+				WantedTotal += Weight;
+			}
+		}
+
+		if (Use.Role == EFlareResourcePriceContext::MaintenanceConsumption)
+		{
+			if (StockRatio < 0.8f)
+			{
+				WantedVariation += 1.f - (StockRatio / 0.8); // Max 1
+				WantedTotal += 1;
+			}
 		}
 	}
+
+	return (WantedTotal > 0 ? WantedVariation / WantedTotal : 0);
+}
+
+void UFlareSimulatedSector::ApplyPriceVariation(FFlareResourceDescription* Resource, float OldPrice, float NewPrice, float Variation)
+{
+	SetPreciseResourcePrice(Resource, NewPrice);
+	LogPriceVariation(Resource, OldPrice, NewPrice, Variation);
+}
+
+void UFlareSimulatedSector::LogPriceVariation(FFlareResourceDescription* Resource, float OldPrice, float NewPrice, float Variation)
+{
+	if(NewPrice > Resource->MaxPrice)
+	{
+		FLOGV("%s price at max in %s", *Resource->Name.ToString(), *GetSectorName().ToString());
+	}
+	else if(NewPrice < Resource->MinPrice)
+	{
+		FLOGV("%s price at min in %s", *Resource->Name.ToString(), *GetSectorName().ToString());
+	}
+	else
+	{
+		FLOGV("%s price in %s change from %f to %f (%f)", *Resource->Name.ToString(), *GetSectorName().ToString(), OldPrice / 100.f, NewPrice / 100.f, Variation);
+	}
 }
 
 int64 UFlareSimulatedSector::GetStationConstructionFee(int64 BasePrice)
@@ -973,41 +1313,68 @@ uint32 UFlareSimulatedSector::GetResourceCount(UFlareCompany* Company, FFlareRes
 {
 	uint32 ResourceCount = 0;
 
-	TArray<UFlareSimulatedSpacecraft*>* SpacecraftList = &SectorStations;
-
-	if(IncludeShips)
-	{
-		SpacecraftList = &SectorSpacecrafts;
-	}
-
-	for (int32 StationIndex = 0 ; StationIndex < SpacecraftList->Num(); StationIndex++)
+	const TArray<UFlareCompany*>& Companies = Game->GetGameWorld()->GetCompanies();
+	for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
 	{
-		UFlareSimulatedSpacecraft* Station = (*SpacecraftList)[StationIndex];
+		UFlareCompany* OtherCompany = Companies[CompanyIndex];
 
-		if ((!AllowTrade && Station->GetCompany() != Company) || Station->GetCompany()->GetWarState(Company) == EFlareHostility::Hostile)
+		if ((!AllowTrade && OtherCompany != Company) || OtherCompany->GetWarState(Company) == EFlareHostility::Hostile)
 		{
 			continue;
 		}
 
-		ResourceCount += Station->GetCargoBay()->GetResourceQuantity(Resource);
+		ResourceCount += GetCompanyStock(OtherCompany, Resource, IncludeShips);
 	}
 
 	return ResourceCount;
 }
 
+uint32 UFlareSimulatedSector::GetCompanyStock(UFlareCompany* Company, FFlareResourceDescription* Resource, bool IncludeShips) const
+{
+	int32 CompanySlot = Company->GetCompanySlot();
+	if (CompanySlot < 0 || CompanySlot >= StockCompanyCount)
+	{
+		return 0;
+	}
+
+	int32 StockIndex = CompanySlot * Game->GetResourceCatalog()->Resources.Num() + Resource->Index;
+	return StationStocks[StockIndex] + (IncludeShips ? ShipStocks[StockIndex] : 0);
+}
+
+uint32 UFlareSimulatedSector::GetCompanyFreeSpace(UFlareCompany* Company, FFlareResourceDescription* Resource) const
+{
+	int32 CompanySlot = Company->GetCompanySlot();
+	if (CompanySlot < 0 || CompanySlot >= StockCompanyCount)
+	{
+		return 0;
+	}
+
+	int32 StockIndex = CompanySlot * Game->GetResourceCatalog()->Resources.Num() + Resource->Index;
+	return StationEmptySlotCapacities[CompanySlot] + StationFreeSpaces[StockIndex];
+}
+
 void UFlareSimulatedSector::LoadResourcePrices()
 {
-	ResourcePrices.Empty();
-	LastResourcePrices.Empty();
+	int32 ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+
+	ResourcePrices.Empty(ResourceCount);
+	ResourcePrices.Init(-1.f, ResourceCount);
+	LastResourcePrices.Empty(ResourceCount);
+	LastResourcePrices.SetNumZeroed(ResourceCount);
+
 	for (int PriceIndex = 0; PriceIndex < SectorData.ResourcePrices.Num(); PriceIndex++)
 	{
 		FFFlareResourcePrice* ResourcePrice = &SectorData.ResourcePrices[PriceIndex];
 		FFlareResourceDescription* Resource = Game->GetResourceCatalog()->Get(ResourcePrice->ResourceIdentifier);
-		float Price = ResourcePrice->Price;
-		ResourcePrices.Add(Resource, Price);
+		if (!Resource)
+		{
+			continue;
+		}
+
+		ResourcePrices[Resource->Index] = ResourcePrice->Price;
 		FFlareFloatBuffer* Prices = &ResourcePrice->Prices;
 		Prices->Resize(50);
-		LastResourcePrices.Add(Resource, *Prices);
+		LastResourcePrices[Resource->Index] = *Prices;
 	}
 }
 
@@ -1018,16 +1385,13 @@ void UFlareSimulatedSector::SaveResourcePrices()
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
-		if (ResourcePrices.Contains(Resource))
+		if (ResourcePrices[ResourceIndex] >= 0 && LastResourcePrices[ResourceIndex].MaxSize > 0)
 		{
 			FFFlareResourcePrice Price;
 			Price.ResourceIdentifier = Resource->Identifier;
-			Price.Price = ResourcePrices[Resource];
-			if (LastResourcePrices.Contains(Resource))
-			{
-				Price.Prices = LastResourcePrices[Resource];
-				SectorData.ResourcePrices.Add(Price);
-			}
+			Price.Price = ResourcePrices[ResourceIndex];
+			Price.Prices = LastResourcePrices[ResourceIndex];
+			SectorData.ResourcePrices.Add(Price);
 		}
 	}
 }
@@ -1257,25 +1621,24 @@ float UFlareSimulatedSector::GetPreciseResourcePrice(FFlareResourceDescription*
 {
 	if(Age == 0)
 	{
-
-		if (!ResourcePrices.Contains(Resource))
+		float& Price = ResourcePrices[Resource->Index];
+		if (Price < 0)
 		{
-			ResourcePrices.Add(Resource, GetDefaultResourcePrice(Resource));
+			Price = GetDefaultResourcePrice(Resource);
 		}
 
-		return ResourcePrices[Resource];
+		return Price;
 	}
 	else
 	{
-		if (!LastResourcePrices.Contains(Resource))
+		FFlareFloatBuffer& Prices = LastResourcePrices[Resource->Index];
+		if (Prices.MaxSize == 0)
 		{
-			FFlareFloatBuffer Prices;
 			Prices.Init(50);
 			Prices.Append(GetPreciseResourcePrice(Resource, 0));
-			LastResourcePrices.Add(Resource, Prices);
 		}
 
-		return LastResourcePrices[Resource].GetValue(Age);
+		return Prices.GetValue(Age);
 	}
 
 }
@@ -1285,21 +1648,40 @@ void UFlareSimulatedSector::SwapPrices()
 	for(int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
 	{
 		FFlareResourceDescription* Resource = &Game->GetResourceCatalog()->Resources[ResourceIndex]->Data;
+		FFlareFloatBuffer& Prices = LastResourcePrices[ResourceIndex];
 
-		if (!LastResourcePrices.Contains(Resource))
+		if (Prices.MaxSize == 0)
 		{
-			FFlareFloatBuffer Prices;
 			Prices.Init(50);
-			LastResourcePrices.Add(Resource, Prices);
 		}
 
-		LastResourcePrices[Resource].Append(GetPreciseResourcePrice(Resource, 0));
+		Prices.Append(GetPreciseResourcePrice(Resource, 0));
 	}
 }
 
+void UFlareSimulatedSector::SwapPrices(const float* Prices)
+{
+	for(int32 ResourceIndex = 0; ResourceIndex < LastResourcePrices.Num(); ResourceIndex++)
+	{
+		FFlareFloatBuffer& History = LastResourcePrices[ResourceIndex];
+
+		if (History.MaxSize == 0)
+		{
+			History.Init(50);
+		}
+
+		History.Append(Prices[ResourceIndex]);
+	}
+}
+
+void UFlareSimulatedSector::SetPreciseResourcePrices(const float* Prices)
+{
+	FMemory::Memcpy(ResourcePrices.GetData(), Prices, ResourcePrices.Num() * sizeof(float));
+}
+
 void UFlareSimulatedSector::SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice)
 {
-	ResourcePrices[Resource] = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
+	ResourcePrices[Resource->Index] = FMath::Clamp(NewPrice, (float) Resource->MinPrice, (float) Resource->MaxPrice);
 }
 
 int64 UFlareSimulatedSector::GetResourcePrice(FFlareResourceDescription* Resource, EFlareResourcePriceContext::Type PriceContext, int32 Age)
@@ -6,15 +6,53 @@
 #include "../Data/FlareAsteroidCatalog.h"
 #include "../Spacecrafts/FlareBomb.h"
 #include "../Economy/FlarePeople.h"
+#include "../Economy/FlareMoneyLedger.h"
 #include "../Player/FlareSoundManager.h"
 #include "FlareSimulatedSector.generated.h"
 
 class UFlareSimulatedSpacecraft;
 struct FFlareSpacecraftDescription;
 class UFlareFleet;
+class UFlareCompany;
 class AFlareGame;
 struct FFlarePlayerSave;
 struct FFlareResourceDescription;
+struct FFlareCargo;
+class UFlareFactory;
+
+/** Station use of a resource, in the sector resource index */
+struct FFlareResourceUse
+{
+	UFlareSimulatedSpacecraft* Station;
+
+	/** Factory using the resource, NULL for the people and maintenance */
+	UFlareFactory* Factory;
+
+	/** FactoryInput, FactoryOutput, ConsumerConsumption or MaintenanceConsumption, Default for a shipyard */
+	EFlareResourcePriceContext::Type Role;
+
+	bool operator==(const FFlareResourceUse& Other) const
+	{
+		return Station == Other.Station && Factory == Other.Factory && Role == Other.Role;
+	}
+};
+
+/** Cargo state of a station that may trade a resource, in the sector trade candidates */
+struct FFlareTradeCandidate
+{
+	UFlareSimulatedSpacecraft* Station;
+
+	/** Index of the station in the sector stations, which only grow between two full scans */
+	int32 StationIndex;
+
+	uint32 FreeSpace;
+
+	uint32 Quantity;
+
+	bool WantBuy;
+
+	bool WantSell;
+};
 
 /** Factory action type values */
 UENUM()
@@ -252,6 +290,57 @@ struct FFlareSectorSave
 	bool IsTravelSector;
 };
 
+/** Company money operation deferred during a parallel sector simulation */
+struct FFlareStagedMoneyOperation
+{
+	/** Company to credit or debit */
+	UFlareCompany* Company;
+
+	/** Amount of money */
+	int64 Amount;
+
+	/** True if the money is taken from the company */
+	bool Take;
+
+	/** Position of the operation in the serial order (factory index, or -1 for people) */
+	int32 Order;
+};
+
+/** Cross-sector side effects of a sector simulated out of the game thread */
+struct FFlareSectorSimulationBuffer
+{
+	FFlareSectorSimulationBuffer()
+		: CurrentOrder(-1)
+	{}
+
+	void TakeMoney(UFlareCompany* Company, int64 Amount)
+	{
+		FFlareStagedMoneyOperation Operation = { Company, Amount, true, CurrentOrder };
+		MoneyOperations.Add(Operation);
+	}
+
+	void GiveMoney(UFlareCompany* Company, int64 Amount)
+	{
+		FFlareStagedMoneyOperation Operation = { Company, Amount, false, CurrentOrder };
+		MoneyOperations.Add(Operation);
+	}
+
+	void RecordTransfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason)
+	{
+		FFlareMoneyTransfer Transfer = { Source, Destination, Amount, Reason };
+		Transfers.Add(Transfer);
+	}
+
+	/** Company money operations, in simulation order */
+	TArray<FFlareStagedMoneyOperation> MoneyOperations;
+
+	/** Money transfers to record in the world ledger */
+	TArray<FFlareMoneyTransfer> Transfers;
+
+	/** Order tag given to the next operations */
+	int32 CurrentOrder;
+};
+
 
 UCLASS()
 class HELIUMRAIN_API UFlareSimulatedSector : public UObject
@@ -322,8 +411,105 @@ public:
 
 	void SimulatePriceVariation(FFlareResourceDescription* Resource);
 
+	/** Mean price variation wanted by the stations using a resource, between -1 and 1 */
+	float ComputeWantedPriceVariation(FFlareResourceDescription* Resource);
+
+	/** Set a varied price and log the change */
+	void ApplyPriceVariation(FFlareResourceDescription* Resource, float OldPrice, float NewPrice, float Variation);
+
+	/** Log a price change, NewPrice being the varied price before the clamp */
+	void LogPriceVariation(FFlareResourceDescription* Resource, float OldPrice, float NewPrice, float Variation);
+
+	/** Price after a wanted variation, slower near the price bound in the variation direction */
+	static inline float ComputeVariedPrice(float OldPrice, float MeanWantedVariation, int64 MinPrice, int64 MaxPrice, float& OutVariation)
+	{
+		return ComputeVariedPriceFromRange(OldPrice, MeanWantedVariation, (float) MinPrice, (float) (MaxPrice - MinPrice), OutVariation);
+	}
+
+	/** Same with the minimum price and the price range, without branch nor conversion for the world price table loop */
+	static inline float ComputeVariedPriceFromRange(float OldPrice, float MeanWantedVariation, float MinPrice, float PriceRange, float& OutVariation)
+	{
+		float OldPriceRatio = (OldPrice - MinPrice) / PriceRange;
+
+		float MaxPriceVariation = 10;
+		float OldPriceRatioToVariationDirection = (MeanWantedVariation > 0 ? OldPriceRatio : 1 - OldPriceRatio);
+
+		float A = (MaxPriceVariation - 2) * (MaxPriceVariation - 2) / (MaxPriceVariation * (MaxPriceVariation - 1));
+		float B = (MaxPriceVariation - 2) / (MaxPriceVariation * (MaxPriceVariation - 1));
+		float C = MaxPriceVariation / (MaxPriceVariation - 2);
+
+		float VariationScale = (1 / (A*OldPriceRatioToVariationDirection + B)) - C;
+
+		OutVariation = VariationScale * MeanWantedVariation;
+		return FMath::Max(1.f, OldPrice * (1 + OutVariation / 100.f));
+	}
+
+	/** Redirect cross-sector side effects to a staging buffer, or apply them directly if NULL */
+	void SetSimulationBuffer(FFlareSectorSimulationBuffer* Buffer)
+	{
+		SimulationBuffer = Buffer;
+	}
+
+	/** Record a money transfer in the world ledger, or stage it during a parallel simulation */
+	void RecordMoneyTransfer(UObject* Source, UObject* Destination, int64 Amount, EFlareMoneyReason::Type Reason);
+
+
+	/*----------------------------------------------------
+		Company stocks
+	----------------------------------------------------*/
+
+	/** Count the cargo of a spacecraft in the company stocks of this sector */
+	void AddCargoStock(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Stop counting the cargo of a spacecraft in the company stocks of this sector */
+	void RemoveCargoStock(UFlareSimulatedSpacecraft* Spacecraft);
+
+	/** Add (Sign = 1) or remove (Sign = -1) a cargo slot of a counted spacecraft */
+	void UpdateCargoStock(UFlareSimulatedSpacecraft* Spacecraft, const FFlareCargo& Cargo, int32 Sign);
+
+	/** Check the company stocks against the spacecraft cargo bays */
+	bool CheckCargoStocks();
+
+
+	/*----------------------------------------------------
+		Resource uses
+	----------------------------------------------------*/
+
+	/** Stations using a resource, in station order */
+	const TArray<FFlareResourceUse>& GetResourceUses(FFlareResourceDescription* Resource);
+
+	/** Rebuild the resource uses before the next access, after stations or factories changed */
+	void InvalidateResourceUses()
+	{
+		ResourceUsesDirty = true;
+	}
+
+	/** Stations with stock or free space for a resource, in station order */
+	const TArray<FFlareTradeCandidate>& GetTradeCandidates(FFlareResourceDescription* Resource);
+
+	/** Rebuild the trade candidates of a resource, or of all resources if NULL */
+	void InvalidateTradeCandidates(FFlareResourceDescription* Resource = NULL);
+
+	/** Scan a station again for the trade candidates of a resource, or of all resources if NULL */
+	void InvalidateStationTradeCandidates(UFlareSimulatedSpacecraft* Station, FFlareResourceDescription* Resource = NULL);
+
+	/** Stations scanned for the trade candidates since the sector was created */
+	int32 GetTradeCandidateScans() const
+	{
+		return TradeCandidateScans;
+	}
+
 protected:
 
+	/** Index the factories, people and maintenance using each resource */
+	void UpdateResourceUses();
+
+	/** Make room for a company in the stock tables */
+	void ReserveCompanyStocks(int32 CompanySlot);
+
+	/** Scan a station for the trade candidates of a resource. False if it has neither stock nor free space for it */
+	bool ComputeTradeCandidate(int32 StationIndex, FFlareResourceDescription* Resource, FFlareTradeCandidate& OutCandidate);
+
     /*----------------------------------------------------
         Protected data
     ----------------------------------------------------*/
@@ -342,13 +528,42 @@ protected:
 	int32                                   PersistentStationIndex;
 	float									LightRatio;
 
+	/** Index in the world sector list, -1 for travel sectors */
+	int32                                   SectorSlot;
+
 	AFlareGame*                             Game;
 
 	UPROPERTY()
 	FFlareSectorOrbitParameters             SectorOrbitParameters;
 	const FFlareSectorDescription*          SectorDescription;
-	TMap<FFlareResourceDescription*, float> ResourcePrices;
-	TMap<FFlareResourceDescription*, FFlareFloatBuffer> LastResourcePrices;
+
+	/** Prices and price history by resource index. Unset prices are negative, unset histories are empty */
+	TArray<float>                           ResourcePrices;
+	TArray<FFlareFloatBuffer>               LastResourcePrices;
+
+	/** Staging buffer, only set while the sector is simulated in a parallel task */
+	FFlareSectorSimulationBuffer*           SimulationBuffer;
+
+	/** Company stocks, by company slot and resource index */
+	int32                                   StockCompanyCount;
+	TArray<int32>                           StationStocks;
+	TArray<int32>                           ShipStocks;
+
+	/** Free space of the station slots holding a resource, by company slot and resource index */
+	TArray<int32>                           StationFreeSpaces;
+
+	/** Capacity of the empty station slots, by company slot */
+	TArray<int32>                           StationEmptySlotCapacities;
+
+	/** Stations using each resource, by resource index */
+	TArray<TArray<FFlareResourceUse>>       ResourceUses;
+	bool                                    ResourceUsesDirty;
+
+	/** Stations that may trade each resource, and the stations to scan again before the next request, by resource index */
+	TArray<TArray<FFlareTradeCandidate>>    TradeCandidates;
+	TArray<bool>                            TradeCandidatesDirty;
+	TArray<TArray<UFlareSimulatedSpacecraft*>> TradeCandidateUpdates;
+	int32                                   TradeCandidateScans;
 
 public:
 
@@ -409,6 +624,11 @@ public:
 		return People;
 	}
 
+	inline FFlareSectorSimulationBuffer* GetSimulationBuffer()
+	{
+		return SimulationBuffer;
+	}
+
 	int32 GetMaxStationsInSector()
 	{
 		return 30;
@@ -424,6 +644,12 @@ public:
 
 	uint32 GetResourceCount(UFlareCompany* Company, FFlareResourceDescription* Resource, bool IncludeShips = false, bool AllowTrade = false);
 
+	/** Quantity of a resource held by a company in this sector, which it can sell */
+	uint32 GetCompanyStock(UFlareCompany* Company, FFlareResourceDescription* Resource, bool IncludeShips = false) const;
+
+	/** Space for a resource in the stations of a company in this sector, which it can buy */
+	uint32 GetCompanyFreeSpace(UFlareCompany* Company, FFlareResourceDescription* Resource) const;
+
 	float GetLightRatio()
 	{
 		return LightRatio;
@@ -435,13 +661,29 @@ public:
 
 	void SwapPrices();
 
+	/** Append the current prices of all resources, by resource index, to the price history */
+	void SwapPrices(const float* Prices);
+
 	void SetPreciseResourcePrice(FFlareResourceDescription* Resource, float NewPrice);
 
+	/** Set the prices of all resources, by resource index, already clamped */
+	void SetPreciseResourcePrices(const float* Prices);
+
 
 	static float GetDefaultResourcePrice(FFlareResourceDescription* Resource);
 
 	uint32 GetTransfertResourcePrice(UFlareSimulatedSpacecraft* SourceSpacecraft, UFlareSimulatedSpacecraft* DestinationSpacecraft, FFlareResourceDescription* Resource);
 
+	inline int32 GetSectorSlot() const
+	{
+		return SectorSlot;
+	}
+
+	inline void SetSectorSlot(int32 Slot)
+	{
+		SectorSlot = Slot;
+	}
+
 	inline FFlareSectorOrbitParameters* GetOrbitParameters()
 	{
 		return &SectorOrbitParameters;
@@ -0,0 +1,151 @@
+#include "../Flare.h"
+
+#include "FlareSimulationBenchmark.h"
+#include "FlareGame.h"
+#include "../Player/FlarePlayerController.h"
+
+
+/*----------------------------------------------------
+	Benchmark
+----------------------------------------------------*/
+
+/*
+ * Command line :
+ *   HeliumRain -nullrhi -FlareBenchmark [-BenchmarkSlot=1 | -BenchmarkScenario=0] [-BenchmarkDays=100] [-BenchmarkOutput=Path]
+ *
+ * The simulation needs the game mode and the player controller, so the benchmark
+ * runs once the game is started instead of in a commandlet, then quits.
+ */
+bool SimulationBenchmark::RunFromCommandLine(AFlarePlayerController* PC)
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (!FParse::Param(CommandLine, TEXT("FlareBenchmark")))
+	{
+		return false;
+	}
+
+	int32 SaveSlot = 0;
+	int32 ScenarioIndex = 0;
+	int32 Days = 100;
+	FString OutputPath = GetDefaultOutputPath();
+
+	FParse::Value(CommandLine, TEXT("BenchmarkSlot="), SaveSlot);
+	FParse::Value(CommandLine, TEXT("BenchmarkScenario="), ScenarioIndex);
+	FParse::Value(CommandLine, TEXT("BenchmarkDays="), Days);
+	FParse::Value(CommandLine, TEXT("BenchmarkOutput="), OutputPath);
+
+	AFlareGame* Game = PC->GetGame();
+
+	// Load a save slot, or create a new game from a scenario
+	if (SaveSlot > 0)
+	{
+		Game->SetCurrentSlot(SaveSlot);
+		if (!Game->LoadGame(PC))
+		{
+			FLOGV("SimulationBenchmark::RunFromCommandLine : failed to load slot %d", SaveSlot);
+			PC->ConsoleCommand("quit");
+			return true;
+		}
+	}
+	else
+	{
+		Game->CreateGame(PC, FText::FromString(TEXT("Benchmark")), ScenarioIndex, false);
+	}
+
+	Run(Game->GetGameWorld(), Days, OutputPath);
+	PC->ConsoleCommand("quit");
+	return true;
+}
+
+bool SimulationBenchmark::Run(UFlareWorld* World, int32 Days, FString OutputPath)
+{
+	if (!World || Days <= 0)
+	{
+		FLOG("SimulationBenchmark::Run : no world to simulate");
+		return false;
+	}
+
+	FLOGV("SimulationBenchmark::Run : simulating %d days", Days);
+
+	FString CsvContents = TEXT("Date,AI,Factories,People,TradeRoutes,Travels,PriceVariation,MoneyMigration,Total,ComputeTravelDurationCalls,GetResourceQuantityCalls,FindTradeStationCalls\n");
+	TArray<TSharedPtr<FJsonValue>> JsonDays;
+	FFlareSimulationTimings TotalTimings;
+
+	for (int32 DayIndex = 0; DayIndex < Days; DayIndex++)
+	{
+		World->Simulate();
+		const FFlareSimulationTimings& Timings = World->GetLastSimulationTimings();
+
+		CsvContents += FString::Printf(TEXT("%lld,%f,%f,%f,%f,%f,%f,%f,%f,%d,%d,%d\n"), World->GetDate(),
+			Timings.AI, Timings.Factories, Timings.People, Timings.TradeRoutes,
+			Timings.Travels, Timings.PriceVariation, Timings.MoneyMigration, Timings.Total,
+			Timings.ComputeTravelDurationCalls, Timings.GetResourceQuantityCalls, Timings.FindTradeStationCalls);
+
+		TSharedPtr<FJsonObject> JsonDay = MakeShareable(new FJsonObject());
+		JsonDay->SetNumberField("Date", World->GetDate());
+		JsonDay->SetNumberField("AI", Timings.AI);
+		JsonDay->SetNumberField("Factories", Timings.Factories);
+		JsonDay->SetNumberField("People", Timings.People);
+		JsonDay->SetNumberField("TradeRoutes", Timings.TradeRoutes);
+		JsonDay->SetNumberField("Travels", Timings.Travels);
+		JsonDay->SetNumberField("PriceVariation", Timings.PriceVariation);
+		JsonDay->SetNumberField("MoneyMigration", Timings.MoneyMigration);
+		JsonDay->SetNumberField("Total", Timings.Total);
+		JsonDay->SetNumberField("ComputeTravelDurationCalls", Timings.ComputeTravelDurationCalls);
+		JsonDay->SetNumberField("GetResourceQuantityCalls", Timings.GetResourceQuantityCalls);
+		JsonDay->SetNumberField("FindTradeStationCalls", Timings.FindTradeStationCalls);
+		JsonDays.Add(MakeShareable(new FJsonValueObject(JsonDay)));
+
+		TotalTimings.AI += Timings.AI;
+		TotalTimings.Factories += Timings.Factories;
+		TotalTimings.People += Timings.People;
+		TotalTimings.TradeRoutes += Timings.TradeRoutes;
+		TotalTimings.Travels += Timings.Travels;
+		TotalTimings.PriceVariation += Timings.PriceVariation;
+		TotalTimings.MoneyMigration += Timings.MoneyMigration;
+		TotalTimings.Total += Timings.Total;
+	}
+
+	// Summary
+	TSharedPtr<FJsonObject> JsonTotal = MakeShareable(new FJsonObject());
+	JsonTotal->SetNumberField("AI", TotalTimings.AI);
+	JsonTotal->SetNumberField("Factories", TotalTimings.Factories);
+	JsonTotal->SetNumberField("People", TotalTimings.People);
+	JsonTotal->SetNumberField("TradeRoutes", TotalTimings.TradeRoutes);
+	JsonTotal->SetNumberField("Travels", TotalTimings.Travels);
+	JsonTotal->SetNumberField("PriceVariation", TotalTimings.PriceVariation);
+	JsonTotal->SetNumberField("MoneyMigration", TotalTimings.MoneyMigration);
+	JsonTotal->SetNumberField("Total", TotalTimings.Total);
+
+	TSharedRef<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+	JsonObject->SetNumberField("DayCount", Days);
+	JsonObject->SetNumberField("SectorCount", World->GetSectors().Num());
+	JsonObject->SetNumberField("CompanyCount", World->GetCompanies().Num());
+	JsonObject->SetBoolField("BatchedPriceVariation", World->IsBatchedPriceVariation());
+	JsonObject->SetBoolField("AuctionCargoAssignment", World->IsAuctionCargoAssignment());
+	JsonObject->SetObjectField("Total", JsonTotal);
+	JsonObject->SetArrayField("Days", JsonDays);
+
+	FString JsonContents;
+	TSharedRef< TJsonWriter<> > JsonWriter = TJsonWriterFactory<>::Create(&JsonContents);
+	if (!FJsonSerializer::Serialize(JsonObject, JsonWriter))
+	{
+		FLOG("SimulationBenchmark::Run : failed to serialize report");
+		return false;
+	}
+	JsonWriter->Close();
+
+	bool Saved = FFileHelper::SaveStringToFile(CsvContents, *(OutputPath + TEXT(".csv")))
+		&& FFileHelper::SaveStringToFile(JsonContents, *(OutputPath + TEXT(".json")));
+
+	FLOGV("SimulationBenchmark::Run : %d days in %f s (%f s per day), report %s in %s", Days, TotalTimings.Total, TotalTimings.Total / Days,
+		Saved ? TEXT("saved") : TEXT("not saved"), *OutputPath);
+
+	return Saved;
+}
+
+FString SimulationBenchmark::GetDefaultOutputPath()
+{
+	return FPaths::GameSavedDir() / TEXT("Benchmark") / TEXT("SimulationBenchmark");
+}
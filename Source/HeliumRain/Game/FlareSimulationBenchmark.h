@@ -0,0 +1,20 @@
+#pragma once
+
+#include "FlareWorld.h"
+
+class AFlarePlayerController;
+
+
+/** Headless world simulation benchmark, started with -FlareBenchmark */
+struct SimulationBenchmark
+{
+	/** Parse the command line, load the requested game and run the benchmark. Return false if not requested */
+	static bool RunFromCommandLine(AFlarePlayerController* PC);
+
+	/** Simulate the loaded world for some days and write the phase timings to OutputPath.csv and OutputPath.json */
+	static bool Run(UFlareWorld* World, int32 Days, FString OutputPath);
+
+	/** Default report path, without extension */
+	static FString GetDefaultOutputPath();
+
+};
@@ -84,6 +84,8 @@ FFlareTravelSave* UFlareTravel::Save()
 
 void UFlareTravel::Simulate()
 {
+	SCOPE_CYCLE_COUNTER(STAT_FlareTravel_Simulate);
+
 	if (GetRemainingTravelDuration() <= 0)
 	{
 		EndTravel();
@@ -189,11 +191,13 @@ bool UFlareTravel::CanChangeDestination()
 
 void UFlareTravel::GenerateTravelDuration()
 {
-	TravelDuration = ComputeTravelDuration(Game->GetGameWorld(), OriginSector, DestinationSector);
+	TravelDuration = Game->GetGameWorld()->GetTravelDuration(OriginSector, DestinationSector);
 }
 
 int64 UFlareTravel::ComputeTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector)
 {
+	FLARE_COUNT_CALL(ComputeTravelDuration);
+
 	int64 TravelDuration = 0;
 
 	if (OriginSector == DestinationSector)
@@ -78,6 +78,7 @@ public:
 
 	FFlareSectorOrbitParameters ComputeCurrentTravelLocation();
 
+	/** Orbital travel duration in days. Use UFlareWorld::GetTravelDuration for the precomputed one */
 	static int64 ComputeTravelDuration(UFlareWorld* World, UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector);
 
 	static int64 ComputePhaseTravelDuration(UFlareWorld* World, FFlareCelestialBody* CelestialBody, double Altitude, double OriginPhase, double DestinationPhase);
@@ -6,9 +6,13 @@
 #include "FlareSector.h"
 #include "FlareTravel.h"
 #include "FlareFleet.h"
+#include "../Economy/FlareCargoBay.h"
+#include "../Quests/FlareQuest.h"
 
 #include "../Player/FlarePlayerController.h"
 
+#include "ParallelFor.h"
+
 
 /*----------------------------------------------------
     Constructor
@@ -16,6 +20,19 @@
 
 UFlareWorld::UFlareWorld(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, ParallelSimulation(true)
+	, PooledMoneyMigration(true)
+	, BatchedPriceVariation(true)
+	, SharedResourceVariation(true)
+	, PrunedDealSearch(true)
+	, ParallelAIPlanning(true)
+	, AuctionCargoAssignment(true)
+	, BulkFastForward(true)
+	, SpanEndDate(0)
+	, TravelDurationsDirty(true)
+	, IntegrityAuditPeriod(10)
+	, IntegrityAuditDeferred(false)
+	, LookupValidation(false)
 {
 }
 
@@ -122,6 +139,19 @@ UFlareCompany* UFlareWorld::LoadCompany(const FFlareCompanySave& CompanyData)
 	Company = NewObject<UFlareCompany>(this, UFlareCompany::StaticClass(), CompanyData.Identifier);
     Company->Load(CompanyData);
     Companies.AddUnique(Company);
+	CompaniesByIdentifier.Add(Company->GetIdentifier(), Company);
+
+	// Relations saved by this company, and by the loaded companies toward it
+	Company->SetCompanySlot(Companies.Num() - 1);
+	CompanyRelations.SetCompanyCount(Companies.Num());
+	for (int i = 0; i < Companies.Num(); i++)
+	{
+		if (Companies[i] != Company)
+		{
+			Company->LoadRelations(Companies[i]);
+			Companies[i]->LoadRelations(Company);
+		}
+	}
 
 	FLOGV("UFlareWorld::LoadCompany : loaded '%s'", *Company->GetCompanyName().ToString());
 
@@ -137,6 +167,9 @@ UFlareSimulatedSector* UFlareWorld::LoadSector(const FFlareSectorDescription* De
 	Sector = NewObject<UFlareSimulatedSector>(this, UFlareSimulatedSector::StaticClass(), SectorData.Identifier);
 	Sector->Load(Description, SectorData, OrbitParameters);
 	Sectors.AddUnique(Sector);
+	SectorsByIdentifier.Add(Sector->GetIdentifier(), Sector);
+	Sector->SetSectorSlot(Sectors.Num() - 1);
+	InvalidateTravelDurations();
 
 	FLOGV("UFlareWorld::LoadSector : loaded '%s'", *Sector->GetSectorName().ToString());
 
@@ -217,6 +250,7 @@ void UFlareWorld::CompanyMutualAssistance()
 				if (Company->TakeMoney(MoneyToTake))
 				{
 					SharedPool +=MoneyToTake;
+					MoneyLedger.RecordTransfer(Company, this, MoneyToTake, EFlareMoneyReason::MutualAssistance);
 				}
 			}
 			SharingCompanyCount++;
@@ -237,10 +271,12 @@ void UFlareWorld::CompanyMutualAssistance()
 		if (Company != PlayerCompany)
 		{
 			Company->GiveMoney(PoolPart);
+			MoneyLedger.RecordTransfer(this, Company, PoolPart, EFlareMoneyReason::MutualAssistance);
 
-			if(CompanyIndex == BonusIndex)
+			if(SharingCompanyIndex == BonusIndex)
 			{
 				Company->GiveMoney(PoolBonus);
+				MoneyLedger.RecordTransfer(this, Company, PoolBonus, EFlareMoneyReason::MutualAssistance);
 			}
 
 			SharingCompanyIndex++;
@@ -251,449 +287,1503 @@ void UFlareWorld::CompanyMutualAssistance()
 bool UFlareWorld::CheckIntegrity()
 {
 	bool Integrity = true;
+
+	DirtyCompanies.Empty();
+	DirtySectors.Empty();
+
 	for (int i = 0; i < Sectors.Num(); i++)
 	{
-		UFlareSimulatedSector* Sector = Sectors[i];
-
-		for (int32 StationIndex = 0 ; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
+		if (!CheckSectorIntegrity(Sectors[i]))
 		{
-			UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
-			if (!Station->IsStation())
-			{
-				FLOGV("WARNING : World integrity failure : station %s in %s is not a station", *Station->GetImmatriculation().ToString(), *Sector->GetSectorName().ToString());
-				Integrity = false;
-			}
+			Integrity = false;
 		}
 	}
 
-	// Check money integrity
-	if (! WorldMoneyReferenceInit)
+	if (!CheckMoneyIntegrity())
 	{
-		WorldMoneyReference = GetWorldMoney();
-		WorldMoneyReferenceInit = true;
-	}
-	else
-	{
-		int64 WorldMoney = GetWorldMoney();
-
-		if (WorldMoneyReference != WorldMoney)
-		{
-			FLOGV("WARNING : World integrity failure : world contain %lld credits but reference is %lld", WorldMoney, WorldMoneyReference)
-			Integrity = false;
-		}
+		Integrity = false;
 	}
 
-	//  Check companyintegrity
 	for (int i = 0; i < Companies.Num(); i++)
 	{
-		UFlareCompany* Company = Companies[i];
-		if (Company->GetCompanySpacecrafts().Num() != Company->GetCompanyShips().Num() + Company->GetCompanyStations().Num())
+		if (!CheckCompanyIntegrity(Companies[i]))
 		{
-			FLOGV("WARNING : World integrity failure : %s have %d spacecraft but %d ships and %s stations", *Company->GetCompanyName().ToString(),
-				  Company->GetCompanySpacecrafts().Num(),
-				  Company->GetCompanyShips().Num(),
-				  Company->GetCompanyStations().Num());
 			Integrity = false;
 		}
+	}
 
-		// Ships
-		for (int32 ShipIndex = 0 ; ShipIndex < Company->GetCompanyShips().Num(); ShipIndex++)
-		{
-			UFlareSimulatedSpacecraft* Ship = Company->GetCompanyShips()[ShipIndex];
+	if (!CheckLookupIndices())
+	{
+		Integrity = false;
+	}
 
-			UFlareSimulatedSector* ShipSector = Ship->GetCurrentSector();
+	return Integrity;
+}
 
-			if(ShipSector)
-			{
-				if (Ship->GetCurrentFleet() == NULL)
-				{
-					FLOGV("WARNING : World integrity failure : %s in %s is in no fleet",
-						  *Ship->GetImmatriculation().ToString(),
-						  *ShipSector->GetSectorName().ToString());
-					Integrity = false;
-				}
+bool UFlareWorld::AuditIntegrity()
+{
+	bool Integrity = true;
 
-				if(!ShipSector->GetSectorShips().Contains(Ship))
-				{
-					FLOGV("WARNING : World integrity failure : %s in %s but not in sector ship list",
-						  *Ship->GetImmatriculation().ToString(),
-						  *ShipSector->GetSectorName().ToString());
-					Integrity = false;
-				}
-			}
-			else
-			{
-				if (Ship->GetCurrentFleet() == NULL)
-				{
-					FLOGV("WARNING : World integrity failure : %s not in sector but in no fleet",
-						  *Ship->GetImmatriculation().ToString());
-					Integrity = false;
+	// Fixes applied by the checks will mark entities for the next audit
+	TArray<UFlareCompany*> CompaniesToCheck = DirtyCompanies;
+	TArray<UFlareSimulatedSector*> SectorsToCheck = DirtySectors;
+	DirtyCompanies.Empty();
+	DirtySectors.Empty();
 
-				}
-				else if(Ship->GetCurrentFleet()->GetCurrentTravel() == NULL)
-				{
-					FLOGV("WARNING : World integrity failure : %s in fleet %s but not in sector and not in travel",
-						  *Ship->GetImmatriculation().ToString(),
-						  *Ship->GetCurrentFleet()->GetFleetName().ToString());
-					if(Ship->GetCurrentFleet()->GetCurrentSector() != NULL)
-					{
-						FLOGV("  - %s in %s",
-							  *Ship->GetCurrentFleet()->GetFleetName().ToString(),
-							  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
-						if (Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorSpacecrafts().Contains(Ship))
-						{
-							FLOGV("  - %s contains the ship in its list",
-								  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
-						}
-						else
-						{
-							FLOGV("  - %s don't contains the ship in its list",
-								  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
-						}
-
-						Ship->GetCurrentFleet()->GetCurrentSector()->AddFleet(Ship->GetCurrentFleet());
-						FLOGV("Fix integrity : set %s to %s",
-							   *Ship->GetImmatriculation().ToString(),
-							  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
-					}
-					else
-					{
-						FLOGV("  - %s in no sector", *Ship->GetCurrentFleet()->GetFleetName().ToString());
-						if (Ship->GetCompany()->GetKnownSectors().Num() > 0)
-						{
-							Ship->GetCompany()->GetKnownSectors()[0]->AddFleet(Ship->GetCurrentFleet());
-							FLOGV("Fix integrity : set %s to %s",
-							   *Ship->GetImmatriculation().ToString(),
-							  *Ship->GetCurrentSector()->GetSectorName().ToString());
-						}
-					}
-					Integrity = false;
-				}
-			}
-		}
+	// Each day, the rolling audit checks one slice of the world
+	int32 Slice = (IntegrityAuditPeriod > 0 ? WorldData.Date % IntegrityAuditPeriod : -1);
 
-		// Fleets
-		for (int32 FleetIndex = 0 ; FleetIndex < Company->GetCompanyFleets().Num(); FleetIndex++)
+	for (int i = 0; i < Sectors.Num(); i++)
+	{
+		if ((Slice >= 0 && i % IntegrityAuditPeriod == Slice) || SectorsToCheck.Contains(Sectors[i]))
 		{
-			UFlareFleet* Fleet = Company->GetCompanyFleets()[FleetIndex];
-
-			if(Fleet->GetShipCount() == 0)
+			if (!CheckSectorIntegrity(Sectors[i]))
 			{
-				FLOGV("WARNING : World integrity failure : %s fleet %s is empty",
-					  *Company->GetCompanyName().ToString(),
-					  *Fleet->GetFleetName().ToString());
 				Integrity = false;
 			}
+		}
+	}
 
-			if(Fleet->GetCurrentSector() == NULL )
-			{
-				FLOGV("WARNING : World integrity failure : %s fleet %s is not in a sector",
-					  *Company->GetCompanyName().ToString(),
-					  *Fleet->GetFleetName().ToString());
-				Integrity = false;
-			}
-			else if(Fleet->GetCurrentSector()->IsTravelSector() && Fleet->GetCurrentTravel() == NULL)
+	// Money balances are all checked together, once per period
+	if (Slice == 0 || !WorldMoneyReferenceInit)
+	{
+		if (!CheckMoneyIntegrity())
+		{
+			Integrity = false;
+		}
+	}
+
+	for (int i = 0; i < Companies.Num(); i++)
+	{
+		if ((Slice >= 0 && i % IntegrityAuditPeriod == Slice) || CompaniesToCheck.Contains(Companies[i]))
+		{
+			if (!CheckCompanyIntegrity(Companies[i]))
 			{
-				FLOGV("WARNING : World integrity failure : %s fleet %s is in a travel sector and not in travel",
-					  *Company->GetCompanyName().ToString(),
-					  *Fleet->GetFleetName().ToString());
 				Integrity = false;
 			}
 		}
 	}
+
+	if (LookupValidation && !CheckLookupIndices())
+	{
+		Integrity = false;
+	}
+
 	return Integrity;
 }
 
-void UFlareWorld::Simulate()
+bool UFlareWorld::CheckLookupIndices()
 {
+	bool Integrity = true;
 
-	UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
-
-	/**
-	 *  End previous day
-	 */
-
-	// Finish player battles
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	if (SectorsByIdentifier.Num() != Sectors.Num() || CompaniesByIdentifier.Num() != Companies.Num())
 	{
-		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
-
-		EFlareSectorBattleState::Type BattleState = Sector->GetSectorBattleState(PlayerCompany);
+		FLOGV("WARNING : World integrity failure : lookup indices have %d sectors and %d companies for %d and %d",
+			SectorsByIdentifier.Num(), CompaniesByIdentifier.Num(), Sectors.Num(), Companies.Num());
+		Integrity = false;
+	}
 
-		if(BattleState != EFlareSectorBattleState::NoBattle && BattleState != EFlareSectorBattleState::BattleWon)
+	for (int i = 0; i < Sectors.Num(); i++)
+	{
+		if (FindSector(Sectors[i]->GetIdentifier()) != Sectors[i])
 		{
-			// Destroy all player ships
-			TArray<UFlareSimulatedSpacecraft*> ShipToDestroy;
-
-			for (int ShipIndex = 0; ShipIndex < Sector->GetSectorShips().Num(); ShipIndex++)
-			{
-				if(Sector->GetSectorShips()[ShipIndex]->GetCompany() == PlayerCompany)
-				{
-					ShipToDestroy.Add(Sector->GetSectorShips()[ShipIndex]);
-				}
-			}
+			FLOGV("WARNING : World integrity failure : sector %s is not indexed", *Sectors[i]->GetIdentifier().ToString());
+			Integrity = false;
+		}
 
-			for (int ShipIndex = 0; ShipIndex < ShipToDestroy.Num(); ShipIndex++)
-			{
-				PlayerCompany->DestroySpacecraft(ShipToDestroy[ShipIndex]);
-			}
+		if (Sectors[i]->GetSectorSlot() != i)
+		{
+			FLOGV("WARNING : World integrity failure : sector %s has slot %d at index %d", *Sectors[i]->GetIdentifier().ToString(), Sectors[i]->GetSectorSlot(), i);
+			Integrity = false;
 		}
 	}
-	// TODO battles between 2 AI company
-
 
-	// AI. Play them in random order
-	TArray<UFlareCompany*> CompaniesToSimulateAI = Companies;
-	while(CompaniesToSimulateAI.Num())
+	for (int i = 0; i < Companies.Num(); i++)
 	{
-		int32 Index = FMath::RandRange(0, CompaniesToSimulateAI.Num() - 1);
-		CompaniesToSimulateAI[Index]->SimulateAI();
-		CompaniesToSimulateAI.RemoveAt(Index);
+		if (FindCompany(Companies[i]->GetIdentifier()) != Companies[i])
+		{
+			FLOGV("WARNING : World integrity failure : company %s is not indexed", *Companies[i]->GetIdentifier().ToString());
+			Integrity = false;
+		}
+
+		if (!Companies[i]->CheckLookupIndices())
+		{
+			Integrity = false;
+		}
 	}
 
-	CompanyMutualAssistance();
-	CheckIntegrity();
+	return Integrity;
+}
 
-	/**
-	 *  Begin day
-	 */
-	WorldData.Date++;
+bool UFlareWorld::CheckSectorIntegrity(UFlareSimulatedSector* Sector)
+{
+	bool Integrity = true;
 
-	// End trade operation
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	for (int32 StationIndex = 0 ; StationIndex < Sector->GetSectorStations().Num(); StationIndex++)
 	{
-		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
-		for (int32 ShipIndex = 0; ShipIndex < Sector->GetSectorSpacecrafts().Num(); ShipIndex++)
+		UFlareSimulatedSpacecraft* Station = Sector->GetSectorStations()[StationIndex];
+		if (!Station->IsStation())
 		{
-			Sector->GetSectorSpacecrafts()[ShipIndex]->SetTrading(false);
+			FLOGV("WARNING : World integrity failure : station %s in %s is not a station", *Station->GetImmatriculation().ToString(), *Sector->GetSectorName().ToString());
+			Integrity = false;
 		}
 	}
 
-	// Factories
-	FLOG("Factories");
-	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	if (!Sector->CheckCargoStocks())
 	{
-		Factories[FactoryIndex]->Simulate();
+		Integrity = false;
 	}
 
-	// Peoples
-	FLOG("Peoples");
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
-	{
-		Sectors[SectorIndex]->GetPeople()->Simulate();
-	}
+	return Integrity;
+}
 
+bool UFlareWorld::CheckMoneyIntegrity()
+{
+	bool Integrity = true;
 
-	FLOG("Trade routes");
+	// World money is the sum of company money + factory money + people money
+	TMap<UFlareCompany*, FFlareAuditedBalance> CompanyMoney;
+	TMap<UFlareSimulatedSector*, FFlareAuditedBalance> PeopleMoney;
+	int64 WorldMoney = 0;
 
-	// Trade routes
-	for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+	for (int i = 0; i < Companies.Num(); i++)
 	{
-		TArray<UFlareTradeRoute*>& TradeRoutes = Companies[CompanyIndex]->GetCompanyTradeRoutes();
+		UFlareCompany* Company = Companies[i];
+		FFlareAuditedBalance Balance;
+		Balance.Money = Company->GetMoney();
+		Balance.Ledger = MoneyLedger.GetAccountBalance(Company);
 
-		for (int RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+		TArray<UFlareSimulatedSpacecraft*>& Spacecrafts = Company->GetCompanySpacecrafts();
+		for (int ShipIndex = 0; ShipIndex < Spacecrafts.Num() ; ShipIndex++)
 		{
-			TradeRoutes[RouteIndex]->Simulate();
+			for (int32 FactoryIndex = 0; FactoryIndex < Spacecrafts[ShipIndex]->GetFactories().Num(); FactoryIndex++)
+			{
+				UFlareFactory* Factory = Spacecrafts[ShipIndex]->GetFactories()[FactoryIndex];
+				Balance.Money += Factory->GetReservedMoney() + Factory->GetOrderShipAdvancePayment();
+			}
 		}
+
+		CompanyMoney.Add(Company, Balance);
+		WorldMoney += Balance.Money;
 	}
 
-	// Travels
-	for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
 	{
-		Travels[TravelIndex]->Simulate();
+		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
+		FFlareAuditedBalance Balance;
+		Balance.Money = Sector->GetPeople()->GetMoney() - Sector->GetPeople()->GetDept();
+		Balance.Ledger = MoneyLedger.GetAccountBalance(Sector->GetPeople());
+
+		PeopleMoney.Add(Sector, Balance);
+		WorldMoney += Balance.Money;
 	}
 
-	// Reputation stabilization
-	for (int CompanyIndex1 = 0; CompanyIndex1 < Companies.Num(); CompanyIndex1++)
+	if (! WorldMoneyReferenceInit)
 	{
-		UFlareCompany* Company1 =Companies[CompanyIndex1];
+		MoneyLedger.InitWorldMoney(WorldMoney);
+		WorldMoneyReferenceInit = true;
+	}
+	else if (MoneyLedger.GetWorldMoney() != WorldMoney)
+	{
+		FLOGV("WARNING : World integrity failure : world contain %lld credits but ledger is %lld (delta %lld)", WorldMoney, MoneyLedger.GetWorldMoney(), WorldMoney - MoneyLedger.GetWorldMoney());
+		Integrity = false;
 
-		for (int CompanyIndex2 = 0; CompanyIndex2 < Companies.Num(); CompanyIndex2++)
+		// Report the balances that moved otherwise than recorded since the last check
+		for (int i = 0; i < Companies.Num(); i++)
 		{
-			UFlareCompany* Company2 =Companies[CompanyIndex2];
-
-			if(Company1 == Company2)
+			FFlareAuditedBalance* Previous = AuditedCompanyMoney.Find(Companies[i]);
+			FFlareAuditedBalance& Current = CompanyMoney[Companies[i]];
+			if (Previous && Current.Money - Previous->Money != Current.Ledger - Previous->Ledger)
 			{
-				continue;
+				FLOGV("  - company %s : %lld credits moved but ledger recorded %lld (delta %lld)", *Companies[i]->GetCompanyName().ToString(),
+					Current.Money - Previous->Money, Current.Ledger - Previous->Ledger,
+					(Current.Money - Previous->Money) - (Current.Ledger - Previous->Ledger));
 			}
+		}
 
-			float Reputation = Company1->GetReputation(Company2);
-			if(Reputation != 0.f)
+		for (int i = 0; i < Sectors.Num(); i++)
+		{
+			FFlareAuditedBalance* Previous = AuditedPeopleMoney.Find(Sectors[i]);
+			FFlareAuditedBalance& Current = PeopleMoney[Sectors[i]];
+			if (Previous && Current.Money - Previous->Money != Current.Ledger - Previous->Ledger)
 			{
-				Company1->GiveReputation(Company2, -0.01 * FMath::Sign(Reputation), false);
+				FLOGV("  - people in %s : %lld credits moved but ledger recorded %lld (delta %lld)", *Sectors[i]->GetSectorName().ToString(),
+					Current.Money - Previous->Money, Current.Ledger - Previous->Ledger,
+					(Current.Money - Previous->Money) - (Current.Ledger - Previous->Ledger));
 			}
 		}
 	}
 
-	// Price variation.
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
-	{
-		Sectors[SectorIndex]->SimulatePriceVariation();
-	}
+	AuditedCompanyMoney = CompanyMoney;
+	AuditedPeopleMoney = PeopleMoney;
 
-	// People money migration
-	SimulatePeopleMoneyMigration();
+	return Integrity;
+}
 
-	// Process events
+bool UFlareWorld::CheckCompanyIntegrity(UFlareCompany* Company)
+{
+	bool Integrity = true;
 
-	// Swap Prices.
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	if (Company->GetCompanySpacecrafts().Num() != Company->GetCompanyShips().Num() + Company->GetCompanyStations().Num())
 	{
-		Sectors[SectorIndex]->SwapPrices();
+		FLOGV("WARNING : World integrity failure : %s have %d spacecraft but %d ships and %d stations", *Company->GetCompanyName().ToString(),
+			  Company->GetCompanySpacecrafts().Num(),
+			  Company->GetCompanyShips().Num(),
+			  Company->GetCompanyStations().Num());
+		Integrity = false;
 	}
 
-}
-
-void UFlareWorld::SimulatePeopleMoneyMigration()
-{
-	for (int SectorIndexA = 0; SectorIndexA < Sectors.Num(); SectorIndexA++)
+	// Ships
+	for (int32 ShipIndex = 0 ; ShipIndex < Company->GetCompanyShips().Num(); ShipIndex++)
 	{
-		UFlareSimulatedSector* SectorA = Sectors[SectorIndexA];
-
-		for (int SectorIndexB = SectorIndexA + 1; SectorIndexB < Sectors.Num(); SectorIndexB++)
-		{
-			UFlareSimulatedSector* SectorB = Sectors[SectorIndexB];
-
-			// Money and people migration
-			float PopulationA = SectorA->GetPeople()->GetPopulation();
-			float PopulationB = SectorB->GetPeople()->GetPopulation();
+		UFlareSimulatedSpacecraft* Ship = Company->GetCompanyShips()[ShipIndex];
 
+		UFlareSimulatedSector* ShipSector = Ship->GetCurrentSector();
 
-			if(PopulationA == 0 && PopulationB == 0)
+		if(ShipSector)
+		{
+			if (Ship->GetCurrentFleet() == NULL)
 			{
-				// 2 sector without population. Do nothing
-				continue;
+				FLOGV("WARNING : World integrity failure : %s in %s is in no fleet",
+					  *Ship->GetImmatriculation().ToString(),
+					  *ShipSector->GetSectorName().ToString());
+				Integrity = false;
 			}
-			else if (PopulationA  == 0)
+
+			if(!ShipSector->GetSectorShips().Contains(Ship))
 			{
-				// Origin sector has no population so it leak it's money
-				uint32 TransfertA = SectorA->GetPeople()->GetMoney() / 10;
-				SectorA->GetPeople()->TakeMoney(TransfertA);
-				SectorB->GetPeople()->Pay(TransfertA);
+				FLOGV("WARNING : World integrity failure : %s in %s but not in sector ship list",
+					  *Ship->GetImmatriculation().ToString(),
+					  *ShipSector->GetSectorName().ToString());
+				Integrity = false;
 			}
-			else if (PopulationB  == 0)
+		}
+		else
+		{
+			if (Ship->GetCurrentFleet() == NULL)
 			{
-				// Destination sector has no population so it leak it's money
-				uint32 TransfertB = SectorB->GetPeople()->GetMoney() / 10;
-				SectorB->GetPeople()->TakeMoney(TransfertB);
-				SectorA->GetPeople()->Pay(TransfertB);
+				FLOGV("WARNING : World integrity failure : %s not in sector but in no fleet",
+					  *Ship->GetImmatriculation().ToString());
+				Integrity = false;
+
 			}
-			else
+			else if(Ship->GetCurrentFleet()->GetCurrentTravel() == NULL)
 			{
-				// Both have population. The wealthier leak.
-				float WealthA = SectorA->GetPeople()->GetWealth();
-				float WealthB = SectorA->GetPeople()->GetWealth();
-				float TotalWealth = WealthA + WealthB;
-
-				if(TotalWealth > 0)
+				FLOGV("WARNING : World integrity failure : %s in fleet %s but not in sector and not in travel",
+					  *Ship->GetImmatriculation().ToString(),
+					  *Ship->GetCurrentFleet()->GetFleetName().ToString());
+				if(Ship->GetCurrentFleet()->GetCurrentSector() != NULL)
 				{
-					if(WealthA > WealthB)
+					FLOGV("  - %s in %s",
+						  *Ship->GetCurrentFleet()->GetFleetName().ToString(),
+						  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
+					if (Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorSpacecrafts().Contains(Ship))
 					{
-						float LeakRatio = 0.02f * ((WealthA / TotalWealth) - 0.5f); // 1% at max
-						uint32 TransfertA = LeakRatio * SectorA->GetPeople()->GetMoney();
-						SectorA->GetPeople()->TakeMoney(TransfertA);
-						SectorB->GetPeople()->Pay(TransfertA);
+						FLOGV("  - %s contains the ship in its list",
+							  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
 					}
 					else
 					{
-						float LeakRatio = 0.02f * ((WealthB / TotalWealth) - 0.5f); // 1% at max
-						uint32 TransfertB = LeakRatio * SectorB->GetPeople()->GetMoney();
-						SectorB->GetPeople()->TakeMoney(TransfertB);
-						SectorA->GetPeople()->Pay(TransfertB);
+						FLOGV("  - %s don't contains the ship in its list",
+							  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
+					}
+
+					Ship->GetCurrentFleet()->GetCurrentSector()->AddFleet(Ship->GetCurrentFleet());
+					FLOGV("Fix integrity : set %s to %s",
+						   *Ship->GetImmatriculation().ToString(),
+						  *Ship->GetCurrentFleet()->GetCurrentSector()->GetSectorName().ToString());
+				}
+				else
+				{
+					FLOGV("  - %s in no sector", *Ship->GetCurrentFleet()->GetFleetName().ToString());
+					if (Ship->GetCompany()->GetKnownSectors().Num() > 0)
+					{
+						Ship->GetCompany()->GetKnownSectors()[0]->AddFleet(Ship->GetCurrentFleet());
+						FLOGV("Fix integrity : set %s to %s",
+						   *Ship->GetImmatriculation().ToString(),
+						  *Ship->GetCurrentSector()->GetSectorName().ToString());
 					}
 				}
+				Integrity = false;
 			}
 		}
 	}
-}
-
-void UFlareWorld::FastForward()
-{
-	Simulate();
-	// TODO repair
-	/*int64 FastForwardEnd = WorldData.Time + 86400;
 
-	while(WorldData.Time < FastForwardEnd)
+#if !UE_BUILD_SHIPPING
+	// Cargo bay totals
+	for (int32 SpacecraftIndex = 0 ; SpacecraftIndex < Company->GetCompanySpacecrafts().Num(); SpacecraftIndex++)
 	{
-		TArray<FFlareWorldEvent> NextEvents = GenerateEvents();
-
-		if (NextEvents.Num() == 0)
+		if (!Company->GetCompanySpacecrafts()[SpacecraftIndex]->GetCargoBay()->CheckAggregates())
 		{
-			// Nothing will append in futur
-			return;
+			Integrity = false;
 		}
+	}
+#endif
 
-		FFlareWorldEvent& NextEvent = NextEvents[0];
+	// Fleets
+	for (int32 FleetIndex = 0 ; FleetIndex < Company->GetCompanyFleets().Num(); FleetIndex++)
+	{
+		UFlareFleet* Fleet = Company->GetCompanyFleets()[FleetIndex];
 
-		if (NextEvent.Time < WorldData.Time)
+		if(Fleet->GetShipCount() == 0)
 		{
-			FLOGV("Fast forward fail: next event is in the past. Current time is %ld but next event time %ld", WorldData.Time, NextEvent.Time);
-			return;
+			FLOGV("WARNING : World integrity failure : %s fleet %s is empty",
+				  *Company->GetCompanyName().ToString(),
+				  *Fleet->GetFleetName().ToString());
+			Integrity = false;
 		}
 
-		int64 TimeJump = NextEvent.Time - WorldData.Time;
-
-		if(NextEvent.Time > FastForwardEnd)
+		if(Fleet->GetCurrentSector() == NULL )
 		{
-			TimeJump = FastForwardEnd - WorldData.Time;
+			FLOGV("WARNING : World integrity failure : %s fleet %s is not in a sector",
+				  *Company->GetCompanyName().ToString(),
+				  *Fleet->GetFleetName().ToString());
+			Integrity = false;
 		}
-
-		Simulate(TimeJump);
-
-		if (NextEvent.Visibility == EFlareEventVisibility::Blocking)
+		else if(Fleet->GetCurrentSector()->IsTravelSector() && Fleet->GetCurrentTravel() == NULL)
 		{
-			// End fast forward
-			break;
+			FLOGV("WARNING : World integrity failure : %s fleet %s is in a travel sector and not in travel",
+				  *Company->GetCompanyName().ToString(),
+				  *Fleet->GetFleetName().ToString());
+			Integrity = false;
 		}
-	}*/
+	}
+
+	return Integrity;
 }
 
-void UFlareWorld::ForceDate(int64 Date)
+/** Return the time since StartTime and restart the measure */
+static double ConsumePhaseTime(double& StartTime)
 {
-	while(WorldData.Date < Date)
-	{
-		Simulate();
-	}
+	double Time = FPlatformTime::Seconds();
+	double Elapsed = Time - StartTime;
+	StartTime = Time;
+	return Elapsed;
 }
 
-inline static bool EventDateComparator (const FFlareWorldEvent& ip1, const FFlareWorldEvent& ip2)
- {
-	 return (ip1.Date < ip2.Date);
- }
-
-TArray<FFlareWorldEvent> UFlareWorld::GenerateEvents(UFlareCompany* PointOfView)
+void UFlareWorld::Simulate(int64 SpanDays)
 {
-	TArray<FFlareWorldEvent> NextEvents;
+	SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Simulate);
 
-	// TODO Implements PointOfView
-
-	// Generate travel events
-	for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+	UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
+	double DayStartTime = FPlatformTime::Seconds();
+	double PhaseStartTime = DayStartTime;
+
+#if FLARE_CALL_COUNTERS
+	// Drop the calls made between two days
+	int32 CallCounts[EFlareSimulationCall::Count];
+	FFlareSimulationCallCounters::Collect(CallCounts);
+#endif
+	MoneyLedger.BeginDay();
+
+	// Companies play and factories advance at the start of a span only
+	int64 FactoryDays = 0;
+	if (WorldData.Date >= SpanEndDate)
 	{
-		FFlareWorldEvent TravelEvent;
-
-		TravelEvent.Date = WorldData.Date + Travels[TravelIndex]->GetRemainingTravelDuration();
-		TravelEvent.Visibility = EFlareEventVisibility::Blocking;
-		NextEvents.Add(TravelEvent);
+		FactoryDays = FMath::Max(SpanDays, (int64) 1);
+		SpanEndDate = WorldData.Date + FactoryDays;
 	}
 
-	// Generate factory events
-	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	/**
+	 *  End previous day
+	 */
+
+	// Finish player battles
 	{
-		FFlareWorldEvent *FactoryEvent = Factories[FactoryIndex]->GenerateEvent();
-		if (FactoryEvent)
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Battles);
+
+		for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
 		{
-			NextEvents.Add(*FactoryEvent);
-		}
-	}
+			UFlareSimulatedSector* Sector = Sectors[SectorIndex];
 
-	NextEvents.Sort(&EventDateComparator);
+			EFlareSectorBattleState::Type BattleState = Sector->GetSectorBattleState(PlayerCompany);
 
-	return NextEvents;
-}
+			if(BattleState != EFlareSectorBattleState::NoBattle && BattleState != EFlareSectorBattleState::BattleWon)
+			{
+				// Destroy all player ships
+				TArray<UFlareSimulatedSpacecraft*> ShipToDestroy;
 
-void UFlareWorld::ClearFactories(UFlareSimulatedSpacecraft *ParentSpacecraft)
-{
+				for (int ShipIndex = 0; ShipIndex < Sector->GetSectorShips().Num(); ShipIndex++)
+				{
+					if(Sector->GetSectorShips()[ShipIndex]->GetCompany() == PlayerCompany)
+					{
+						ShipToDestroy.Add(Sector->GetSectorShips()[ShipIndex]);
+					}
+				}
+
+				for (int ShipIndex = 0; ShipIndex < ShipToDestroy.Num(); ShipIndex++)
+				{
+					PlayerCompany->DestroySpacecraft(ShipToDestroy[ShipIndex]);
+				}
+			}
+		}
+		// TODO battles between 2 AI company
+	}
+
+	// AI. Play them in random order
+	ConsumePhaseTime(PhaseStartTime);
+	if (FactoryDays > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_AI);
+
+		// All companies plan on the state of the world before the first one trades
+		if (SharedResourceVariation)
+		{
+			ResourceVariationCache.Update(this, Game);
+		}
+
+		if (ParallelAIPlanning)
+		{
+			PlanAI();
+		}
+
+		// Commit the plans in random order : the first company to trade or build gets the stock or the room
+		TArray<UFlareCompany*> CompaniesToSimulateAI = Companies;
+		while(CompaniesToSimulateAI.Num())
+		{
+			int32 Index = FMath::RandRange(0, CompaniesToSimulateAI.Num() - 1);
+			CompaniesToSimulateAI[Index]->SimulateAI();
+			CompaniesToSimulateAI.RemoveAt(Index);
+		}
+	}
+	LastSimulationTimings.AI = ConsumePhaseTime(PhaseStartTime);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_MutualAssistance);
+		CompanyMutualAssistance();
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Integrity);
+		if (!IntegrityAuditDeferred)
+		{
+			AuditIntegrity();
+		}
+	}
+
+	/**
+	 *  Begin day
+	 */
+	WorldData.Date++;
+
+	// End trade operation
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
+		for (int32 ShipIndex = 0; ShipIndex < Sector->GetSectorSpacecrafts().Num(); ShipIndex++)
+		{
+			Sector->GetSectorSpacecrafts()[ShipIndex]->SetTrading(false);
+		}
+	}
+
+	// Factories and peoples
+	SimulateFactoriesAndPeople(FactoryDays);
+
+
+	FLOG("Trade routes");
+
+	// Trade routes
+	ConsumePhaseTime(PhaseStartTime);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_TradeRoutes);
+
+		for (int CompanyIndex = 0; CompanyIndex < Companies.Num(); CompanyIndex++)
+		{
+			TArray<UFlareTradeRoute*>& TradeRoutes = Companies[CompanyIndex]->GetCompanyTradeRoutes();
+
+			for (int RouteIndex = 0; RouteIndex < TradeRoutes.Num(); RouteIndex++)
+			{
+				TradeRoutes[RouteIndex]->Simulate();
+			}
+		}
+	}
+	LastSimulationTimings.TradeRoutes = ConsumePhaseTime(PhaseStartTime);
+
+	// Travels
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Travels);
+
+		for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+		{
+			Travels[TravelIndex]->Simulate();
+		}
+	}
+	LastSimulationTimings.Travels = ConsumePhaseTime(PhaseStartTime);
+
+	// Reputation stabilization
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Reputation);
+		CompanyRelations.StabilizeReputations(0.01f);
+	}
+
+	// Price variation.
+	ConsumePhaseTime(PhaseStartTime);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_PriceVariation);
+		SimulatePriceVariation();
+	}
+	LastSimulationTimings.PriceVariation = ConsumePhaseTime(PhaseStartTime);
+
+	// People money migration
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_MoneyMigration);
+		SimulatePeopleMoneyMigration();
+	}
+	LastSimulationTimings.MoneyMigration = ConsumePhaseTime(PhaseStartTime);
+
+	// Process events
+
+	// Swap Prices.
+	if (BatchedPriceVariation)
+	{
+		// Prices didn't change since the price variation : append the world table rows
+		int32 ResourceCount = Game->GetResourceCatalog()->Resources.Num();
+		for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+		{
+			Sectors[SectorIndex]->SwapPrices(&NewPriceTable[SectorIndex * ResourceCount]);
+		}
+	}
+	else
+	{
+		for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+		{
+			Sectors[SectorIndex]->SwapPrices();
+		}
+	}
+
+	// Keep the day stats
+	LastSimulationTimings.Date = WorldData.Date;
+	LastSimulationTimings.Total = FPlatformTime::Seconds() - DayStartTime;
+
+#if FLARE_CALL_COUNTERS
+	// All parallel tasks are done : merge the thread counters
+	FFlareSimulationCallCounters::Collect(CallCounts);
+	LastSimulationTimings.ComputeTravelDurationCalls = CallCounts[EFlareSimulationCall::ComputeTravelDuration];
+	LastSimulationTimings.GetResourceQuantityCalls = CallCounts[EFlareSimulationCall::GetResourceQuantity];
+	LastSimulationTimings.FindTradeStationCalls = CallCounts[EFlareSimulationCall::FindTradeStation];
+	SET_DWORD_STAT(STAT_FlareCalls_ComputeTravelDuration, LastSimulationTimings.ComputeTravelDurationCalls);
+	SET_DWORD_STAT(STAT_FlareCalls_GetResourceQuantity, LastSimulationTimings.GetResourceQuantityCalls);
+	SET_DWORD_STAT(STAT_FlareCalls_FindTradeStation, LastSimulationTimings.FindTradeStationCalls);
+#endif
+
+	SimulationHistory.Add(LastSimulationTimings);
+	if (SimulationHistory.Num() > SIMULATION_HISTORY_SIZE)
+	{
+		SimulationHistory.RemoveAt(0);
+	}
+}
+
+/** Factory and people work of one sector, run out of the game thread */
+struct FFlareSectorSimulationTask
+{
+	UFlareSimulatedSector* Sector;
+
+	/** Factories of the sector, in world order */
+	TArray<UFlareFactory*> Factories;
+	TArray<int32> FactoryIndexes;
+
+	/** False if a factory of the sector depends on other sectors */
+	bool IsParallel;
+
+	/** Population before simulation */
+	uint32 Population;
+
+	FFlareSectorSimulationBuffer Buffer;
+};
+
+static void CommitMoneyOperation(const FFlareStagedMoneyOperation& Operation)
+{
+	if (Operation.Take)
+	{
+		Operation.Company->TakeMoney(Operation.Amount, true);
+	}
+	else
+	{
+		Operation.Company->GiveMoney(Operation.Amount);
+	}
+}
+
+/** Simulate a factory for a day, or advance it over a span of days */
+static void AdvanceFactory(UFlareFactory* Factory, int64 Days)
+{
+	if (Days == 1)
+	{
+		Factory->Simulate();
+	}
+	else if (Days > 1)
+	{
+		Factory->AdvanceDays(Days);
+	}
+}
+
+void UFlareWorld::SimulateFactoriesAndPeople(int64 FactoryDays)
+{
+	double PhaseStartTime = FPlatformTime::Seconds();
+
+	if (!ParallelSimulation)
+	{
+		FLOG("Factories");
+		{
+			SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Factories);
+			for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+			{
+				AdvanceFactory(Factories[FactoryIndex], FactoryDays);
+			}
+		}
+		LastSimulationTimings.Factories = ConsumePhaseTime(PhaseStartTime);
+
+		FLOG("Peoples");
+		{
+			SCOPE_CYCLE_COUNTER(STAT_FlareWorld_People);
+
+			// Purchases need the sector stations, the population day only the people data
+			TArray<uint32> Populations;
+			TArray<UFlarePeople*> PopulatedPeople;
+			TArray<FFlarePeopleSave*> PopulationData;
+			TArray<FFlarePopulationDay> PopulationDays;
+
+			for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+			{
+				UFlarePeople* People = Sectors[SectorIndex]->GetPeople();
+				Populations.Add(People->GetPopulation());
+
+				if (People->GetPopulation() > 0)
+				{
+					People->SimulateResourcePurchase();
+					PopulatedPeople.Add(People);
+					PopulationData.Add(People->Save());
+				}
+			}
+
+			UFlarePeople::SimulatePopulations(PopulationData, PopulationDays);
+
+			int32 PopulatedIndex = 0;
+			for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+			{
+				if (Populations[SectorIndex] > 0)
+				{
+					PopulatedPeople[PopulatedIndex]->RecordPopulationDay(PopulationDays[PopulatedIndex]);
+					PopulatedIndex++;
+					continue;
+				}
+
+				// Serial order see the new population of previous sectors and the old one of next sectors
+				uint32 WorldPopulation = 0;
+				for (int OtherSectorIndex = 0; OtherSectorIndex < Sectors.Num(); OtherSectorIndex++)
+				{
+					if (OtherSectorIndex < SectorIndex)
+					{
+						WorldPopulation += Sectors[OtherSectorIndex]->GetPeople()->GetPopulation();
+					}
+					else if (OtherSectorIndex > SectorIndex)
+					{
+						WorldPopulation += Populations[OtherSectorIndex];
+					}
+				}
+
+				// With a populated world, an empty sector simulation does nothing
+				if (WorldPopulation == 0)
+				{
+					Sectors[SectorIndex]->GetPeople()->Simulate();
+				}
+			}
+		}
+		LastSimulationTimings.People = ConsumePhaseTime(PhaseStartTime);
+		return;
+	}
+
+	/**
+	 * A sector only touch its own stations and people, except for company money and
+	 * the money ledger. These are staged by each task, then replayed in the
+	 * serial order so the result is identical to the serial simulation.
+	 * Shipyards read company money and create ships : their sector stay serial.
+	 */
+	TArray<FFlareSectorSimulationTask> Tasks;
+	TMap<UFlareSimulatedSector*, int32> SectorTaskIndexes;
+	TArray<int32> FactoryTaskIndexes;
+	TArray<int32> OperationCursors;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Factories);
+
+		Tasks.SetNum(Sectors.Num());
+		for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+		{
+			FFlareSectorSimulationTask& Task = Tasks[SectorIndex];
+			Task.Sector = Sectors[SectorIndex];
+			Task.IsParallel = true;
+			Task.Population = Task.Sector->GetPeople()->GetPopulation();
+			SectorTaskIndexes.Add(Task.Sector, SectorIndex);
+		}
+
+		FactoryTaskIndexes.SetNum(Factories.Num());
+		for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+		{
+			UFlareFactory* Factory = Factories[FactoryIndex];
+			int32* TaskIndex = SectorTaskIndexes.Find(Factory->GetParent()->GetCurrentSector());
+			FactoryTaskIndexes[FactoryIndex] = (TaskIndex ? *TaskIndex : -1);
+
+			if (TaskIndex)
+			{
+				FFlareSectorSimulationTask& Task = Tasks[*TaskIndex];
+				Task.Factories.Add(Factory);
+				Task.FactoryIndexes.Add(FactoryIndex);
+
+				if (Factory->IsShipyard())
+				{
+					Task.IsParallel = false;
+				}
+			}
+		}
+
+		// Parallel phase
+		ParallelFor(Tasks.Num(), [&Tasks, FactoryDays](int32 TaskIndex)
+		{
+			FFlareSectorSimulationTask& Task = Tasks[TaskIndex];
+			if (!Task.IsParallel)
+			{
+				return;
+			}
+
+			Task.Sector->SetSimulationBuffer(&Task.Buffer);
+
+			for (int FactoryIndex = 0; FactoryIndex < Task.Factories.Num(); FactoryIndex++)
+			{
+				Task.Buffer.CurrentOrder = Task.FactoryIndexes[FactoryIndex];
+				AdvanceFactory(Task.Factories[FactoryIndex], FactoryDays);
+			}
+
+			// Empty sectors may respawn people depending on the world population : done in commit
+			if (Task.Population > 0)
+			{
+				Task.Buffer.CurrentOrder = -1;
+				Task.Sector->GetPeople()->Simulate();
+			}
+
+			Task.Sector->SetSimulationBuffer(NULL);
+		});
+
+		// Commit factories in world order
+		FLOG("Factories");
+		OperationCursors.SetNumZeroed(Tasks.Num());
+
+		for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+		{
+			int32 TaskIndex = FactoryTaskIndexes[FactoryIndex];
+
+			if (TaskIndex < 0 || !Tasks[TaskIndex].IsParallel)
+			{
+				AdvanceFactory(Factories[FactoryIndex], FactoryDays);
+				continue;
+			}
+
+			TArray<FFlareStagedMoneyOperation>& Operations = Tasks[TaskIndex].Buffer.MoneyOperations;
+			int32& Cursor = OperationCursors[TaskIndex];
+			for (; Cursor < Operations.Num() && Operations[Cursor].Order == FactoryIndex; Cursor++)
+			{
+				CommitMoneyOperation(Operations[Cursor]);
+			}
+		}
+	}
+
+	// Parallel tasks also simulate their people : count them as factories
+	LastSimulationTimings.Factories = ConsumePhaseTime(PhaseStartTime);
+
+	// Commit peoples in sector order
+	FLOG("Peoples");
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_People);
+
+		for (int SectorIndex = 0; SectorIndex < Tasks.Num(); SectorIndex++)
+		{
+			FFlareSectorSimulationTask& Task = Tasks[SectorIndex];
+
+			if (Task.Population == 0)
+			{
+				// Serial order see the new population of previous sectors and the old one of next sectors
+				uint32 WorldPopulation = 0;
+				for (int OtherSectorIndex = 0; OtherSectorIndex < Tasks.Num(); OtherSectorIndex++)
+				{
+					if (OtherSectorIndex < SectorIndex)
+					{
+						WorldPopulation += Tasks[OtherSectorIndex].Sector->GetPeople()->GetPopulation();
+					}
+					else if (OtherSectorIndex > SectorIndex)
+					{
+						WorldPopulation += Tasks[OtherSectorIndex].Population;
+					}
+				}
+
+				// With a populated world, an empty sector simulation does nothing
+				if (WorldPopulation == 0)
+				{
+					Task.Sector->GetPeople()->Simulate();
+				}
+			}
+			else if (!Task.IsParallel)
+			{
+				Task.Sector->GetPeople()->Simulate();
+			}
+			else
+			{
+				TArray<FFlareStagedMoneyOperation>& Operations = Task.Buffer.MoneyOperations;
+				for (int32 Cursor = OperationCursors[SectorIndex]; Cursor < Operations.Num(); Cursor++)
+				{
+					CommitMoneyOperation(Operations[Cursor]);
+				}
+			}
+		}
+
+		// Record the transfers of the parallel sectors
+		for (int SectorIndex = 0; SectorIndex < Tasks.Num(); SectorIndex++)
+		{
+			TArray<FFlareMoneyTransfer>& Transfers = Tasks[SectorIndex].Buffer.Transfers;
+			for (int32 TransferIndex = 0; TransferIndex < Transfers.Num(); TransferIndex++)
+			{
+				FFlareMoneyTransfer& Transfer = Transfers[TransferIndex];
+				MoneyLedger.RecordTransfer(Transfer.Source, Transfer.Destination, Transfer.Amount, Transfer.Reason);
+			}
+		}
+	}
+
+	LastSimulationTimings.People = ConsumePhaseTime(PhaseStartTime);
+}
+
+int64 UFlareWorld::GetTravelDuration(UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector)
+{
+	int32 OriginSlot = OriginSector->GetSectorSlot();
+	int32 DestinationSlot = DestinationSector->GetSectorSlot();
+
+	// Travel sectors are not in the matrix
+	if (OriginSlot < 0 || DestinationSlot < 0)
+	{
+		return UFlareTravel::ComputeTravelDuration(this, OriginSector, DestinationSector);
+	}
+
+	if (TravelDurationsDirty)
+	{
+		UpdateTravelDurations();
+	}
+
+	return TravelDurations[OriginSlot * Sectors.Num() + DestinationSlot];
+}
+
+void UFlareWorld::UpdateTravelDurations()
+{
+	// Durations only depend on the sector orbits and the celestial bodies, which don't move
+	TravelDurations.SetNumUninitialized(Sectors.Num() * Sectors.Num());
+
+	for (int32 OriginIndex = 0; OriginIndex < Sectors.Num(); OriginIndex++)
+	{
+		for (int32 DestinationIndex = 0; DestinationIndex < Sectors.Num(); DestinationIndex++)
+		{
+			TravelDurations[OriginIndex * Sectors.Num() + DestinationIndex] = UFlareTravel::ComputeTravelDuration(this, Sectors[OriginIndex], Sectors[DestinationIndex]);
+		}
+	}
+
+	TravelDurationsDirty = false;
+}
+
+const FFlareResourceVariationCache& UFlareWorld::GetResourceVariationCache()
+{
+	if (ResourceVariationCache.GetDate() != GetDate())
+	{
+		ResourceVariationCache.Update(this, Game);
+	}
+
+	return ResourceVariationCache;
+}
+
+void UFlareWorld::PlanAI()
+{
+	// Unset prices are set when first read : set them all before the parallel reads
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+		{
+			Sectors[SectorIndex]->GetPreciseResourcePrice(&Game->GetResourceCatalog()->Resources[ResourceIndex]->Data);
+		}
+	}
+
+	// Same for the factory cycle costs, read by the company scans without the shared variations
+	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	{
+		Factories[FactoryIndex]->GetCycleData();
+	}
+
+	// Plans only read the world, the companies don't see each other until the commit
+	ParallelFor(Companies.Num(), [this](int32 CompanyIndex)
+	{
+		Companies[CompanyIndex]->GetAI()->Plan();
+	});
+}
+
+void UFlareWorld::SimulatePriceVariation()
+{
+	if (!BatchedPriceVariation)
+	{
+		for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+		{
+			Sectors[SectorIndex]->SimulatePriceVariation();
+		}
+		return;
+	}
+
+	ComputePriceVariation();
+
+	// Write back each sector row at once, then log the changed prices in sector order
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	int32 ResourceCount = ResourceCatalog->Resources.Num();
+
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
+		Sector->SetPreciseResourcePrices(&NewPriceTable[SectorIndex * ResourceCount]);
+
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			int32 PriceIndex = SectorIndex * ResourceCount + ResourceIndex;
+
+			if (WantedPriceVariations[PriceIndex] != 0.f)
+			{
+				Sector->LogPriceVariation(&ResourceCatalog->Resources[ResourceIndex]->Data,
+					PriceTable[PriceIndex], VariedPrices[PriceIndex], PriceVariations[PriceIndex]);
+			}
+		}
+	}
+}
+
+void UFlareWorld::ComputePriceVariation()
+{
+	/**
+	 * The wanted variations only depend on the stations, not on prices :
+	 * gather them for the whole world, then vary every price in one loop.
+	 */
+	UFlareResourceCatalog* ResourceCatalog = Game->GetResourceCatalog();
+	int32 ResourceCount = ResourceCatalog->Resources.Num();
+	int32 PriceCount = Sectors.Num() * ResourceCount;
+
+	PriceTable.SetNumUninitialized(PriceCount);
+	WantedPriceVariations.SetNumUninitialized(PriceCount);
+	MinPriceTable.SetNumUninitialized(PriceCount);
+	MaxPriceTable.SetNumUninitialized(PriceCount);
+	PriceRangeTable.SetNumUninitialized(PriceCount);
+
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = Sectors[SectorIndex];
+
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCount; ResourceIndex++)
+		{
+			FFlareResourceDescription* Resource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+			int32 PriceIndex = SectorIndex * ResourceCount + ResourceIndex;
+
+			PriceTable[PriceIndex] = Sector->GetPreciseResourcePrice(Resource);
+			WantedPriceVariations[PriceIndex] = Sector->ComputeWantedPriceVariation(Resource);
+			MinPriceTable[PriceIndex] = (float) Resource->MinPrice;
+			MaxPriceTable[PriceIndex] = (float) Resource->MaxPrice;
+			PriceRangeTable[PriceIndex] = (float) (Resource->MaxPrice - Resource->MinPrice);
+		}
+	}
+
+	ComputeVariedPrices(PriceTable, WantedPriceVariations, MinPriceTable, MaxPriceTable, PriceRangeTable, VariedPrices, PriceVariations, NewPriceTable);
+}
+
+void UFlareWorld::ComputeVariedPrices(const TArray<float>& OldPrices, const TArray<float>& WantedVariations,
+	const TArray<float>& MinPrices, const TArray<float>& MaxPrices, const TArray<float>& PriceRanges,
+	TArray<float>& OutVariedPrices, TArray<float>& OutVariations, TArray<float>& OutNewPrices)
+{
+	int32 PriceCount = OldPrices.Num();
+	OutVariedPrices.SetNumUninitialized(PriceCount);
+	OutVariations.SetNumUninitialized(PriceCount);
+	OutNewPrices.SetNumUninitialized(PriceCount);
+
+	const float* RESTRICT OldPriceData = OldPrices.GetData();
+	const float* RESTRICT WantedVariationData = WantedVariations.GetData();
+	const float* RESTRICT MinPriceData = MinPrices.GetData();
+	const float* RESTRICT MaxPriceData = MaxPrices.GetData();
+	const float* RESTRICT PriceRangeData = PriceRanges.GetData();
+	float* RESTRICT VariedPriceData = OutVariedPrices.GetData();
+	float* RESTRICT VariationData = OutVariations.GetData();
+	float* RESTRICT NewPriceData = OutNewPrices.GetData();
+
+	// Float arrays only, selects instead of branches : a single loop the compiler can vectorize
+	for (int32 PriceIndex = 0; PriceIndex < PriceCount; PriceIndex++)
+	{
+		float OldPrice = OldPriceData[PriceIndex];
+		float WantedVariation = WantedVariationData[PriceIndex];
+		float Variation;
+		float VariedPrice = UFlareSimulatedSector::ComputeVariedPriceFromRange(OldPrice, WantedVariation,
+			MinPriceData[PriceIndex], PriceRangeData[PriceIndex], Variation);
+
+		// Without wanted variation the price is left as is, else clamped as SetPreciseResourcePrice does
+		float ClampedPrice = FMath::Clamp(VariedPrice, MinPriceData[PriceIndex], MaxPriceData[PriceIndex]);
+
+		VariedPriceData[PriceIndex] = VariedPrice;
+		VariationData[PriceIndex] = Variation;
+		NewPriceData[PriceIndex] = (WantedVariation != 0.f ? ClampedPrice : OldPrice);
+	}
+}
+
+void UFlareWorld::SimulatePeopleMoneyMigration()
+{
+	if (!PooledMoneyMigration)
+	{
+		SimulatePairwiseMoneyMigration();
+		return;
+	}
+
+	// Pool migration on the sector balances
+	TArray<int64> Money;
+	TArray<int64> Population;
+	Money.SetNum(Sectors.Num());
+	Population.SetNum(Sectors.Num());
+
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		UFlarePeople* People = Sectors[SectorIndex]->GetPeople();
+		Money[SectorIndex] = People->GetMoney();
+		Population[SectorIndex] = People->GetPopulation();
+	}
+
+	TArray<int64> Leaks;
+	TArray<int64> Shares;
+	ComputePooledMoneyMigration(Money, Population, Leaks, Shares);
+
+	// Fill the pool, then share it
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		if (Leaks[SectorIndex] > 0)
+		{
+			UFlarePeople* People = Sectors[SectorIndex]->GetPeople();
+			People->TakeMoney((uint32) Leaks[SectorIndex]);
+			MoneyLedger.RecordTransfer(People, this, Leaks[SectorIndex], EFlareMoneyReason::Migration);
+		}
+	}
+
+	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
+	{
+		if (Shares[SectorIndex] > 0)
+		{
+			UFlarePeople* People = Sectors[SectorIndex]->GetPeople();
+			People->Pay((uint32) Shares[SectorIndex]);
+			MoneyLedger.RecordTransfer(this, People, Shares[SectorIndex], EFlareMoneyReason::Migration);
+		}
+	}
+}
+
+void UFlareWorld::ComputePooledMoneyMigration(const TArray<int64>& Money, const TArray<int64>& Population, TArray<int64>& OutLeaks, TArray<int64>& OutShares)
+{
+	/**
+	 * Each sector is compared with the average wealth of the populated sectors instead of with
+	 * every other sector. Empty sectors and sectors wealthier than the average leak into a pool,
+	 * shared by the poorer sectors in proportion of their deficit. Migration stops when all
+	 * populated sectors have the same wealth and empty sectors have no money.
+	 */
+	int32 SectorCount = Money.Num();
+	int64 PopulatedMoney = 0;
+	int64 TotalPopulation = 0;
+	int32 PopulatedSectorCount = 0;
+
+	OutLeaks.SetNumZeroed(SectorCount);
+	OutShares.SetNumZeroed(SectorCount);
+
+	for (int SectorIndex = 0; SectorIndex < SectorCount; SectorIndex++)
+	{
+		if (Population[SectorIndex] > 0)
+		{
+			PopulatedMoney += Money[SectorIndex];
+			TotalPopulation += Population[SectorIndex];
+			PopulatedSectorCount++;
+		}
+	}
+
+	if (PopulatedSectorCount == 0)
+	{
+		// No populated sector. Do nothing
+		return;
+	}
+
+	double AverageWealth = (double) PopulatedMoney / (double) TotalPopulation;
+
+	// In the pairwise model, an empty sector leak 10% to each populated sector in turn
+	double EmptyLeakRatio = 1.0 - FMath::Pow(0.9f, PopulatedSectorCount);
+
+	TArray<int64> Deficits;
+	Deficits.SetNumZeroed(SectorCount);
+	int64 Pool = 0;
+	int64 TotalDeficit = 0;
+
+	for (int SectorIndex = 0; SectorIndex < SectorCount; SectorIndex++)
+	{
+		if (Population[SectorIndex] == 0)
+		{
+			OutLeaks[SectorIndex] = EmptyLeakRatio * Money[SectorIndex];
+		}
+		else
+		{
+			double Wealth = (double) Money[SectorIndex] / (double) Population[SectorIndex];
+			int64 AverageMoney = AverageWealth * Population[SectorIndex];
+
+			if (Wealth > AverageWealth)
+			{
+				// Pairwise leak against an average sector, for each other populated sector, without going under the average
+				double LeakRatio = 0.02 * ((Wealth / (Wealth + AverageWealth)) - 0.5) * (PopulatedSectorCount - 1);
+				OutLeaks[SectorIndex] = FMath::Min((int64) (LeakRatio * Money[SectorIndex]), Money[SectorIndex] - AverageMoney);
+			}
+			else
+			{
+				Deficits[SectorIndex] = AverageMoney - Money[SectorIndex];
+			}
+		}
+
+		Pool += OutLeaks[SectorIndex];
+		TotalDeficit += Deficits[SectorIndex];
+	}
+
+	if (Pool <= 0)
+	{
+		return;
+	}
+
+	// People money is 32 bits : slow down the migration so no share can overflow it
+	if (Pool > MAX_uint32)
+	{
+		int64 ScaledPool = 0;
+		for (int SectorIndex = 0; SectorIndex < SectorCount; SectorIndex++)
+		{
+			OutLeaks[SectorIndex] = (int64) ((double) OutLeaks[SectorIndex] * MAX_uint32 / Pool);
+			ScaledPool += OutLeaks[SectorIndex];
+		}
+		Pool = ScaledPool;
+	}
+
+	// Share the pool by deficit, or by population if all populated sectors have the same wealth
+	int32 LastRecipientIndex = -1;
+	int64 TotalWeight = 0;
+	for (int SectorIndex = 0; SectorIndex < SectorCount; SectorIndex++)
+	{
+		int64 Weight = (TotalDeficit > 0 ? Deficits[SectorIndex] : Population[SectorIndex]);
+		if (Weight > 0)
+		{
+			LastRecipientIndex = SectorIndex;
+			TotalWeight += Weight;
+		}
+	}
+
+	int64 RemainingPool = Pool;
+	for (int SectorIndex = 0; SectorIndex <= LastRecipientIndex; SectorIndex++)
+	{
+		int64 Weight = (TotalDeficit > 0 ? Deficits[SectorIndex] : Population[SectorIndex]);
+		if (Weight <= 0)
+		{
+			continue;
+		}
+
+		// The last recipient get the rounding remainder
+		int64 Share = (SectorIndex == LastRecipientIndex ? RemainingPool : (int64) ((double) Pool * Weight / TotalWeight));
+		Share = FMath::Clamp(Share, (int64) 0, FMath::Min(RemainingPool, (int64) MAX_uint32));
+		RemainingPool -= Share;
+
+		OutShares[SectorIndex] = Share;
+	}
+}
+
+void UFlareWorld::SimulatePairwiseMoneyMigration()
+{
+	for (int SectorIndexA = 0; SectorIndexA < Sectors.Num(); SectorIndexA++)
+	{
+		UFlarePeople* PeopleA = Sectors[SectorIndexA]->GetPeople();
+
+		for (int SectorIndexB = SectorIndexA + 1; SectorIndexB < Sectors.Num(); SectorIndexB++)
+		{
+			UFlarePeople* PeopleB = Sectors[SectorIndexB]->GetPeople();
+
+			int64 Transfert = ComputePairwiseMoneyMigration(PeopleA->GetMoney(), PeopleA->GetPopulation(), PeopleB->GetMoney(), PeopleB->GetPopulation());
+			if (Transfert > 0)
+			{
+				PeopleA->TakeMoney(Transfert);
+				PeopleB->Pay(Transfert);
+				MoneyLedger.RecordTransfer(PeopleA, PeopleB, Transfert, EFlareMoneyReason::Migration);
+			}
+			else if (Transfert < 0)
+			{
+				PeopleB->TakeMoney(-Transfert);
+				PeopleA->Pay(-Transfert);
+				MoneyLedger.RecordTransfer(PeopleB, PeopleA, -Transfert, EFlareMoneyReason::Migration);
+			}
+		}
+	}
+}
+
+int64 UFlareWorld::ComputePairwiseMoneyMigration(int64 MoneyA, int64 PopulationA, int64 MoneyB, int64 PopulationB)
+{
+	if (PopulationA == 0 && PopulationB == 0)
+	{
+		// 2 sector without population. Do nothing
+		return 0;
+	}
+	else if (PopulationA == 0)
+	{
+		// Origin sector has no population so it leak it's money
+		return MoneyA / 10;
+	}
+	else if (PopulationB == 0)
+	{
+		// Destination sector has no population so it leak it's money
+		return -(MoneyB / 10);
+	}
+
+	// Both have population. The wealthier leak. The legacy code read the wealth of A twice, so populated sectors never exchanged money
+	float WealthA = (float) MoneyA / (float) PopulationA;
+	float WealthB = (float) MoneyB / (float) PopulationB;
+	float TotalWealth = WealthA + WealthB;
+
+	if (TotalWealth <= 0)
+	{
+		return 0;
+	}
+
+	if (WealthA > WealthB)
+	{
+		float LeakRatio = 0.02f * ((WealthA / TotalWealth) - 0.5f); // 1% at max
+		return (uint32) (LeakRatio * MoneyA);
+	}
+	else
+	{
+		float LeakRatio = 0.02f * ((WealthB / TotalWealth) - 0.5f); // 1% at max
+		return -(int64) (uint32) (LeakRatio * MoneyB);
+	}
+}
+
+/** Progress of a player quest, to stop the fast forward when one moves */
+struct FFlareQuestProgress
+{
+	FName Quest;
+	FName Step;
+	EFlareQuestStatus::Type Status;
+
+	bool operator==(const FFlareQuestProgress& Other) const
+	{
+		return Quest == Other.Quest && Step == Other.Step && Status == Other.Status;
+	}
+};
+
+/** Active quests with their current step, then ended quests */
+static void GetQuestProgress(UFlareQuestManager* QuestManager, TArray<FFlareQuestProgress>& OutProgress)
+{
+	OutProgress.Empty();
+
+	if (!QuestManager)
+	{
+		return;
+	}
+
+	for (int QuestIndex = 0; QuestIndex < QuestManager->GetActiveQuests().Num(); QuestIndex++)
+	{
+		UFlareQuest* Quest = QuestManager->GetActiveQuests()[QuestIndex];
+		const FFlareQuestStepDescription* Step = Quest->GetCurrentStepDescription();
+
+		FFlareQuestProgress Progress;
+		Progress.Quest = Quest->GetIdentifier();
+		Progress.Step = (Step ? Step->Identifier : NAME_None);
+		Progress.Status = Quest->GetStatus();
+		OutProgress.Add(Progress);
+	}
+
+	for (int QuestIndex = 0; QuestIndex < QuestManager->GetPreviousQuests().Num(); QuestIndex++)
+	{
+		UFlareQuest* Quest = QuestManager->GetPreviousQuests()[QuestIndex];
+
+		FFlareQuestProgress Progress;
+		Progress.Quest = Quest->GetIdentifier();
+		Progress.Step = NAME_None;
+		Progress.Status = Quest->GetStatus();
+		OutProgress.Add(Progress);
+	}
+}
+
+bool UFlareWorld::FastForward(int64 MaxDays)
+{
+	UFlareCompany* PlayerCompany = Game->GetPC()->GetCompany();
+	int64 FastForwardStart = WorldData.Date;
+	int64 TargetDate = WorldData.Date + MaxDays;
+	bool EventReached = false;
+
+	// Keep battle states to stop on changes
+	TMap<UFlareSimulatedSector*, EFlareSectorBattleState::Type> BattleStates;
+	for (int SectorIndex = 0; SectorIndex < PlayerCompany->GetKnownSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Sector = PlayerCompany->GetKnownSectors()[SectorIndex];
+		BattleStates.Add(Sector, Sector->GetSectorBattleState(PlayerCompany));
+	}
+
+	// Keep quest progress to stop on quest triggers
+	TArray<FFlareQuestProgress> QuestProgress;
+	TArray<FFlareQuestProgress> NewQuestProgress;
+	GetQuestProgress(Game->GetQuestManager(), QuestProgress);
+
+	// Days inside the jump are audited once at the end
+	IntegrityAuditDeferred = true;
+
+	while (WorldData.Date < TargetDate && !EventReached)
+	{
+		// Find the next blocking event. New travels may generate earlier events so check every day
+		TArray<FFlareWorldEvent> NextEvents = GenerateEvents(PlayerCompany);
+		bool BlockingEvent = false;
+
+		for (int EventIndex = 0; EventIndex < NextEvents.Num(); EventIndex++)
+		{
+			FFlareWorldEvent& NextEvent = NextEvents[EventIndex];
+
+			if (NextEvent.Visibility != EFlareEventVisibility::Blocking)
+			{
+				continue;
+			}
+
+			if (NextEvent.Date < WorldData.Date)
+			{
+				FLOGV("Fast forward fail: next event is in the past. Current date is %lld but next event date %lld", WorldData.Date, NextEvent.Date);
+				EventReached = true;
+			}
+			else if (NextEvent.Date <= TargetDate)
+			{
+				TargetDate = FMath::Max(NextEvent.Date, WorldData.Date + 1);
+				BlockingEvent = true;
+			}
+			break;
+		}
+
+		if (EventReached)
+		{
+			break;
+		}
+
+		// Travels in progress, by identity : a departure the same day must not hide an arrival
+		TArray<UFlareTravel*> PlayerTravels;
+		for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+		{
+			if (Travels[TravelIndex]->GetFleet()->GetFleetCompany() == PlayerCompany)
+			{
+				PlayerTravels.Add(Travels[TravelIndex]);
+			}
+		}
+
+		// Days up to the next event go in one span, used if no span is running
+		int64 SpanDays = 1;
+		if (BulkFastForward)
+		{
+			SpanDays = FMath::Min(TargetDate - WorldData.Date, (int64) FAST_FORWARD_MAX_SPAN);
+		}
+
+		Simulate(SpanDays);
+
+		// Battles, including the sectors discovered during the jump
+		for (int SectorIndex = 0; SectorIndex < PlayerCompany->GetKnownSectors().Num(); SectorIndex++)
+		{
+			UFlareSimulatedSector* Sector = PlayerCompany->GetKnownSectors()[SectorIndex];
+			EFlareSectorBattleState::Type* BattleState = BattleStates.Find(Sector);
+			EFlareSectorBattleState::Type NewBattleState = Sector->GetSectorBattleState(PlayerCompany);
+
+			if (BattleState ? (*BattleState != NewBattleState) : (NewBattleState != EFlareSectorBattleState::NoBattle))
+			{
+				EventReached = true;
+			}
+		}
+
+		// Travel arrivals
+		for (int TravelIndex = 0; TravelIndex < PlayerTravels.Num(); TravelIndex++)
+		{
+			if (!Travels.Contains(PlayerTravels[TravelIndex]))
+			{
+				EventReached = true;
+			}
+		}
+
+		// Quest triggers
+		GetQuestProgress(Game->GetQuestManager(), NewQuestProgress);
+		if (NewQuestProgress != QuestProgress)
+		{
+			EventReached = true;
+		}
+
+		// Travel arrivals that were planned
+		if (BlockingEvent && WorldData.Date >= TargetDate)
+		{
+			EventReached = true;
+		}
+	}
+
+	// A long jump skipped some slices of the rolling audit : check everything once
+	IntegrityAuditDeferred = false;
+	if (WorldData.Date - FastForwardStart > 1)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Integrity);
+		CheckIntegrity();
+	}
+	else if (WorldData.Date > FastForwardStart)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FlareWorld_Integrity);
+		AuditIntegrity();
+	}
+
+	return EventReached;
+}
+
+void UFlareWorld::ForceDate(int64 Date)
+{
+	while(WorldData.Date < Date)
+	{
+		Simulate(BulkFastForward ? FMath::Min(Date - WorldData.Date, (int64) FAST_FORWARD_MAX_SPAN) : 1);
+	}
+}
+
+inline static bool EventDateComparator (const FFlareWorldEvent& ip1, const FFlareWorldEvent& ip2)
+ {
+	 return (ip1.Date < ip2.Date);
+ }
+
+TArray<FFlareWorldEvent> UFlareWorld::GenerateEvents(UFlareCompany* PointOfView)
+{
+	TArray<FFlareWorldEvent> NextEvents;
+
+	// Generate travel events
+	for (int TravelIndex = 0; TravelIndex < Travels.Num(); TravelIndex++)
+	{
+		if (PointOfView && Travels[TravelIndex]->GetFleet()->GetFleetCompany() != PointOfView)
+		{
+			continue;
+		}
+
+		FFlareWorldEvent TravelEvent;
+
+		TravelEvent.Date = WorldData.Date + Travels[TravelIndex]->GetRemainingTravelDuration();
+		TravelEvent.Visibility = EFlareEventVisibility::Blocking;
+		NextEvents.Add(TravelEvent);
+	}
+
+	// Generate factory events
+	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	{
+		if (PointOfView && Factories[FactoryIndex]->GetParent()->GetCompany() != PointOfView)
+		{
+			continue;
+		}
+
+		FFlareWorldEvent *FactoryEvent = Factories[FactoryIndex]->GenerateEvent();
+		if (FactoryEvent)
+		{
+			NextEvents.Add(*FactoryEvent);
+		}
+	}
+
+	NextEvents.Sort(&EventDateComparator);
+
+	return NextEvents;
+}
+
+void UFlareWorld::ClearFactories(UFlareSimulatedSpacecraft *ParentSpacecraft)
+{
 	for (int FactoryIndex = Factories.Num() -1 ; FactoryIndex >= 0; FactoryIndex--)
 	{
 		UFlareFactory* Factory = Factories[FactoryIndex];
@@ -759,15 +1849,7 @@ void UFlareWorld::DeleteTravel(UFlareTravel* Travel)
 
 UFlareCompany* UFlareWorld::FindCompany(FName Identifier) const
 {
-	for (int i = 0; i < Companies.Num(); i++)
-	{
-		UFlareCompany* Company = Companies[i];
-		if (Company->GetIdentifier() == Identifier)
-		{
-			return Company;
-		}
-	}
-	return NULL;
+	return CompaniesByIdentifier.FindRef(Identifier);
 }
 
 UFlareCompany* UFlareWorld::FindCompanyByShortName(FName CompanyShortName) const
@@ -786,15 +1868,7 @@ UFlareCompany* UFlareWorld::FindCompanyByShortName(FName CompanyShortName) const
 
 UFlareSimulatedSector* UFlareWorld::FindSector(FName Identifier) const
 {
-	for (int i = 0; i < Sectors.Num(); i++)
-	{
-		UFlareSimulatedSector* Sector = Sectors[i];
-		if (Sector->GetIdentifier() == Identifier)
-		{
-			return Sector;
-		}
-	}
-	return NULL;
+	return SectorsByIdentifier.FindRef(Identifier);
 }
 
 UFlareSimulatedSector* UFlareWorld::FindSectorBySpacecraft(FName SpacecraftIdentifier) const
@@ -813,6 +1887,7 @@ UFlareSimulatedSector* UFlareWorld::FindSectorBySpacecraft(FName SpacecraftIdent
 	return NULL;
 }
 
+// Fleets, trade routes and spacecrafts are indexed by their company
 UFlareFleet* UFlareWorld::FindFleet(FName Identifier) const
 {
 	for (int i = 0; i < Companies.Num(); i++)
@@ -841,7 +1916,7 @@ UFlareTradeRoute* UFlareWorld::FindTradeRoute(FName Identifier) const
 	return NULL;
 }
 
-UFlareSimulatedSpacecraft* UFlareWorld::FindSpacecraft(FName ShipImmatriculation)
+UFlareSimulatedSpacecraft* UFlareWorld::FindSpacecraft(FName ShipImmatriculation) const
 {
 	for (int i = 0; i < Companies.Num(); i++)
 	{
@@ -856,49 +1931,6 @@ UFlareSimulatedSpacecraft* UFlareWorld::FindSpacecraft(FName ShipImmatriculation
 }
 
 
-int64 UFlareWorld::GetWorldMoney()
-{
-	// World money is the sum of company money + factory money + people money
-
-	int64 CompanyMoney = 0;
-	int64 FactoryMoney = 0;
-	int64 PeopleMoney = 0;
-
-	for (int i = 0; i < Companies.Num(); i++)
-	{
-		UFlareCompany* Company = Companies[i];
-
-		CompanyMoney += Company->GetMoney();
-
-		TArray<UFlareSimulatedSpacecraft*>& Spacecrafts = Company->GetCompanySpacecrafts();
-		for (int ShipIndex = 0; ShipIndex < Spacecrafts.Num() ; ShipIndex++)
-		{
-			UFlareSimulatedSpacecraft* Spacecraft = Spacecrafts[ShipIndex];
-
-			for (int32 FactoryIndex = 0; FactoryIndex < Spacecraft->GetFactories().Num(); FactoryIndex++)
-			{
-				UFlareFactory* Factory = Spacecraft->GetFactories()[FactoryIndex];
-				FactoryMoney += Factory->GetReservedMoney();
-			}
-		}
-	}
-
-	for (int SectorIndex = 0; SectorIndex < Sectors.Num(); SectorIndex++)
-	{
-		PeopleMoney += Sectors[SectorIndex]->GetPeople()->GetMoney();
-		PeopleMoney -= Sectors[SectorIndex]->GetPeople()->GetDept();
-	}
-
-	int64 WorldMoney = CompanyMoney + FactoryMoney + PeopleMoney;
-
-	//FLOGV("World money: %lld", WorldMoney);
-	//FLOGV("  - company: %lld", CompanyMoney);
-	//FLOGV("  - factory: %lld", FactoryMoney);
-	//FLOGV("  - people : %lld", PeopleMoney);
-
-	return WorldMoney;
-}
-
 uint32 UFlareWorld::GetWorldPopulation()
 {
 	uint32 WorldPopulation = 0;
@@ -4,6 +4,9 @@
 #include "Object.h"
 #include "FlareGameTypes.h"
 #include "FlareTravel.h"
+#include "FlareCompanyRelations.h"
+#include "../Economy/FlareMoneyLedger.h"
+#include "AI/FlareResourceVariationCache.h"
 #include "Planetarium/FlareSimulatedPlanetarium.h"
 #include "FlareWorld.generated.h"
 
@@ -63,6 +66,51 @@ struct FFlareWorldEvent
 	TEnumAsByte<EFlareEventVisibility::Type>  Visibility;
 };
 
+/** Number of simulated days kept in the simulation history */
+#define SIMULATION_HISTORY_SIZE 100
+
+/** Longest span of a fast forward : companies play once and factories advance at once over it */
+#define FAST_FORWARD_MAX_SPAN 5
+
+/** Wall time of each phase of a simulated day, in seconds, and hot call counts when FLARE_CALL_COUNTERS is set */
+struct FFlareSimulationTimings
+{
+	FFlareSimulationTimings()
+		: Date(0)
+		, AI(0)
+		, Factories(0)
+		, People(0)
+		, TradeRoutes(0)
+		, Travels(0)
+		, PriceVariation(0)
+		, MoneyMigration(0)
+		, Total(0)
+		, ComputeTravelDurationCalls(0)
+		, GetResourceQuantityCalls(0)
+		, FindTradeStationCalls(0)
+	{}
+
+	int64 Date;
+	double AI;
+	double Factories;
+	double People;
+	double TradeRoutes;
+	double Travels;
+	double PriceVariation;
+	double MoneyMigration;
+	double Total;
+	int32 ComputeTravelDurationCalls;
+	int32 GetResourceQuantityCalls;
+	int32 FindTradeStationCalls;
+};
+
+/** Balance of an account at a money check, and the net of its ledger transfers */
+struct FFlareAuditedBalance
+{
+	int64 Money;
+	int64 Ledger;
+};
+
 UCLASS()
 class HELIUMRAIN_API UFlareWorld: public UObject
 {
@@ -92,17 +140,127 @@ public:
 		Gameplay
 	----------------------------------------------------*/
 
-	bool CheckIntegrity();
-
 	void CompanyMutualAssistance();
 
-	/** Simulate world for a day */
-	void Simulate();
+	/** Simulate world for a day. If the last span is over, start a span of SpanDays days : companies play once and factories advance over the whole span */
+	void Simulate(int64 SpanDays = 1);
+
+	/** Advance factories over FactoryDays days, none inside a span, then simulate people for a day, sector by sector in parallel if enabled */
+	void SimulateFactoriesAndPeople(int64 FactoryDays = 1);
+
+	/** Enable or disable the parallel sector simulation */
+	void SetParallelSimulation(bool Parallel)
+	{
+		ParallelSimulation = Parallel;
+	}
 
+	/** Move money between sector people, with the pooled or the pairwise model */
 	void SimulatePeopleMoneyMigration();
 
-	/** Simulate world from now to the next event */
-	void FastForward();
+	/** Legacy money migration, comparing every pair of sectors */
+	void SimulatePairwiseMoneyMigration();
+
+	/** Money the pairwise migration moves from sector A to sector B, negative from B to A */
+	static int64 ComputePairwiseMoneyMigration(int64 MoneyA, int64 PopulationA, int64 MoneyB, int64 PopulationB);
+
+	/** Leaks and shares of the pooled money migration for sector balances, by sector. The shares sum to the leaks */
+	static void ComputePooledMoneyMigration(const TArray<int64>& Money, const TArray<int64>& Population, TArray<int64>& OutLeaks, TArray<int64>& OutShares);
+
+	/** Use the pooled money migration, or the legacy pairwise one */
+	void SetPooledMoneyMigration(bool Pooled)
+	{
+		PooledMoneyMigration = Pooled;
+	}
+
+	/** Vary the prices of all sectors, in one world table or sector by sector */
+	void SimulatePriceVariation();
+
+	/** Fill the world price table with the current, wanted and new prices, without changing the sectors */
+	void ComputePriceVariation();
+
+	/** Compute the varied and new clamped prices of all sectors and resources in one loop */
+	static void ComputeVariedPrices(const TArray<float>& OldPrices, const TArray<float>& WantedVariations,
+		const TArray<float>& MinPrices, const TArray<float>& MaxPrices, const TArray<float>& PriceRanges,
+		TArray<float>& OutVariedPrices, TArray<float>& OutVariations, TArray<float>& OutNewPrices);
+
+	/** Use the world price table, or the legacy sector by sector variation */
+	void SetBatchedPriceVariation(bool Batched)
+	{
+		BatchedPriceVariation = Batched;
+	}
+
+	bool IsBatchedPriceVariation() const
+	{
+		return BatchedPriceVariation;
+	}
+
+	/** Share the daily sector resource variations between all AI companies, or let each company scan the world */
+	void SetSharedResourceVariation(bool Shared)
+	{
+		SharedResourceVariation = Shared;
+	}
+
+	bool IsSharedResourceVariation() const
+	{
+		return SharedResourceVariation;
+	}
+
+	/** Travel duration in days between two sectors, from the world travel matrix */
+	int64 GetTravelDuration(UFlareSimulatedSector* OriginSector, UFlareSimulatedSector* DestinationSector);
+
+	/** Recompute the travel matrix at the next use, after a sector orbit or the planetarium changed */
+	void InvalidateTravelDurations()
+	{
+		TravelDurationsDirty = true;
+	}
+
+	/** Skip the AI deals whose best gain can't beat the best deal found, or evaluate all of them */
+	void SetPrunedDealSearch(bool Pruned)
+	{
+		PrunedDealSearch = Pruned;
+	}
+
+	bool IsPrunedDealSearch() const
+	{
+		return PrunedDealSearch;
+	}
+
+	/** Assign the idle AI cargos by auction, or greedily one ship at a time */
+	void SetAuctionCargoAssignment(bool Auction)
+	{
+		AuctionCargoAssignment = Auction;
+	}
+
+	bool IsAuctionCargoAssignment() const
+	{
+		return AuctionCargoAssignment;
+	}
+
+	/** Plan the AI of all companies in parallel, before committing them one by one */
+	void PlanAI();
+
+	/** Plan all companies in parallel on the world of the start of the AI phase, or plan each one at its turn */
+	void SetParallelAIPlanning(bool Parallel)
+	{
+		ParallelAIPlanning = Parallel;
+	}
+
+	/** Sector resource variations of the day, updated if needed */
+	const FFlareResourceVariationCache& GetResourceVariationCache();
+
+	/** Simulate world from now to the next blocking event, for MaxDays at most. Return true if an event was reached : travel arrival, battle or quest progress */
+	bool FastForward(int64 MaxDays = 1);
+
+	/** Fast forward in spans of days up to the next blocking event, or simulate every day fully */
+	void SetBulkFastForward(bool Bulk)
+	{
+		BulkFastForward = Bulk;
+	}
+
+	bool IsBulkFastForward() const
+	{
+		return BulkFastForward;
+	}
 
 	UFlareTravel* StartTravel(UFlareFleet* TravelingFleet, UFlareSimulatedSector* DestinationSector);
 
@@ -120,8 +278,58 @@ public:
 	/** Add a factory to world */
 	void AddFactory(UFlareFactory* Factory);
 
+
+	/*----------------------------------------------------
+		Integrity
+	----------------------------------------------------*/
+
+	/** Check the whole world */
+	bool CheckIntegrity();
+
+	/** Check the dirty companies and sectors, and the part of the world due in the rolling audit */
+	bool AuditIntegrity();
+
+	/** Check the station list and the company stocks of a sector */
+	bool CheckSectorIntegrity(UFlareSimulatedSector* Sector);
+
+	/** Check the spacecrafts and fleets of a company */
+	bool CheckCompanyIntegrity(UFlareCompany* Company);
+
+	/** Check the world money against the ledger, and report the balances that moved otherwise than their ledger account since the last check */
+	bool CheckMoneyIntegrity();
+
+	/** Check this company at the next audit */
+	void MarkCompanyDirty(UFlareCompany* Company)
+	{
+		DirtyCompanies.AddUnique(Company);
+	}
+
+	/** Check this sector at the next audit */
+	void MarkSectorDirty(UFlareSimulatedSector* Sector)
+	{
+		DirtySectors.AddUnique(Sector);
+	}
+
+	/** Audit the whole world every Days days, 1 for a full audit each day, 0 to only check dirty entities */
+	void SetIntegrityAuditPeriod(int32 Days)
+	{
+		IntegrityAuditPeriod = FMath::Max(Days, 0);
+	}
+
+	/** Check the world and company lookup indices */
+	bool CheckLookupIndices();
+
+	/** Check every lookup index at each audit */
+	void SetLookupValidation(bool Validate)
+	{
+		LookupValidation = Validate;
+	}
+
 protected:
 
+	/** Compute the travel durations between all sectors */
+	void UpdateTravelDurations();
+
 	/*----------------------------------------------------
 		Protected data
 	----------------------------------------------------*/
@@ -137,6 +345,10 @@ protected:
 	UPROPERTY()
 	TArray<UFlareCompany*>                Companies;
 
+	/** Lookup indices, kept in sync with the lists above */
+	TMap<FName, UFlareSimulatedSector*>   SectorsByIdentifier;
+	TMap<FName, UFlareCompany*>           CompaniesByIdentifier;
+
 	/** Factories */
 	UPROPERTY()
 	TArray<UFlareFactory*>                Factories;
@@ -151,9 +363,78 @@ protected:
 
 	bool WorldMoneyReferenceInit;
 
-public:
-	int64 WorldMoneyReference;
+	/** Factories and people are simulated by parallel sector tasks */
+	bool ParallelSimulation;
+
+	/** Sector money migrates through a world pool instead of between each pair of sectors */
+	bool PooledMoneyMigration;
+
+	/** Sector prices vary in a world table instead of sector by sector */
+	bool BatchedPriceVariation;
+
+	/** AI companies read the sector resource variations from a daily cache */
+	bool SharedResourceVariation;
 
+	/** AI companies skip the deals bounded below their best deal */
+	bool PrunedDealSearch;
+
+	/** AI companies plan in parallel before committing their actions */
+	bool ParallelAIPlanning;
+
+	/** AI companies assign all their idle cargos by auction */
+	bool AuctionCargoAssignment;
+
+	/** Fast forward and forced dates advance in spans of days */
+	bool BulkFastForward;
+
+	/** Date the current span ends, when companies play and factories advance again */
+	int64                                 SpanEndDate;
+
+	/** Sector resource variations shared by the AI companies */
+	FFlareResourceVariationCache          ResourceVariationCache;
+
+	/** Travel durations, by origin then destination sector slot */
+	TArray<int64>                         TravelDurations;
+	bool                                  TravelDurationsDirty;
+
+	/** World price table, by sector then resource */
+	TArray<float>                         PriceTable;
+	TArray<float>                         WantedPriceVariations;
+	TArray<float>                         VariedPrices;
+	TArray<float>                         PriceVariations;
+	TArray<float>                         NewPriceTable;
+	TArray<float>                         MinPriceTable;
+	TArray<float>                         MaxPriceTable;
+	TArray<float>                         PriceRangeTable;
+
+	/** Phase timings of the last simulated day */
+	FFlareSimulationTimings LastSimulationTimings;
+
+	/** Phase timings of the last simulated days, oldest first */
+	TArray<FFlareSimulationTimings> SimulationHistory;
+
+	/** Entities modified since the last audit */
+	TArray<UFlareCompany*>                DirtyCompanies;
+	TArray<UFlareSimulatedSector*>        DirtySectors;
+
+	/** Days for the rolling audit to cover the whole world */
+	int32                                 IntegrityAuditPeriod;
+
+	/** The daily audit waits for the end of the fast forward */
+	bool                                  IntegrityAuditDeferred;
+
+	/** All lookup indices are checked at each audit */
+	bool                                  LookupValidation;
+
+	/** Balances at the last money check, to locate drift */
+	TMap<UFlareCompany*, FFlareAuditedBalance>         AuditedCompanyMoney;
+	TMap<UFlareSimulatedSector*, FFlareAuditedBalance> AuditedPeopleMoney;
+
+	/** Money transfers and running totals */
+	FFlareMoneyLedger                     MoneyLedger;
+
+	/** Reputation and hostility between companies */
+	FFlareCompanyRelations                CompanyRelations;
 
 public:
 
@@ -186,6 +467,26 @@ public:
 		return WorldData.Date;
 	}
 
+	inline const FFlareSimulationTimings& GetLastSimulationTimings() const
+	{
+		return LastSimulationTimings;
+	}
+
+	inline const TArray<FFlareSimulationTimings>& GetSimulationHistory() const
+	{
+		return SimulationHistory;
+	}
+
+	inline FFlareMoneyLedger& GetMoneyLedger()
+	{
+		return MoneyLedger;
+	}
+
+	inline FFlareCompanyRelations& GetCompanyRelations()
+	{
+		return CompanyRelations;
+	}
+
 	UFlareCompany* FindCompany(FName Identifier) const;
 
 	UFlareCompany* FindCompanyByShortName(FName CompanyShortName) const;
@@ -198,14 +499,18 @@ public:
 
 	UFlareTradeRoute* FindTradeRoute(FName Identifier) const;
 
-	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation);
+	UFlareSimulatedSpacecraft* FindSpacecraft(FName ShipImmatriculation) const;
 
-	inline TArray<UFlareCompany*> GetCompanies() const
+	inline const TArray<UFlareCompany*>& GetCompanies() const
 	{
 		return Companies;
 	}
 
-	int64 GetWorldMoney();
+	/** Money in the world, from the ledger */
+	int64 GetWorldMoney() const
+	{
+		return MoneyLedger.GetWorldMoney();
+	}
 
 	uint32 GetWorldPopulation();
 
@@ -2,6 +2,7 @@
 #include "../Flare.h"
 #include "FlarePlayerController.h"
 #include "../Game/FlareGameTools.h"
+#include "../Game/FlareSimulationBenchmark.h"
 #include "../Spacecrafts/FlareSpacecraft.h"
 #include "../Game/Planetarium/FlareSimulatedPlanetarium.h"
 #include "../Game/FlareGameUserSettings.h"
@@ -81,6 +82,9 @@ void AFlarePlayerController::BeginPlay()
 		SoundManager->SetMusicVolume(MyGameSettings->MusicVolume);
 		SoundManager->SetMasterVolume(MyGameSettings->MasterVolume);
 	}
+
+	// Headless benchmark
+	SimulationBenchmark::RunFromCommandLine(this);
 }
 
 void AFlarePlayerController::PlayerTick(float DeltaSeconds)
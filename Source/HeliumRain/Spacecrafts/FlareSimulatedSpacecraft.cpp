@@ -72,9 +72,37 @@ void UFlareSimulatedSpacecraft::Load(const FFlareSpacecraftSave& Data)
 		Game->GetGameWorld()->AddFactory(Factory);
 	}
 
+	// Resource uses only depend on the description
+	ResourceUseTypes.Empty();
+	if (IsStation())
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < Game->GetResourceCatalog()->Resources.Num(); ResourceIndex++)
+		{
+			ResourceUseTypes.Add(ComputeResourceUseType(&Game->GetResourceCatalog()->Resources[ResourceIndex]->Data));
+		}
+	}
+
+	// New factories replace the previous ones in the sector index
+	if (CurrentSector)
+	{
+		CurrentSector->InvalidateResourceUses();
+	}
+
+	// A reloaded cargo bay replaces the previous one in the sector stocks
+	UFlareSimulatedSector* StockSector = (CargoBay ? CargoBay->GetStockSector() : NULL);
+	if (StockSector)
+	{
+		StockSector->RemoveCargoStock(this);
+	}
+
 	CargoBay = NewObject<UFlareCargoBay>(this, UFlareCargoBay::StaticClass());
 	CargoBay->Load(this, SpacecraftData.Cargo);
 
+	if (StockSector)
+	{
+		StockSector->AddCargoStock(this);
+	}
+
 
 	// Lock resources
 	LockResources();
@@ -238,6 +266,11 @@ EFlareResourcePriceContext::Type UFlareSimulatedSpacecraft::GetResourceUseType(F
 		return EFlareResourcePriceContext::Default;
 	}
 
+	return ResourceUseTypes[Resource->Index];
+}
+
+EFlareResourcePriceContext::Type UFlareSimulatedSpacecraft::ComputeResourceUseType(FFlareResourceDescription* Resource)
+{
 	// Parse factories
 	for (int FactoryIndex = 0; FactoryIndex < SpacecraftDescription->Factories.Num(); FactoryIndex++)
 	{
@@ -349,6 +382,23 @@ void UFlareSimulatedSpacecraft::SetDynamicComponentState(FName Identifier, float
 	SpacecraftData.DynamicComponentStateProgress = Progress;
 }
 
+void UFlareSimulatedSpacecraft::Upgrade()
+{
+	SpacecraftData.Level++;
+
+	// Cycle quantities scale with the level
+	for (int FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+	{
+		Factories[FactoryIndex]->WakeUp();
+	}
+
+	// Upgraded factories change the resource uses of the sector
+	if (CurrentSector)
+	{
+		CurrentSector->InvalidateResourceUses();
+	}
+}
+
 void UFlareSimulatedSpacecraft::ForceUndock()
 {
 	SpacecraftData.DockedTo = NAME_None;
@@ -77,10 +77,7 @@ public:
 
 	void SetDynamicComponentState(FName Identifier, float Progress = 0.f);
 
-	void Upgrade()
-	{
-		SpacecraftData.Level++;
-	}
+	void Upgrade();
 
 	void SetActiveSpacecraft(AFlareSpacecraft* Spacecraft)
 	{
@@ -107,6 +104,9 @@ public:
 
 protected:
 
+	/** Find the use of a resource in the station description */
+	EFlareResourcePriceContext::Type ComputeResourceUseType(FFlareResourceDescription* Resource);
+
     /*----------------------------------------------------
         Protected data
     ----------------------------------------------------*/
@@ -122,6 +122,9 @@ protected:
 	UFlareFleet*                  CurrentFleet;
 	UFlareSimulatedSector*        CurrentSector;
 
+	/** Station use of each resource, by resource index */
+	TArray<TEnumAsByte<EFlareResourcePriceContext::Type>> ResourceUseTypes;
+
 	// Systems
 	UPROPERTY()
 	UFlareSimulatedSpacecraftDamageSystem*                  DamageSystem;
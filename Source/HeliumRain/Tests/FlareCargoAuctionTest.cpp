@@ -0,0 +1,269 @@
+
+#include "../Flare.h"
+#include "../Game/AI/FlareCompanyAI.h"
+#include "../Game/FlareCompany.h"
+#include "../Player/FlarePlayerController.h"
+#include "FlareTestWorld.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Cargo auction
+----------------------------------------------------*/
+
+/** Add a candidate deal of some balance per day to a ship */
+static void AddCandidate(TArray<CargoDealCandidate>& Candidates, int32 DealSlot, float MoneyBalanceParDay)
+{
+	CargoDealCandidate Candidate;
+	Candidate.DealSlot = DealSlot;
+	Candidate.Deal.MoneyBalanceParDay = MoneyBalanceParDay;
+	Candidate.Deal.SectorA = NULL;
+	Candidate.Deal.SectorB = NULL;
+	Candidate.Deal.Resource = NULL;
+	Candidate.Deal.BuyQuantity = 0;
+	Candidates.Add(Candidate);
+}
+
+/** Total balance per day of an assignment */
+static float GetAssignedBalance(const TArray<TArray<CargoDealCandidate>>& ShipCandidates, const TArray<int32>& Assignments)
+{
+	float Balance = 0;
+	for (int32 ShipIndex = 0; ShipIndex < ShipCandidates.Num(); ShipIndex++)
+	{
+		if (Assignments[ShipIndex] >= 0)
+		{
+			Balance += ShipCandidates[ShipIndex][Assignments[ShipIndex]].Deal.MoneyBalanceParDay;
+		}
+	}
+	return Balance;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareCargoAuctionTieTest, "HeliumRain.AI.CargoAuction.Ties",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareCargoAuctionTieTest::RunTest(const FString& Parameters)
+{
+	TArray<int32> Assignments;
+
+	// Two ships on the same deal : the first ship wins it
+	TArray<TArray<CargoDealCandidate>> SameDeal;
+	SameDeal.SetNum(2);
+	AddCandidate(SameDeal[0], 0, 100);
+	AddCandidate(SameDeal[1], 0, 100);
+
+	TArray<int32> SingleCapacity;
+	SingleCapacity.Add(1);
+	UFlareCompanyAI::SolveCargoAuction(SameDeal, SingleCapacity, Assignments);
+	TestTrue(TEXT("First ship wins an equal deal"), Assignments[0] == 0 && Assignments[1] == -1);
+
+	// Same ships, the deal takes both
+	TArray<int32> DoubleCapacity;
+	DoubleCapacity.Add(2);
+	UFlareCompanyAI::SolveCargoAuction(SameDeal, DoubleCapacity, Assignments);
+	TestTrue(TEXT("A deal takes ships up to its capacity"), Assignments[0] == 0 && Assignments[1] == 0);
+
+	// One ship, two equal deals : the first candidate wins
+	TArray<TArray<CargoDealCandidate>> SameBalance;
+	SameBalance.SetNum(1);
+	AddCandidate(SameBalance[0], 1, 50);
+	AddCandidate(SameBalance[0], 0, 50);
+
+	TArray<int32> Capacities;
+	Capacities.Add(1);
+	Capacities.Add(1);
+	UFlareCompanyAI::SolveCargoAuction(SameBalance, Capacities, Assignments);
+	TestTrue(TEXT("First candidate wins equal balances"), Assignments[0] == 0);
+
+	// Nothing to earn : ships stay idle
+	TArray<TArray<CargoDealCandidate>> NoGain;
+	NoGain.SetNum(2);
+	AddCandidate(NoGain[0], 0, 0);
+	AddCandidate(NoGain[1], 1, -10);
+	UFlareCompanyAI::SolveCargoAuction(NoGain, Capacities, Assignments);
+	TestTrue(TEXT("No ship takes a deal without gain"), Assignments[0] == -1 && Assignments[1] == -1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareCargoAuctionBalanceTest, "HeliumRain.AI.CargoAuction.Balance",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareCargoAuctionBalanceTest::RunTest(const FString& Parameters)
+{
+	// The first ship takes the deal the second one needs most when served first
+	TArray<TArray<CargoDealCandidate>> ShipCandidates;
+	ShipCandidates.SetNum(2);
+	AddCandidate(ShipCandidates[0], 0, 10);
+	AddCandidate(ShipCandidates[0], 1, 9);
+	AddCandidate(ShipCandidates[1], 0, 10);
+	AddCandidate(ShipCandidates[1], 1, 2);
+
+	TArray<int32> Capacities;
+	Capacities.Add(1);
+	Capacities.Add(1);
+
+	TArray<int32> GreedyAssignments;
+	UFlareCompanyAI::SolveCargoGreedy(ShipCandidates, Capacities, GreedyAssignments);
+	TestTrue(TEXT("Greedy serves the first ship first"), GreedyAssignments[0] == 0 && GreedyAssignments[1] == 1);
+
+	TArray<int32> AuctionAssignments;
+	UFlareCompanyAI::SolveCargoAuction(ShipCandidates, Capacities, AuctionAssignments);
+	TestTrue(TEXT("Auction finds the best assignment"), AuctionAssignments[0] == 1 && AuctionAssignments[1] == 0);
+	TestTrue(TEXT("Auction earns more than greedy"), GetAssignedBalance(ShipCandidates, AuctionAssignments) > GetAssignedBalance(ShipCandidates, GreedyAssignments));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareCargoAuctionDeterminismTest, "HeliumRain.AI.CargoAuction.Determinism",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareCargoAuctionDeterminismTest::RunTest(const FString& Parameters)
+{
+	// Many ships on few deals, with equal balances
+	FRandomStream Random(7);
+	const int32 ShipCount = 300;
+	const int32 DealCount = 40;
+
+	TArray<int32> Capacities;
+	for (int32 DealSlot = 0; DealSlot < DealCount; DealSlot++)
+	{
+		Capacities.Add(Random.RandRange(1, 3));
+	}
+
+	TArray<TArray<CargoDealCandidate>> ShipCandidates;
+	ShipCandidates.SetNum(ShipCount);
+	for (int32 ShipIndex = 0; ShipIndex < ShipCount; ShipIndex++)
+	{
+		int32 FirstSlot = Random.RandRange(0, DealCount - 1);
+		for (int32 CandidateIndex = 0; CandidateIndex < 8; CandidateIndex++)
+		{
+			AddCandidate(ShipCandidates[ShipIndex], (FirstSlot + CandidateIndex * 3) % DealCount, 100 * Random.RandRange(1, 5));
+		}
+	}
+
+	TArray<int32> FirstAssignments;
+	UFlareCompanyAI::SolveCargoAuction(ShipCandidates, Capacities, FirstAssignments);
+
+	TArray<int32> SecondAssignments;
+	UFlareCompanyAI::SolveCargoAuction(ShipCandidates, Capacities, SecondAssignments);
+	TestTrue(TEXT("Same candidates give the same assignment"), FirstAssignments == SecondAssignments);
+
+	TArray<int32> UsedCapacities;
+	UsedCapacities.SetNumZeroed(DealCount);
+	for (int32 ShipIndex = 0; ShipIndex < ShipCount; ShipIndex++)
+	{
+		if (FirstAssignments[ShipIndex] >= 0)
+		{
+			UsedCapacities[ShipCandidates[ShipIndex][FirstAssignments[ShipIndex]].DealSlot]++;
+		}
+	}
+
+	for (int32 DealSlot = 0; DealSlot < DealCount; DealSlot++)
+	{
+		if (UsedCapacities[DealSlot] != Capacities[DealSlot])
+		{
+			AddError(FString::Printf(TEXT("Deal %d takes %d ships for a capacity of %d"), DealSlot, UsedCapacities[DealSlot], Capacities[DealSlot]));
+			return false;
+		}
+	}
+
+	TArray<int32> GreedyAssignments;
+	UFlareCompanyAI::SolveCargoGreedy(ShipCandidates, Capacities, GreedyAssignments);
+
+	// The auction is optimal within 0.1% of the best balance per ship
+	TestTrue(TEXT("Auction earns at least as much as greedy"),
+		GetAssignedBalance(ShipCandidates, FirstAssignments) >= GetAssignedBalance(ShipCandidates, GreedyAssignments) - ShipCount * 500 * 0.001f);
+
+	return true;
+}
+
+/** Total balance per day of the deals of some ships */
+static float GetDealsBalance(const TArray<SectorDeal>& Deals)
+{
+	float Balance = 0;
+	for (int32 ShipIndex = 0; ShipIndex < Deals.Num(); ShipIndex++)
+	{
+		Balance += Deals[ShipIndex].MoneyBalanceParDay;
+	}
+	return Balance;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareCargoAuctionBenchmarkTest, "HeliumRain.AI.CargoAuction.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareCargoAuctionBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// The deals come from the stations and fleets of the companies : run it with a save loaded
+	UFlareWorld* World = GetLoadedTestWorld();
+	if (!World)
+	{
+		AddWarning(TEXT("No game loaded, the cargo assignments were not timed"));
+		return true;
+	}
+
+	UFlareCompany* PlayerCompany = World->GetGame()->GetPC()->GetCompany();
+	int32 ShipCount = 0;
+	double GreedyTime = 0;
+	double AuctionTime = 0;
+	float GreedyBalance = 0;
+	float AuctionBalance = 0;
+
+	for (int32 CompanyIndex = 0; CompanyIndex < World->GetCompanies().Num(); CompanyIndex++)
+	{
+		UFlareCompany* Company = World->GetCompanies()[CompanyIndex];
+		if (Company == PlayerCompany)
+		{
+			continue;
+		}
+
+		// Both assignments start from the same plan of the day
+		UFlareCompanyAI* AI = Company->GetAI();
+		AI->Plan();
+
+		TArray<UFlareSimulatedSpacecraft*> Ships;
+		TArray<SectorDeal> GreedyDeals;
+		double StartTime = FPlatformTime::Seconds();
+		AI->PlanCargoAssignment(false, Ships, GreedyDeals);
+		GreedyTime += FPlatformTime::Seconds() - StartTime;
+
+		TArray<SectorDeal> AuctionDeals;
+		StartTime = FPlatformTime::Seconds();
+		AI->PlanCargoAssignment(true, Ships, AuctionDeals);
+		AuctionTime += FPlatformTime::Seconds() - StartTime;
+
+		TArray<SectorDeal> SecondAuctionDeals;
+		AI->PlanCargoAssignment(true, Ships, SecondAuctionDeals);
+
+		for (int32 ShipIndex = 0; ShipIndex < Ships.Num(); ShipIndex++)
+		{
+			const SectorDeal& Deal = AuctionDeals[ShipIndex];
+			const SectorDeal& SecondDeal = SecondAuctionDeals[ShipIndex];
+
+			if (Deal.Resource && (!Deal.SectorA || !Deal.SectorB || Deal.MoneyBalanceParDay <= 0))
+			{
+				AddError(FString::Printf(TEXT("%s got a deal without gain"), *Company->GetCompanyName().ToString()));
+				return false;
+			}
+
+			if (Deal.Resource != SecondDeal.Resource || Deal.SectorA != SecondDeal.SectorA || Deal.SectorB != SecondDeal.SectorB)
+			{
+				AddError(FString::Printf(TEXT("%s assigned its cargos differently on the same plan"), *Company->GetCompanyName().ToString()));
+				return false;
+			}
+		}
+
+		ShipCount += Ships.Num();
+		GreedyBalance += GetDealsBalance(GreedyDeals);
+		AuctionBalance += GetDealsBalance(AuctionDeals);
+	}
+
+	AddLogItem(FString::Printf(TEXT("%d idle cargos : greedy %f ms for %f per day, auction %f ms for %f per day"),
+		ShipCount, GreedyTime * 1000, GreedyBalance, AuctionTime * 1000, AuctionBalance));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,259 @@
+#include "../Flare.h"
+#include "../Economy/FlareFactory.h"
+#include "../Economy/FlareCargoBay.h"
+#include "../Economy/FlarePeople.h"
+#include "../Game/FlareCompany.h"
+#include "../Game/FlareSimulatedSector.h"
+#include "../Spacecrafts/FlareSimulatedSpacecraft.h"
+#include "FlareTestWorld.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Factory state
+----------------------------------------------------*/
+
+/** Everything a factory changes when it works */
+struct FFactoryState
+{
+	FFlareFactorySave FactoryData;
+	TArray<FFlareCargo> Slots;
+	int64 CompanyMoney;
+	FFlarePeopleSave PeopleData;
+	FFlareMoneyLedger Ledger;
+};
+
+static void SaveFactoryState(UFlareWorld* World, UFlareFactory* Factory, FFactoryState& OutState)
+{
+	UFlareSimulatedSpacecraft* Station = Factory->GetParent();
+
+	OutState.FactoryData = *Factory->Save();
+	OutState.Slots = Station->GetCargoBay()->GetSlots();
+	OutState.CompanyMoney = Station->GetCompany()->GetMoney();
+	OutState.PeopleData = *Station->GetCurrentSector()->GetPeople()->Save();
+	OutState.Ledger = World->GetMoneyLedger();
+}
+
+static void RestoreFactoryState(UFlareWorld* World, UFlareFactory* Factory, const FFactoryState& State)
+{
+	UFlareSimulatedSpacecraft* Station = Factory->GetParent();
+
+	Factory->WakeUp();
+	Factory->Load(Station, Factory->GetDescription(), State.FactoryData);
+	Station->GetCargoBay()->SetSlots(State.Slots);
+
+	int64 MoneyChange = State.CompanyMoney - Station->GetCompany()->GetMoney();
+	if (MoneyChange > 0)
+	{
+		Station->GetCompany()->GiveMoney(MoneyChange);
+	}
+	else
+	{
+		Station->GetCompany()->TakeMoney(-MoneyChange, true);
+	}
+
+	*Station->GetCurrentSector()->GetPeople()->Save() = State.PeopleData;
+	World->GetMoneyLedger() = State.Ledger;
+}
+
+/** Money moved by the transfers of the day, by source, destination and reason */
+static TMap<FString, int64> GetTransferTotals(const FFlareMoneyLedger& Ledger)
+{
+	TMap<FString, int64> Totals;
+
+	for (int32 TransferIndex = 0; TransferIndex < Ledger.GetDayTransfers().Num(); TransferIndex++)
+	{
+		const FFlareMoneyTransfer& Transfer = Ledger.GetDayTransfers()[TransferIndex];
+		FString Key = FString::Printf(TEXT("%s > %s : %s"),
+			Transfer.Source ? *Transfer.Source->GetName() : TEXT("outside"),
+			Transfer.Destination ? *Transfer.Destination->GetName() : TEXT("outside"),
+			FFlareMoneyLedger::GetReasonName(Transfer.Reason));
+		Totals.FindOrAdd(Key) += Transfer.Amount;
+	}
+
+	return Totals;
+}
+
+/** First difference between two factory states, or an empty string */
+static FString CompareFactoryStates(const FFactoryState& Stepped, const FFactoryState& Advanced)
+{
+	const FFlareFactorySave& SteppedData = Stepped.FactoryData;
+	const FFlareFactorySave& AdvancedData = Advanced.FactoryData;
+	if (SteppedData.Active != AdvancedData.Active || SteppedData.CostReserved != AdvancedData.CostReserved
+		|| SteppedData.ProductedDuration != AdvancedData.ProductedDuration || SteppedData.CycleCount != AdvancedData.CycleCount
+		|| SteppedData.ResourceReserved.Num() != AdvancedData.ResourceReserved.Num())
+	{
+		return FString::Printf(TEXT("production (duration %lld/%lld, cycles %u/%u, cost %u/%u)"),
+			SteppedData.ProductedDuration, AdvancedData.ProductedDuration, SteppedData.CycleCount, AdvancedData.CycleCount,
+			SteppedData.CostReserved, AdvancedData.CostReserved);
+	}
+
+	for (int32 ResourceIndex = 0; ResourceIndex < SteppedData.ResourceReserved.Num(); ResourceIndex++)
+	{
+		if (SteppedData.ResourceReserved[ResourceIndex].ResourceIdentifier != AdvancedData.ResourceReserved[ResourceIndex].ResourceIdentifier
+			|| SteppedData.ResourceReserved[ResourceIndex].Quantity != AdvancedData.ResourceReserved[ResourceIndex].Quantity)
+		{
+			return FString::Printf(TEXT("reserved resource %d"), ResourceIndex);
+		}
+	}
+
+	if (Stepped.Slots.Num() != Advanced.Slots.Num())
+	{
+		return TEXT("slot count");
+	}
+
+	for (int32 SlotIndex = 0; SlotIndex < Stepped.Slots.Num(); SlotIndex++)
+	{
+		const FFlareCargo& SteppedSlot = Stepped.Slots[SlotIndex];
+		const FFlareCargo& AdvancedSlot = Advanced.Slots[SlotIndex];
+		if (SteppedSlot.Resource != AdvancedSlot.Resource || SteppedSlot.Quantity != AdvancedSlot.Quantity || SteppedSlot.Lock != AdvancedSlot.Lock)
+		{
+			return FString::Printf(TEXT("slot %d (quantity %u/%u)"), SlotIndex, SteppedSlot.Quantity, AdvancedSlot.Quantity);
+		}
+	}
+
+	if (Stepped.CompanyMoney != Advanced.CompanyMoney)
+	{
+		return FString::Printf(TEXT("company money (%lld/%lld)"), Stepped.CompanyMoney, Advanced.CompanyMoney);
+	}
+
+	if (Stepped.PeopleData.Money != Advanced.PeopleData.Money || Stepped.PeopleData.Dept != Advanced.PeopleData.Dept)
+	{
+		return FString::Printf(TEXT("people money (%u/%u)"), Stepped.PeopleData.Money, Advanced.PeopleData.Money);
+	}
+
+	if (Stepped.Ledger.GetWorldMoney() != Advanced.Ledger.GetWorldMoney())
+	{
+		return TEXT("world money");
+	}
+
+	for (int32 Reason = 0; Reason < EFlareMoneyReason::Count; Reason++)
+	{
+		EFlareMoneyReason::Type MoneyReason = (EFlareMoneyReason::Type) Reason;
+		if (Stepped.Ledger.GetReasonTotal(MoneyReason) != Advanced.Ledger.GetReasonTotal(MoneyReason))
+		{
+			return FString::Printf(TEXT("ledger total for %s"), FFlareMoneyLedger::GetReasonName(MoneyReason));
+		}
+	}
+
+	// A span records one transfer for all its cycles : compare the sums
+	TMap<FString, int64> SteppedTransfers = GetTransferTotals(Stepped.Ledger);
+	TMap<FString, int64> AdvancedTransfers = GetTransferTotals(Advanced.Ledger);
+	if (SteppedTransfers.Num() != AdvancedTransfers.Num())
+	{
+		return TEXT("ledger transfers");
+	}
+
+	for (auto& Transfer : SteppedTransfers)
+	{
+		int64* AdvancedAmount = AdvancedTransfers.Find(Transfer.Key);
+		if (!AdvancedAmount || *AdvancedAmount != Transfer.Value)
+		{
+			return FString::Printf(TEXT("ledger transfers %s"), *Transfer.Key);
+		}
+	}
+
+	return FString();
+}
+
+
+/*----------------------------------------------------
+	Tests
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareFactoryAdvanceSpanTest, "HeliumRain.Economy.FactoryAdvance.Span",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareFactoryAdvanceSpanTest::RunTest(const FString& Parameters)
+{
+	int64 SpanDays = 0;
+
+	// 10 days cycles, 4 days done : cycles end on days 6, 16, 26
+	TestTrue(TEXT("No cycle ends before the first end"), UFlareFactory::ComputeSteadyCycles(5, 10, 4, 100, SpanDays) == 0 && SpanDays == 0);
+	TestTrue(TEXT("First cycle ends on its last day"), UFlareFactory::ComputeSteadyCycles(6, 10, 4, 100, SpanDays) == 1 && SpanDays == 6);
+	TestTrue(TEXT("Cycles end every production time"), UFlareFactory::ComputeSteadyCycles(30, 10, 4, 100, SpanDays) == 3 && SpanDays == 26);
+	TestTrue(TEXT("Cycles are limited"), UFlareFactory::ComputeSteadyCycles(30, 10, 4, 2, SpanDays) == 2 && SpanDays == 16);
+	TestTrue(TEXT("No cycle without margin"), UFlareFactory::ComputeSteadyCycles(30, 10, 4, 0, SpanDays) == 0 && SpanDays == 0);
+
+	// Instant and overdue cycles end every day
+	TestTrue(TEXT("Instant cycles end every day"), UFlareFactory::ComputeSteadyCycles(7, 0, 0, 100, SpanDays) == 7 && SpanDays == 7);
+	TestTrue(TEXT("Overdue cycle ends the first day"), UFlareFactory::ComputeSteadyCycles(1, 3, 5, 100, SpanDays) == 1 && SpanDays == 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareFactoryAdvanceEquivalenceTest, "HeliumRain.Economy.FactoryAdvance.Equivalence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareFactoryAdvanceEquivalenceTest::RunTest(const FString& Parameters)
+{
+	// Real factories need a game : run it with a save loaded
+	UFlareWorld* World = GetLoadedTestWorld();
+	if (!World)
+	{
+		AddWarning(TEXT("No game loaded, the factories were not tested"));
+		return true;
+	}
+
+	const int64 DayCounts[] = { 1, 6, 13, 50 };
+	int32 CaseCount = 0;
+
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		TArray<UFlareSimulatedSpacecraft*>& Stations = World->GetSectors()[SectorIndex]->GetSectorStations();
+		for (int32 StationIndex = 0; StationIndex < Stations.Num(); StationIndex++)
+		{
+			TArray<UFlareFactory*>& Factories = Stations[StationIndex]->GetFactories();
+			for (int32 FactoryIndex = 0; FactoryIndex < Factories.Num(); FactoryIndex++)
+			{
+				UFlareFactory* Factory = Factories[FactoryIndex];
+
+				// Ships and actions can't be restored
+				if (Factory->IsShipyard() || Factory->GetDescription()->OutputActions.Num() > 0)
+				{
+					continue;
+				}
+
+				FFactoryState Initial;
+				SaveFactoryState(World, Factory, Initial);
+
+				for (int64 Days : DayCounts)
+				{
+					RestoreFactoryState(World, Factory, Initial);
+					for (int64 Day = 0; Day < Days; Day++)
+					{
+						Factory->Simulate();
+					}
+					FFactoryState Stepped;
+					SaveFactoryState(World, Factory, Stepped);
+
+					RestoreFactoryState(World, Factory, Initial);
+					Factory->AdvanceDays(Days);
+					FFactoryState Advanced;
+					SaveFactoryState(World, Factory, Advanced);
+
+					FString Difference = CompareFactoryStates(Stepped, Advanced);
+					if (!Difference.IsEmpty())
+					{
+						RestoreFactoryState(World, Factory, Initial);
+						AddError(FString::Printf(TEXT("%s of %s : %lld days advance differs from single days in %s"),
+							*Factory->GetDescription()->Name.ToString(), *Stations[StationIndex]->GetImmatriculation().ToString(), Days, *Difference));
+						return false;
+					}
+					CaseCount++;
+				}
+
+				RestoreFactoryState(World, Factory, Initial);
+			}
+		}
+	}
+
+	TestTrue(TEXT("Factories were tested"), CaseCount > 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,236 @@
+
+#include "../Flare.h"
+#include "../Game/FlareWorld.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Money migration
+----------------------------------------------------*/
+
+/** Run one day of pooled migration on the balances, return the moved money */
+static int64 MigrateDay(TArray<int64>& Money, const TArray<int64>& Population, FAutomationTestBase* Test)
+{
+	TArray<int64> Leaks;
+	TArray<int64> Shares;
+	UFlareWorld::ComputePooledMoneyMigration(Money, Population, Leaks, Shares);
+
+	int64 TotalLeaks = 0;
+	int64 TotalShares = 0;
+	for (int SectorIndex = 0; SectorIndex < Money.Num(); SectorIndex++)
+	{
+		Test->TestTrue(TEXT("Leaks and shares are positive"), Leaks[SectorIndex] >= 0 && Shares[SectorIndex] >= 0);
+		Test->TestTrue(TEXT("Shares fit in people money"), Shares[SectorIndex] <= MAX_uint32);
+
+		Money[SectorIndex] += Shares[SectorIndex] - Leaks[SectorIndex];
+		TotalLeaks += Leaks[SectorIndex];
+		TotalShares += Shares[SectorIndex];
+	}
+
+	Test->TestTrue(TEXT("The pool is fully shared"), TotalShares == TotalLeaks);
+	return TotalLeaks;
+}
+
+/** Run one day of pairwise migration on the balances, in the sector pair order of the world */
+static void MigratePairwiseDay(TArray<int64>& Money, const TArray<int64>& Population)
+{
+	for (int SectorIndexA = 0; SectorIndexA < Money.Num(); SectorIndexA++)
+	{
+		for (int SectorIndexB = SectorIndexA + 1; SectorIndexB < Money.Num(); SectorIndexB++)
+		{
+			int64 Transfert = UFlareWorld::ComputePairwiseMoneyMigration(Money[SectorIndexA], Population[SectorIndexA], Money[SectorIndexB], Population[SectorIndexB]);
+			Money[SectorIndexA] -= Transfert;
+			Money[SectorIndexB] += Transfert;
+		}
+	}
+}
+
+/** Largest gap between the wealth of two populated sectors */
+static double GetWealthSpread(const TArray<int64>& Money, const TArray<int64>& Population)
+{
+	double MinWealth = MAX_dbl;
+	double MaxWealth = 0;
+
+	for (int SectorIndex = 0; SectorIndex < Money.Num(); SectorIndex++)
+	{
+		if (Population[SectorIndex] > 0)
+		{
+			double Wealth = (double) Money[SectorIndex] / (double) Population[SectorIndex];
+			MinWealth = FMath::Min(MinWealth, Wealth);
+			MaxWealth = FMath::Max(MaxWealth, Wealth);
+		}
+	}
+
+	return MaxWealth - MinWealth;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareMoneyMigrationEquilibriumTest, "HeliumRain.Economy.MoneyMigration.Equilibrium",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareMoneyMigrationEquilibriumTest::RunTest(const FString& Parameters)
+{
+	// Same wealth everywhere, empty sectors without money : nothing moves
+	TArray<int64> Money;
+	TArray<int64> Population;
+	Money.Add(100000);  Population.Add(1000);
+	Money.Add(300000);  Population.Add(3000);
+	Money.Add(0);       Population.Add(0);
+	Money.Add(50000);   Population.Add(500);
+
+	TArray<int64> Initial = Money;
+	TestTrue(TEXT("No migration at equilibrium"), MigrateDay(Money, Population, this) == 0);
+	TestTrue(TEXT("Balances are unchanged at equilibrium"), Money == Initial);
+
+	// No populated sector : nothing moves
+	TArray<int64> EmptyMoney;
+	TArray<int64> EmptyPopulation;
+	EmptyMoney.Add(1000);  EmptyPopulation.Add(0);
+	EmptyMoney.Add(5000);  EmptyPopulation.Add(0);
+	TestTrue(TEXT("No migration without people"), MigrateDay(EmptyMoney, EmptyPopulation, this) == 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareMoneyMigrationConvergenceTest, "HeliumRain.Economy.MoneyMigration.Convergence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareMoneyMigrationConvergenceTest::RunTest(const FString& Parameters)
+{
+	TArray<int64> Money;
+	TArray<int64> Population;
+	Money.Add(5000000);  Population.Add(1000);
+	Money.Add(200000);   Population.Add(2000);
+	Money.Add(800000);   Population.Add(0);
+	Money.Add(10000);    Population.Add(500);
+	Money.Add(3000000);  Population.Add(4000);
+
+	int64 TotalMoney = 0;
+	for (int SectorIndex = 0; SectorIndex < Money.Num(); SectorIndex++)
+	{
+		TotalMoney += Money[SectorIndex];
+	}
+
+	double InitialSpread = GetWealthSpread(Money, Population);
+	double Spread = InitialSpread;
+
+	for (int Day = 0; Day < 2000; Day++)
+	{
+		MigrateDay(Money, Population, this);
+
+		double NewSpread = GetWealthSpread(Money, Population);
+		if (NewSpread > Spread + 1e-6)
+		{
+			AddError(FString::Printf(TEXT("Wealth spread grew on day %d : %f to %f"), Day, Spread, NewSpread));
+			return false;
+		}
+		Spread = NewSpread;
+	}
+
+	int64 FinalMoney = 0;
+	for (int SectorIndex = 0; SectorIndex < Money.Num(); SectorIndex++)
+	{
+		TestTrue(TEXT("No sector goes negative"), Money[SectorIndex] >= 0);
+		FinalMoney += Money[SectorIndex];
+	}
+
+	TestTrue(TEXT("Migration conserves money"), FinalMoney == TotalMoney);
+	TestTrue(TEXT("Empty sector is drained"), Money[2] < 10);
+	TestTrue(TEXT("Populated sector wealths converge"), Spread < InitialSpread * 0.01);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareMoneyMigrationModelsTest, "HeliumRain.Economy.MoneyMigration.Models",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareMoneyMigrationModelsTest::RunTest(const FString& Parameters)
+{
+	TArray<int64> InitialMoney;
+	TArray<int64> Population;
+	InitialMoney.Add(100);       Population.Add(300);
+	InitialMoney.Add(90000000);  Population.Add(10000);
+	InitialMoney.Add(0);         Population.Add(0);
+	InitialMoney.Add(4000000);   Population.Add(0);
+	InitialMoney.Add(250000);    Population.Add(800);
+	InitialMoney.Add(700000);    Population.Add(50);
+	InitialMoney.Add(12345678);  Population.Add(6000);
+
+	int64 TotalMoney = 0;
+	int64 TotalPopulation = 0;
+	int32 PopulatedSectorCount = 0;
+	for (int SectorIndex = 0; SectorIndex < InitialMoney.Num(); SectorIndex++)
+	{
+		TotalMoney += InitialMoney[SectorIndex];
+		TotalPopulation += Population[SectorIndex];
+		PopulatedSectorCount += (Population[SectorIndex] > 0 ? 1 : 0);
+	}
+
+	TArray<int64> PairwiseMoney = InitialMoney;
+	TArray<int64> PooledMoney = InitialMoney;
+	for (int Day = 0; Day < 1000; Day++)
+	{
+		MigratePairwiseDay(PairwiseMoney, Population);
+		MigrateDay(PooledMoney, Population, this);
+	}
+
+	// Both models share the money by population and drain the empty sectors
+	for (int SectorIndex = 0; SectorIndex < InitialMoney.Num(); SectorIndex++)
+	{
+		if (Population[SectorIndex] == 0)
+		{
+			// Integer leaks stop under 10 per populated sector
+			TestTrue(TEXT("Pairwise model drains empty sectors"), PairwiseMoney[SectorIndex] < 10 * PopulatedSectorCount);
+			TestTrue(TEXT("Pooled model drains empty sectors"), PooledMoney[SectorIndex] < 10 * PopulatedSectorCount);
+			continue;
+		}
+
+		double EquilibriumMoney = (double) TotalMoney * Population[SectorIndex] / TotalPopulation;
+		double Tolerance = 0.005 * EquilibriumMoney;
+		if (FMath::Abs(PairwiseMoney[SectorIndex] - EquilibriumMoney) > Tolerance || FMath::Abs(PooledMoney[SectorIndex] - EquilibriumMoney) > Tolerance)
+		{
+			AddError(FString::Printf(TEXT("Sector %d equilibrium differs : pairwise %lld, pooled %lld, expected %f"),
+				SectorIndex, PairwiseMoney[SectorIndex], PooledMoney[SectorIndex], EquilibriumMoney));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareMoneyMigrationOverflowTest, "HeliumRain.Economy.MoneyMigration.Overflow",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareMoneyMigrationOverflowTest::RunTest(const FString& Parameters)
+{
+	// A pool larger than 32 bits must be slowed down, never wrapped
+	TArray<int64> Money;
+	TArray<int64> Population;
+	int64 TotalMoney = 0;
+
+	for (int SectorIndex = 0; SectorIndex < 20; SectorIndex++)
+	{
+		Money.Add(MAX_uint32);
+		Population.Add(0);
+		TotalMoney += MAX_uint32;
+	}
+	Money.Add(0);
+	Population.Add(1);
+
+	int64 Moved = MigrateDay(Money, Population, this);
+
+	int64 FinalMoney = 0;
+	for (int SectorIndex = 0; SectorIndex < Money.Num(); SectorIndex++)
+	{
+		FinalMoney += Money[SectorIndex];
+	}
+
+	TestTrue(TEXT("Pool is limited to 32 bits"), Moved > 0 && Moved <= MAX_uint32);
+	TestTrue(TEXT("Migration conserves money"), FinalMoney == TotalMoney);
+
+	return true;
+}
+
+#endif
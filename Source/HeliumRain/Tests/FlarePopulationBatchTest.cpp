@@ -0,0 +1,114 @@
+
+#include "../Flare.h"
+#include "../Economy/FlarePeople.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Population batch
+----------------------------------------------------*/
+
+static FFlarePeopleSave MakePeople(uint32 Population, float Happiness, uint32 FoodStock, int32 OtherStock, uint32 HungerPoint)
+{
+	FFlarePeopleSave People;
+	People.Population = Population;
+	People.FoodStock = FoodStock;
+	People.Money = 50000;
+	People.Dept = 0;
+	People.BirthPoint = 7000;
+	People.DeathPoint = 29000;
+	People.HungerPoint = HungerPoint;
+	People.HappinessPoint = Population * 100 * Happiness;
+	People.FuelStock = OtherStock;
+	People.ToolStock = OtherStock;
+	People.TechStock = OtherStock;
+	People.FoodConsumption = 1;
+	People.FuelConsumption = 0.6;
+	People.ToolConsumption = 0.5;
+	People.TechConsumption = 0.4;
+	return People;
+}
+
+static bool IsSamePeople(const FFlarePeopleSave& A, const FFlarePeopleSave& B)
+{
+	return A.Population == B.Population && A.FoodStock == B.FoodStock && A.Money == B.Money && A.Dept == B.Dept
+		&& A.BirthPoint == B.BirthPoint && A.DeathPoint == B.DeathPoint && A.HungerPoint == B.HungerPoint
+		&& A.HappinessPoint == B.HappinessPoint && A.FuelStock == B.FuelStock && A.ToolStock == B.ToolStock
+		&& A.TechStock == B.TechStock;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlarePopulationBatchTest, "HeliumRain.Economy.PopulationBatch.SameAsSingle",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlarePopulationBatchTest::RunTest(const FString& Parameters)
+{
+	// Fed, starving, sad, happy and dying sectors
+	TArray<FFlarePeopleSave> Single;
+	Single.Add(MakePeople(1000, 1.0, 100000, 10000, 0));
+	Single.Add(MakePeople(5000, 0.2, 0, 0, 20000));
+	Single.Add(MakePeople(200, 1.9, 50, 20, 0));
+	Single.Add(MakePeople(30000, 1.5, 40000, 5000, 100));
+	Single.Add(MakePeople(1, 0.0, 0, 0, 100000));
+
+	TArray<FFlarePeopleSave> Batched = Single;
+	TArray<FFlarePeopleSave*> BatchedData;
+	for (int32 Index = 0; Index < Batched.Num(); Index++)
+	{
+		BatchedData.Add(&Batched[Index]);
+	}
+
+	for (int32 Day = 0; Day < 200; Day++)
+	{
+		TArray<FFlarePopulationDay> SingleDays;
+		SingleDays.SetNum(Single.Num());
+		for (int32 Index = 0; Index < Single.Num(); Index++)
+		{
+			if (Single[Index].Population > 0)
+			{
+				UFlarePeople::SimulatePopulation(Single[Index], SingleDays[Index]);
+			}
+		}
+
+		// The world only batches populated sectors
+		TArray<FFlarePeopleSave*> PopulatedData;
+		TArray<int32> PopulatedIndexes;
+		for (int32 Index = 0; Index < BatchedData.Num(); Index++)
+		{
+			if (BatchedData[Index]->Population > 0)
+			{
+				PopulatedData.Add(BatchedData[Index]);
+				PopulatedIndexes.Add(Index);
+			}
+		}
+
+		TArray<FFlarePopulationDay> BatchedDays;
+		UFlarePeople::SimulatePopulations(PopulatedData, BatchedDays);
+
+		for (int32 PopulatedIndex = 0; PopulatedIndex < PopulatedIndexes.Num(); PopulatedIndex++)
+		{
+			const FFlarePopulationDay& SingleDay = SingleDays[PopulatedIndexes[PopulatedIndex]];
+			const FFlarePopulationDay& BatchedDay = BatchedDays[PopulatedIndex];
+			if (SingleDay.BirthCount != BatchedDay.BirthCount || SingleDay.KillCount != BatchedDay.KillCount)
+			{
+				AddError(FString::Printf(TEXT("Births or deaths differ on day %d for sector %d"), Day, PopulatedIndexes[PopulatedIndex]));
+				return false;
+			}
+		}
+
+		for (int32 Index = 0; Index < Single.Num(); Index++)
+		{
+			if (!IsSamePeople(Single[Index], Batched[Index]))
+			{
+				AddError(FString::Printf(TEXT("People data differ on day %d for sector %d"), Day, Index));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
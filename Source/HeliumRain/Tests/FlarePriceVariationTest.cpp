@@ -0,0 +1,162 @@
+
+#include "../Flare.h"
+#include "../Game/FlareWorld.h"
+#include "../Game/FlareSimulatedSector.h"
+#include "FlareTestWorld.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Batched price variation
+----------------------------------------------------*/
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlarePriceVariationBatchTest, "HeliumRain.Economy.PriceVariation.SameAsSector",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlarePriceVariationBatchTest::RunTest(const FString& Parameters)
+{
+	const int64 Bounds[][2] = { { 100, 1000 }, { 1500, 4000 }, { 5000, 20000 }, { 1000000, 17000000 } };
+	const float Wanted[] = { -1.f, -0.35f, 0.f, 0.2f, 1.f };
+	const float Ratios[] = { -0.1f, 0.f, 0.3f, 0.5f, 0.99f, 1.f, 1.2f };
+
+	TArray<float> OldPrices;
+	TArray<float> WantedVariations;
+	TArray<float> MinPrices;
+	TArray<float> MaxPrices;
+	TArray<float> PriceRanges;
+	TArray<int64> MinPriceValues;
+	TArray<int64> MaxPriceValues;
+
+	// Prices inside and outside the bounds, for all variation directions
+	for (int32 BoundIndex = 0; BoundIndex < ARRAY_COUNT(Bounds); BoundIndex++)
+	for (int32 WantedIndex = 0; WantedIndex < ARRAY_COUNT(Wanted); WantedIndex++)
+	for (int32 RatioIndex = 0; RatioIndex < ARRAY_COUNT(Ratios); RatioIndex++)
+	{
+		int64 MinPrice = Bounds[BoundIndex][0];
+		int64 MaxPrice = Bounds[BoundIndex][1];
+
+		OldPrices.Add(MinPrice + Ratios[RatioIndex] * (MaxPrice - MinPrice));
+		WantedVariations.Add(Wanted[WantedIndex]);
+		MinPrices.Add((float) MinPrice);
+		MaxPrices.Add((float) MaxPrice);
+		PriceRanges.Add((float) (MaxPrice - MinPrice));
+		MinPriceValues.Add(MinPrice);
+		MaxPriceValues.Add(MaxPrice);
+	}
+
+	TArray<float> VariedPrices;
+	TArray<float> Variations;
+	TArray<float> NewPrices;
+	UFlareWorld::ComputeVariedPrices(OldPrices, WantedVariations, MinPrices, MaxPrices, PriceRanges, VariedPrices, Variations, NewPrices);
+
+	for (int32 PriceIndex = 0; PriceIndex < OldPrices.Num(); PriceIndex++)
+	{
+		// Same as UFlareSimulatedSector::SimulatePriceVariation
+		float NewPrice = OldPrices[PriceIndex];
+		float Variation = 0;
+		float VariedPrice = 0;
+		if (WantedVariations[PriceIndex] != 0.f)
+		{
+			VariedPrice = UFlareSimulatedSector::ComputeVariedPrice(OldPrices[PriceIndex], WantedVariations[PriceIndex],
+				MinPriceValues[PriceIndex], MaxPriceValues[PriceIndex], Variation);
+			NewPrice = FMath::Clamp(VariedPrice, (float) MinPriceValues[PriceIndex], (float) MaxPriceValues[PriceIndex]);
+
+			if (VariedPrices[PriceIndex] != VariedPrice || Variations[PriceIndex] != Variation)
+			{
+				AddError(FString::Printf(TEXT("Varied price %d differs : %f instead of %f"), PriceIndex, VariedPrices[PriceIndex], VariedPrice));
+				return false;
+			}
+		}
+
+		if (NewPrices[PriceIndex] != NewPrice)
+		{
+			AddError(FString::Printf(TEXT("New price %d differs : %f instead of %f"), PriceIndex, NewPrices[PriceIndex], NewPrice));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Current prices of all sectors, by sector then resource */
+static void GetWorldPrices(UFlareWorld* World, TArray<float>& OutPrices)
+{
+	UFlareResourceCatalog* ResourceCatalog = World->GetGame()->GetResourceCatalog();
+	OutPrices.Empty();
+
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->Resources.Num(); ResourceIndex++)
+		{
+			OutPrices.Add(World->GetSectors()[SectorIndex]->GetPreciseResourcePrice(&ResourceCatalog->Resources[ResourceIndex]->Data));
+		}
+	}
+}
+
+static void SetWorldPrices(UFlareWorld* World, const TArray<float>& Prices)
+{
+	int32 ResourceCount = World->GetGame()->GetResourceCatalog()->Resources.Num();
+
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		World->GetSectors()[SectorIndex]->SetPreciseResourcePrices(&Prices[SectorIndex * ResourceCount]);
+	}
+}
+
+/** Time a day of price variation of the world, from the same prices each time */
+static double TimePriceVariation(UFlareWorld* World, bool Batched, int32 Iterations, const TArray<float>& InitialPrices, TArray<float>& OutNewPrices)
+{
+	World->SetBatchedPriceVariation(Batched);
+	double Time = 0;
+
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		SetWorldPrices(World, InitialPrices);
+
+		double StartTime = FPlatformTime::Seconds();
+		World->SimulatePriceVariation();
+		Time += FPlatformTime::Seconds() - StartTime;
+	}
+
+	GetWorldPrices(World, OutNewPrices);
+	return Time / Iterations;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlarePriceVariationBenchmarkTest, "HeliumRain.Economy.PriceVariation.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlarePriceVariationBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// The sector stations decide the wanted variations : run it with a save loaded
+	UFlareWorld* World = GetLoadedTestWorld();
+	if (!World)
+	{
+		AddWarning(TEXT("No game loaded, the price variation was not timed"));
+		return true;
+	}
+
+	const int32 Iterations = 100;
+	bool WasBatched = World->IsBatchedPriceVariation();
+	TArray<float> InitialPrices;
+	GetWorldPrices(World, InitialPrices);
+
+	// The sector by sector variation, with its write back and logs, then the world table
+	TArray<float> LegacyPrices;
+	TArray<float> BatchedPrices;
+	double LegacyTime = TimePriceVariation(World, false, Iterations, InitialPrices, LegacyPrices);
+	double BatchedTime = TimePriceVariation(World, true, Iterations, InitialPrices, BatchedPrices);
+
+	SetWorldPrices(World, InitialPrices);
+	World->SetBatchedPriceVariation(WasBatched);
+
+	AddLogItem(FString::Printf(TEXT("%d sectors : legacy %f ms, batched %f ms per day"),
+		World->GetSectors().Num(), LegacyTime * 1000, BatchedTime * 1000));
+	TestTrue(TEXT("Both paths give the same prices"), LegacyPrices == BatchedPrices);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../Game/FlareGame.h"
+#include "../Game/FlareWorld.h"
+
+
+/** World of the game being played, for the tests that need stations and companies, or NULL */
+inline UFlareWorld* GetLoadedTestWorld()
+{
+	if (!GEngine)
+	{
+		return NULL;
+	}
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		AFlareGame* Game = (Context.World() ? Cast<AFlareGame>(Context.World()->GetAuthGameMode()) : NULL);
+		if (Game && Game->GetGameWorld())
+		{
+			return Game->GetGameWorld();
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,115 @@
+
+#include "../Flare.h"
+#include "../Economy/FlareCargoBay.h"
+#include "../Game/FlareSimulatedSector.h"
+#include "../Spacecrafts/FlareSimulatedSpacecraft.h"
+#include "FlareTestWorld.h"
+
+#include "AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+/*----------------------------------------------------
+	Trade candidates
+----------------------------------------------------*/
+
+/** Check the updated trade candidates of a resource against a scan of all the stations */
+static bool CheckTradeCandidates(UFlareSimulatedSector* Sector, FFlareResourceDescription* Resource, FAutomationTestBase* Test)
+{
+	TArray<FFlareTradeCandidate> Updated = Sector->GetTradeCandidates(Resource);
+	Sector->InvalidateTradeCandidates(Resource);
+	const TArray<FFlareTradeCandidate>& Scanned = Sector->GetTradeCandidates(Resource);
+
+	bool Same = (Updated.Num() == Scanned.Num());
+	for (int32 CandidateIndex = 0; Same && CandidateIndex < Updated.Num(); CandidateIndex++)
+	{
+		const FFlareTradeCandidate& A = Updated[CandidateIndex];
+		const FFlareTradeCandidate& B = Scanned[CandidateIndex];
+		Same = (A.Station == B.Station && A.StationIndex == B.StationIndex && A.FreeSpace == B.FreeSpace
+			&& A.Quantity == B.Quantity && A.WantBuy == B.WantBuy && A.WantSell == B.WantSell);
+	}
+
+	if (!Same)
+	{
+		Test->AddError(FString::Printf(TEXT("Trade candidates of %s in %s differ from a full scan"), *Resource->Name.ToString(), *Sector->GetSectorName().ToString()));
+	}
+	return Same;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlareTradeCandidateUpdateTest, "HeliumRain.Economy.TradeCandidates.Updates",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFlareTradeCandidateUpdateTest::RunTest(const FString& Parameters)
+{
+	// The candidates come from the station cargo bays : run it with a save loaded
+	UFlareWorld* World = GetLoadedTestWorld();
+	if (!World)
+	{
+		AddWarning(TEXT("No game loaded, the trade candidates were not tested"));
+		return true;
+	}
+
+	// The sector with the most stations
+	UFlareSimulatedSector* Sector = NULL;
+	for (int32 SectorIndex = 0; SectorIndex < World->GetSectors().Num(); SectorIndex++)
+	{
+		UFlareSimulatedSector* Candidate = World->GetSectors()[SectorIndex];
+		if (!Sector || Candidate->GetSectorStations().Num() > Sector->GetSectorStations().Num())
+		{
+			Sector = Candidate;
+		}
+	}
+
+	if (!Sector || Sector->GetSectorStations().Num() < 2)
+	{
+		AddWarning(TEXT("No sector with several stations, the trade candidates were not tested"));
+		return true;
+	}
+
+	// A station with some stock, as a trade would find it
+	UFlareResourceCatalog* ResourceCatalog = World->GetGame()->GetResourceCatalog();
+	UFlareSimulatedSpacecraft* Station = NULL;
+	FFlareResourceDescription* Resource = NULL;
+	for (int32 ResourceIndex = 0; ResourceIndex < ResourceCatalog->Resources.Num(); ResourceIndex++)
+	{
+		FFlareResourceDescription* CandidateResource = &ResourceCatalog->Resources[ResourceIndex]->Data;
+		const TArray<FFlareTradeCandidate>& Candidates = Sector->GetTradeCandidates(CandidateResource);
+
+		for (int32 CandidateIndex = 0; !Station && CandidateIndex < Candidates.Num(); CandidateIndex++)
+		{
+			if (Candidates[CandidateIndex].Quantity > 0)
+			{
+				Station = Candidates[CandidateIndex].Station;
+				Resource = CandidateResource;
+			}
+		}
+	}
+
+	if (!Station)
+	{
+		AddWarning(TEXT("No station with stock, the trade candidates were not tested"));
+		return true;
+	}
+
+	// Taking stock from a station scans only this station again, for any resource
+	int32 StationCount = Sector->GetSectorStations().Num();
+	int32 Scans = Sector->GetTradeCandidateScans();
+	Station->GetCargoBay()->TakeResources(Resource, 1);
+	Sector->GetTradeCandidates(Resource);
+	Sector->GetTradeCandidates(&ResourceCatalog->Resources[(Resource->Index + 1) % ResourceCatalog->Resources.Num()]->Data);
+	int32 TakeScans = Sector->GetTradeCandidateScans() - Scans;
+
+	TestTrue(TEXT("A trade scans the traded station only"), TakeScans <= 2);
+	AddLogItem(FString::Printf(TEXT("%d stations : %d scans after a trade, %d for a full scan of two resources"), StationCount, TakeScans, 2 * StationCount));
+
+	bool Same = CheckTradeCandidates(Sector, Resource, this);
+
+	// Giving the stock back restores the candidate at its place
+	Station->GetCargoBay()->GiveResources(Resource, 1);
+	Same = CheckTradeCandidates(Sector, Resource, this) && Same;
+
+	return Same;
+}
+
+#endif
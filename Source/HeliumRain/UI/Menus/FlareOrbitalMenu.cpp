@@ -23,6 +23,7 @@ void SFlareOrbitalMenu::Construct(const FArguments& InArgs)
 	const FFlareStyleCatalog& Theme = FFlareStyleSet::GetDefaultTheme();
 	Game = MenuManager->GetPC()->GetGame();
 	FastForwardPeriod = 0.5f;
+	FastForwardDays = FAST_FORWARD_MAX_SPAN;
 	FastForwardStopRequested = false;
 
 	// Build structure
@@ -264,7 +265,11 @@ void SFlareOrbitalMenu::Tick(const FGeometry& AllottedGeometry, const double InC
 
 			if (TimeSinceFastForward > FastForwardPeriod)
 			{
-				MenuManager->GetGame()->GetGameWorld()->FastForward();
+				// One span per period, stop on travel arrivals, battles and quests
+				if (MenuManager->GetGame()->GetGameWorld()->FastForward(FastForwardDays))
+				{
+					RequestStopFastForward();
+				}
 				TimeSinceFastForward = 0;
 			}
 
@@ -115,6 +115,7 @@ protected:
 	bool                                        FastForwardActive;
 	bool                                        FastForwardStopRequested;
 	float                                       FastForwardPeriod;
+	int32                                       FastForwardDays;
 	float                                       TimeSinceFastForward;
 
 	// Components
@@ -1011,6 +1011,9 @@ void SFlareShipMenu::OnPartConfirmed()
 				}
 			}
 
+			UObject* Seller = (Sector ? Sector->GetPeople() : NULL);
+			PC->GetGame()->GetGameWorld()->GetMoneyLedger().RecordTransfer(TargetSpacecraft->GetCompany(), Seller, TransactionCost, EFlareMoneyReason::Upgrade);
+
 			TargetSpacecraft->Load(*TargetSpacecraftData);
 		}
 